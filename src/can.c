@@ -4,9 +4,11 @@
 // Includes -------------------------------------------------------------------------------------------------------------------
 
 // Includes
-#include "can/can_thread.h"
+#include "can/block_transfer.h"
+#include "can/can_rx.h"
 #include "can/receive.h"
-#include "can/transmit.h"
+#include "can/telemetry.h"
+#include "peripherals.h"
 
 // ChibiOS
 #include "hal.h"
@@ -32,31 +34,65 @@ canNode_t* can2Nodes [] =
 	(canNode_t*) &amkRl, (canNode_t*) &amkRr, (canNode_t*) &amkFl, (canNode_t*) &amkFr
 };
 
-// Configurations -------------------------------------------------------------------------------------------------------------
+// Signal Mapping -------------------------------------------------------------------------------------------------------------
+
+// Indices of the messages within each node's receive handler.
+#define AMK_MESSAGE_ACTUAL_VALUES_1	0
+#define AMK_MESSAGE_ACTUAL_VALUES_2	1
+#define BMS_MESSAGE_STATUS			0
 
-static const canThreadConfig_t CAN1_CONFIG =
+typedef struct
 {
-	.name			= "can1_rx",
-	.driver			= &CAND1,
-	.period			= TIME_MS2I (10),
-	.nodes			= can1Nodes,
-	.nodeCount		= CAN1_NODE_COUNT,
-	.rxHandler		= receiveMessage,
-	.bridgeDriver	= NULL
+	canNode_t* node;
+	uint8_t message;
+} canSignalSource_t;
+
+/// @brief The node and message each signal is received in.
+static const canSignalSource_t SIGNAL_SOURCES [CAN_SIGNAL_COUNT] =
+{
+	[CAN_SIGNAL_AMK_RL_ACTUAL_SPEED]	= { (canNode_t*) &amkRl, AMK_MESSAGE_ACTUAL_VALUES_1 },
+	[CAN_SIGNAL_AMK_RR_ACTUAL_SPEED]	= { (canNode_t*) &amkRr, AMK_MESSAGE_ACTUAL_VALUES_1 },
+	[CAN_SIGNAL_AMK_FL_ACTUAL_SPEED]	= { (canNode_t*) &amkFl, AMK_MESSAGE_ACTUAL_VALUES_1 },
+	[CAN_SIGNAL_AMK_FR_ACTUAL_SPEED]	= { (canNode_t*) &amkFr, AMK_MESSAGE_ACTUAL_VALUES_1 },
+	[CAN_SIGNAL_AMK_RL_POWER]			= { (canNode_t*) &amkRl, AMK_MESSAGE_ACTUAL_VALUES_1 },
+	[CAN_SIGNAL_AMK_RR_POWER]			= { (canNode_t*) &amkRr, AMK_MESSAGE_ACTUAL_VALUES_1 },
+	[CAN_SIGNAL_AMK_FL_POWER]			= { (canNode_t*) &amkFl, AMK_MESSAGE_ACTUAL_VALUES_1 },
+	[CAN_SIGNAL_AMK_FR_POWER]			= { (canNode_t*) &amkFr, AMK_MESSAGE_ACTUAL_VALUES_1 },
+	[CAN_SIGNAL_AMK_RL_TEMPERATURES]	= { (canNode_t*) &amkRl, AMK_MESSAGE_ACTUAL_VALUES_2 },
+	[CAN_SIGNAL_AMK_RR_TEMPERATURES]	= { (canNode_t*) &amkRr, AMK_MESSAGE_ACTUAL_VALUES_2 },
+	[CAN_SIGNAL_AMK_FL_TEMPERATURES]	= { (canNode_t*) &amkFl, AMK_MESSAGE_ACTUAL_VALUES_2 },
+	[CAN_SIGNAL_AMK_FR_TEMPERATURES]	= { (canNode_t*) &amkFr, AMK_MESSAGE_ACTUAL_VALUES_2 },
+	[CAN_SIGNAL_BMS_PRECHARGE_COMPLETE]	= { (canNode_t*) &bms, BMS_MESSAGE_STATUS }
 };
 
-static const canThreadConfig_t CAN2_CONFIG =
+// Configurations -------------------------------------------------------------------------------------------------------------
+
+static const canRxBusConfig_t CAN_BUSES [] =
 {
-	.name			= "can2_rx",
-	.driver			= &CAND2,
-	.period			= TIME_MS2I (10),
-	.nodes			= can2Nodes,
-	.nodeCount		= CAN2_NODE_COUNT,
-	.rxHandler		= NULL,
-	.bridgeDriver	= &CAND1
+	// CAN 1
+	{
+		.driver			= &CAND1,
+		.nodes			= can1Nodes,
+		.nodeCount		= CAN1_NODE_COUNT,
+		.rxHandler		= receiveMessage,
+		.bridgeDriver	= NULL
+	},
+	// CAN 2
+	{
+		.driver			= &CAND2,
+		.nodes			= can2Nodes,
+		.nodeCount		= CAN2_NODE_COUNT,
+		.rxHandler		= NULL,
+		.bridgeDriver	= &CAND1
+	}
 };
 
-#define CAN_TX_THREAD_PERIOD TIME_MS2I (250)
+static const canRxConfig_t CAN_RX_CONFIG =
+{
+	.buses			= CAN_BUSES,
+	.busCount		= sizeof (CAN_BUSES) / sizeof (CAN_BUSES [0]),
+	.timeoutPeriod	= TIME_MS2I (10)
+};
 
 /**
  * @brief Configuration of the CAN 1 & CAN 2 peripherals.
@@ -66,7 +102,9 @@ static const CANConfig CAN_DRIVER_CONFIG =
 {
 	.mcr = 	CAN_MCR_ABOM |		// Automatic bus-off management.
 			CAN_MCR_AWUM |		// Automatic wakeup mode.
-			CAN_MCR_TXFP,		// Chronologic FIFI priority.
+			CAN_MCR_TXFP |		// Chronologic FIFI priority.
+			CAN_MCR_TTCM,		// Time-triggered mode, used for RX timestamps. Transmitted frames are unaffected, as the
+								// driver never sets the TGT bit.
 	.btr =	CAN_BTR_SJW (0) |	// Max 1 TQ resynchronization jump.
 			CAN_BTR_TS2 (1) |	// 2 TQ for time segment 2
 			CAN_BTR_TS1 (10) |	// 11 TQ for time segment 1
@@ -117,31 +155,6 @@ static const ecumasterGpsConfig_t GPS_CONFIG =
 	.timeoutPeriod	= TIME_MS2I (300),
 };
 
-// Threads --------------------------------------------------------------------------------------------------------------------
-
-static CAN_THREAD_WORKING_AREA (can1RxThreadWa);
-
-static CAN_THREAD_WORKING_AREA (can2RxThreadWa);
-
-static THD_WORKING_AREA (can1TxThreadWa, 512);
-THD_FUNCTION (can1TxThread, arg)
-{
-	(void) arg;
-	chRegSetThreadName ("can1_tx");
-
-	systime_t timeCurrent = chVTGetSystemTimeX ();
-	while (true)
-	{
-		// Sleep until next loop.
-		systime_t timeNext = chTimeAddX (timeCurrent, CAN_TX_THREAD_PERIOD);
-		chThdSleepUntilWindowed (timeCurrent, timeNext);
-		timeCurrent = chVTGetSystemTimeX ();
-
-		transmitTemperaturesMessage (&CAND1, CAN_TX_THREAD_PERIOD);
-		transmitConfigMessage (&CAND1, CAN_TX_THREAD_PERIOD);
-	}
-}
-
 // Functions ------------------------------------------------------------------------------------------------------------------
 
 bool canInterfaceInit (tprio_t priority)
@@ -162,14 +175,38 @@ bool canInterfaceInit (tprio_t priority)
 	bmsInit (&bms, &BMS_CONFIG);
 	ecumasterInit (&gps, &GPS_CONFIG);
 
-	// Create the CAN 1 RX thread
-	canThreadStart (can1RxThreadWa, sizeof (can1RxThreadWa), priority, &CAN1_CONFIG);
+	// Create the block transfer worker (prior to any frames being dispatched)
+	blockTransferStart (priority - 1, peripheralsCheckVirtualRange);
 
-	// Create the CAN 2 RX thread
-	canThreadStart (can2RxThreadWa, sizeof (can2RxThreadWa), priority, &CAN2_CONFIG);
+	// Create the CAN RX dispatcher
+	if (!canRxStart (priority, &CAN_RX_CONFIG))
+		return false;
 
-	// Create the CAN 1 TX thread
-	chThdCreateStatic (&can1TxThreadWa, sizeof (can1TxThreadWa), LOWPRIO, can1TxThread, NULL);
+	// Create the CAN 1 telemetry thread
+	if (!telemetryStart (&CAND1, priority - 1))
+		return false;
 
 	return true;
+}
+
+bool canGetSignalTimestamp (canSignal_t signal, systime_t* timestamp)
+{
+	return canRxGetTimestamp (SIGNAL_SOURCES [signal].node, SIGNAL_SOURCES [signal].message, timestamp);
+}
+
+sysinterval_t canGetSignalAge (canSignal_t signal)
+{
+	return canRxGetAge (SIGNAL_SOURCES [signal].node, SIGNAL_SOURCES [signal].message);
+}
+
+sysinterval_t canGetSignalsAge (const canSignal_t* signals, uint8_t signalCount)
+{
+	sysinterval_t ageMax = 0;
+	for (uint8_t index = 0; index < signalCount; ++index)
+	{
+		sysinterval_t age = canGetSignalAge (signals [index]);
+		if (age > ageMax)
+			ageMax = age;
+	}
+	return ageMax;
 }
\ No newline at end of file
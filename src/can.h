@@ -11,6 +11,9 @@
 //   containing only the VCU and the 4 inverters. The VCU acts as a bridge between these busses, where all CAN messages
 //   received on the inverter bus are re-transmitted on the main bus. The bridging is done for debugging and data-logging
 //   purposes. The separation of the two busses is to avoid CAN errors from the inverters.
+//
+//   The arrival time of every received message is tracked, see @c can/can_rx.h for details. The age of the signals used by
+//   the control loops can be queried via @c canGetSignalAge .
 
 // Includes -------------------------------------------------------------------------------------------------------------------
 
@@ -27,6 +30,27 @@
 /// @brief The number of AMK inverters on the CAN bus.
 #define AMK_COUNT 4
 
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+/// @brief Signals received from the CAN nodes whose age can be queried.
+typedef enum
+{
+	CAN_SIGNAL_AMK_RL_ACTUAL_SPEED		= 0,
+	CAN_SIGNAL_AMK_RR_ACTUAL_SPEED		= 1,
+	CAN_SIGNAL_AMK_FL_ACTUAL_SPEED		= 2,
+	CAN_SIGNAL_AMK_FR_ACTUAL_SPEED		= 3,
+	CAN_SIGNAL_AMK_RL_POWER				= 4,
+	CAN_SIGNAL_AMK_RR_POWER				= 5,
+	CAN_SIGNAL_AMK_FL_POWER				= 6,
+	CAN_SIGNAL_AMK_FR_POWER				= 7,
+	CAN_SIGNAL_AMK_RL_TEMPERATURES		= 8,
+	CAN_SIGNAL_AMK_RR_TEMPERATURES		= 9,
+	CAN_SIGNAL_AMK_FL_TEMPERATURES		= 10,
+	CAN_SIGNAL_AMK_FR_TEMPERATURES		= 11,
+	CAN_SIGNAL_BMS_PRECHARGE_COMPLETE	= 12,
+	CAN_SIGNAL_COUNT					= 13
+} canSignal_t;
+
 // Global Nodes ---------------------------------------------------------------------------------------------------------------
 
 /// @brief The rear-left AMK inverter.
@@ -54,9 +78,33 @@ extern ecumasterGps_t gps;
 
 /**
  * @brief Initializes both of the VCU's CAN interfaces.
- * @param priority The priority to start the CAN threads at.
+ * @param priority The priority to start the CAN RX dispatcher at. The telemetry thread is started 1 below this.
  * @return False if a fatal error occurred, true otherwise.
  */
 bool canInterfaceInit (tprio_t priority);
 
+/**
+ * @brief Gets the time at which the frame containing a signal was received.
+ * @param signal The signal to get the timestamp of.
+ * @param timestamp Written to contain the arrival time of the frame, if it has been received.
+ * @return True if the signal has been received, false otherwise.
+ */
+bool canGetSignalTimestamp (canSignal_t signal, systime_t* timestamp);
+
+/**
+ * @brief Gets the amount of time elapsed since the frame containing a signal was received.
+ * @param signal The signal to get the age of.
+ * @return The age of the signal, @c TIME_INFINITE if it has never been received.
+ */
+sysinterval_t canGetSignalAge (canSignal_t signal);
+
+/**
+ * @brief Gets the age of the oldest signal in a set. Useful for values derived from multiple nodes, for instance the
+ * cumulative power of all inverters.
+ * @param signals The signals to check.
+ * @param signalCount The number of elements in @c signals .
+ * @return The age of the oldest signal, @c TIME_INFINITE if any has never been received.
+ */
+sysinterval_t canGetSignalsAge (const canSignal_t* signals, uint8_t signalCount);
+
 #endif // CAN_H
\ No newline at end of file
@@ -0,0 +1,392 @@
+// Header
+#include "block_transfer.h"
+
+// Includes
+#include "crc.h"
+
+// C Standard Library
+#include <string.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The maximum amount of time to wait for a free mailbox when transmitting.
+#define TRANSMIT_TIMEOUT TIME_MS2I (10)
+
+/// @brief The number of received frames that can be queued for the worker. A full window of data frames (at the default window
+/// size) fits, should any more arrive before the worker runs, they are dropped and recovered by go-back-N.
+#define QUEUE_SIZE 32
+
+/// @brief The minimum DLC of each command, that being the length up to and including its last field.
+static const uint8_t COMMAND_DLC_MIN [] =
+{
+	[BLOCK_TRANSFER_OPCODE_BEGIN_WRITE]	= 6,
+	[BLOCK_TRANSFER_OPCODE_BEGIN_READ]	= 6,
+	[BLOCK_TRANSFER_OPCODE_COMMIT]		= 5,
+	[BLOCK_TRANSFER_OPCODE_ABORT]		= 1,
+	[BLOCK_TRANSFER_OPCODE_ACKNOWLEDGE]	= 3
+};
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef struct
+{
+	/// @brief The received frame.
+	CANRxFrame frame;
+	/// @brief The CAN driver to respond on.
+	CANDriver* driver;
+	/// @brief The EEPROM to transfer to / from (commands only).
+	eeprom_t* eeprom;
+} request_t;
+
+typedef enum
+{
+	STATE_IDLE		= 0,
+	STATE_WRITING	= 1,
+	STATE_READING	= 2
+} state_t;
+
+// Global Data ----------------------------------------------------------------------------------------------------------------
+
+/// @brief The state of the current transfer.
+static state_t state = STATE_IDLE;
+
+/// @brief Function checking the block of each begin command.
+static blockTransferRangeCheck_t* blockRangeCheck;
+
+/// @brief The EEPROM of the current transfer.
+static eeprom_t* transferEeprom;
+
+/// @brief The starting address of the current transfer.
+static uint16_t transferAddr;
+
+/// @brief The size of the current transfer, in bytes.
+static uint16_t transferSize;
+
+/// @brief The number of data frames in the current transfer.
+static uint16_t frameCount;
+
+/// @brief The window size of the current transfer, in frames.
+static uint8_t window;
+
+/// @brief Writes: the next sequence number expected from the host. Reads: the next sequence number to send.
+static uint16_t sequence;
+
+/// @brief Reads: the oldest sequence number not yet acknowledged by the host.
+static uint16_t sequenceAcknowledged;
+
+/// @brief Writes: indicates a NACK has been sent for the current gap, such that only one is sent per gap.
+static bool nackPending;
+
+/// @brief The staging buffer of the current transfer.
+static uint8_t staging [BLOCK_TRANSFER_SIZE_MAX];
+
+/// @brief Queue of the received frames awaiting the worker.
+static objects_fifo_t requestQueue;
+
+/// @brief Storage of @c requestQueue .
+static request_t requestBuffer [QUEUE_SIZE];
+static msg_t requestMessages [QUEUE_SIZE];
+
+// Function Prototypes --------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Queues a received frame for the worker. Drops the frame if the queue is full.
+ */
+static void queueRequest (CANRxFrame* frame, CANDriver* driver, eeprom_t* eeprom);
+
+/**
+ * @brief Handles a block transfer command message. Called by the worker.
+ */
+static void handleCommand (CANRxFrame* frame, CANDriver* driver, eeprom_t* eeprom);
+
+/**
+ * @brief Handles a block transfer data message. Called by the worker.
+ */
+static void handleData (CANRxFrame* frame, CANDriver* driver);
+
+/**
+ * @brief Transmits a response message.
+ * @param driver The CAN driver to transmit on.
+ * @param opcode The opcode being responded to.
+ * @param status The status of the operation.
+ * @param crc The CRC to include, if applicable.
+ */
+static void transmitResponse (CANDriver* driver, blockTransferOpcode_t opcode, blockTransferStatus_t status, uint32_t crc);
+
+/**
+ * @brief Transmits all unsent data frames within the current read window.
+ * @param driver The CAN driver to transmit on.
+ */
+static void transmitWindow (CANDriver* driver);
+
+/**
+ * @brief Handles a begin write / begin read command.
+ * @return The status of the operation.
+ */
+static blockTransferStatus_t handleBegin (CANRxFrame* frame, eeprom_t* eeprom, state_t newState);
+
+// Thread Entrypoint ----------------------------------------------------------------------------------------------------------
+
+static THD_WORKING_AREA (blockTransferThreadWa, 768);
+THD_FUNCTION (blockTransferThread, arg)
+{
+	(void) arg;
+	chRegSetThreadName ("block_transfer");
+
+	while (true)
+	{
+		void* object;
+		chFifoReceiveObjectTimeout (&requestQueue, &object, TIME_INFINITE);
+		request_t* request = object;
+
+		if (request->frame.SID == BLOCK_TRANSFER_COMMAND_MESSAGE_ID)
+			handleCommand (&request->frame, request->driver, request->eeprom);
+		else
+			handleData (&request->frame, request->driver);
+
+		chFifoReturnObject (&requestQueue, request);
+	}
+}
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+void blockTransferStart (tprio_t priority, blockTransferRangeCheck_t* rangeCheck)
+{
+	blockRangeCheck = rangeCheck;
+	chFifoObjectInit (&requestQueue, sizeof (request_t), QUEUE_SIZE, requestBuffer, requestMessages);
+	chThdCreateStatic (&blockTransferThreadWa, sizeof (blockTransferThreadWa), priority, blockTransferThread, NULL);
+}
+
+void blockTransferHandleCommand (CANRxFrame* frame, CANDriver* driver, eeprom_t* eeprom)
+{
+	queueRequest (frame, driver, eeprom);
+}
+
+void blockTransferHandleData (CANRxFrame* frame, CANDriver* driver)
+{
+	queueRequest (frame, driver, NULL);
+}
+
+void queueRequest (CANRxFrame* frame, CANDriver* driver, eeprom_t* eeprom)
+{
+	request_t* request = chFifoTakeObjectTimeout (&requestQueue, TIME_IMMEDIATE);
+	if (request == NULL)
+		return;
+
+	request->frame = *frame;
+	request->driver = driver;
+	request->eeprom = eeprom;
+	chFifoSendObject (&requestQueue, request);
+}
+
+void handleCommand (CANRxFrame* frame, CANDriver* driver, eeprom_t* eeprom)
+{
+	// Without an opcode, there is nothing to respond to.
+	if (frame->DLC == 0)
+		return;
+
+	// Reject truncated commands before acting on any of their fields (the remainder of the frame is stale data).
+	blockTransferOpcode_t opcode = frame->data8 [0];
+	if (opcode < sizeof (COMMAND_DLC_MIN) && frame->DLC < COMMAND_DLC_MIN [opcode])
+	{
+		transmitResponse (driver, opcode, BLOCK_TRANSFER_STATUS_INVALID, 0);
+		return;
+	}
+
+	switch (opcode)
+	{
+	case BLOCK_TRANSFER_OPCODE_BEGIN_WRITE:
+		transmitResponse (driver, opcode, handleBegin (frame, eeprom, STATE_WRITING), 0);
+		return;
+
+	case BLOCK_TRANSFER_OPCODE_BEGIN_READ:
+	{
+		blockTransferStatus_t status = handleBegin (frame, eeprom, STATE_READING);
+		if (status == BLOCK_TRANSFER_STATUS_OK && !eepromRead (transferEeprom, transferAddr, staging, transferSize))
+		{
+			state = STATE_IDLE;
+			status = BLOCK_TRANSFER_STATUS_ACCESS_FAILED;
+		}
+
+		if (status != BLOCK_TRANSFER_STATUS_OK)
+		{
+			transmitResponse (driver, opcode, status, 0);
+			return;
+		}
+
+		// Respond with the CRC of the snapshot, then start streaming.
+		transmitResponse (driver, opcode, status, crc32Calculate (staging, transferSize));
+		transmitWindow (driver);
+		return;
+	}
+
+	case BLOCK_TRANSFER_OPCODE_COMMIT:
+	{
+		// All frames must have been received.
+		if (state != STATE_WRITING || sequence != frameCount)
+		{
+			transmitResponse (driver, opcode, BLOCK_TRANSFER_STATUS_INVALID, 0);
+			return;
+		}
+
+		state = STATE_IDLE;
+
+		uint32_t crcExpected = frame->data8 [1] | (frame->data8 [2] << 8) | (frame->data8 [3] << 16) |
+			((uint32_t) frame->data8 [4] << 24);
+		uint32_t crc = crc32Calculate (staging, transferSize);
+		if (crc != crcExpected)
+		{
+			transmitResponse (driver, opcode, BLOCK_TRANSFER_STATUS_CRC_MISMATCH, crc);
+			return;
+		}
+
+		// Commit the whole block in a single write.
+		if (!eepromWrite (transferEeprom, transferAddr, staging, transferSize))
+		{
+			transmitResponse (driver, opcode, BLOCK_TRANSFER_STATUS_ACCESS_FAILED, crc);
+			return;
+		}
+
+		transmitResponse (driver, opcode, BLOCK_TRANSFER_STATUS_OK, crc);
+		return;
+	}
+
+	case BLOCK_TRANSFER_OPCODE_ABORT:
+		state = STATE_IDLE;
+		transmitResponse (driver, opcode, BLOCK_TRANSFER_STATUS_OK, 0);
+		return;
+
+	case BLOCK_TRANSFER_OPCODE_ACKNOWLEDGE:
+	{
+		uint16_t acknowledged = frame->data8 [1] | (frame->data8 [2] << 8);
+		if (state != STATE_READING || acknowledged < sequenceAcknowledged || acknowledged > sequence)
+		{
+			transmitResponse (driver, opcode, BLOCK_TRANSFER_STATUS_INVALID, 0);
+			return;
+		}
+
+		// Advance the window. If the host is missing frames, go back to the first missing one.
+		sequenceAcknowledged = acknowledged;
+		sequence = acknowledged;
+
+		if (sequenceAcknowledged == frameCount)
+		{
+			state = STATE_IDLE;
+			return;
+		}
+
+		transmitWindow (driver);
+		return;
+	}
+
+	default:
+		transmitResponse (driver, opcode, BLOCK_TRANSFER_STATUS_INVALID, 0);
+		return;
+	}
+}
+
+void handleData (CANRxFrame* frame, CANDriver* driver)
+{
+	if (state != STATE_WRITING || frame->DLC != 8)
+		return;
+
+	// Go-back-N: discard anything that isn't the next frame in sequence, telling the host where to resume from.
+	uint16_t frameSequence = frame->data8 [0] | (frame->data8 [1] << 8);
+	if (frameSequence != sequence)
+	{
+		if (!nackPending)
+		{
+			transmitResponse (driver, BLOCK_TRANSFER_OPCODE_NACK, BLOCK_TRANSFER_STATUS_OK, 0);
+			nackPending = true;
+		}
+		return;
+	}
+
+	nackPending = false;
+
+	uint16_t offset = sequence * BLOCK_TRANSFER_FRAME_SIZE;
+	uint16_t count = transferSize - offset;
+	if (count > BLOCK_TRANSFER_FRAME_SIZE)
+		count = BLOCK_TRANSFER_FRAME_SIZE;
+	memcpy (staging + offset, frame->data8 + 2, count);
+	++sequence;
+
+	// Acknowledge every window of frames, and the last frame.
+	if (sequence % window == 0 || sequence == frameCount)
+		transmitResponse (driver, BLOCK_TRANSFER_OPCODE_ACKNOWLEDGE, BLOCK_TRANSFER_STATUS_OK, 0);
+}
+
+blockTransferStatus_t handleBegin (CANRxFrame* frame, eeprom_t* eeprom, state_t newState)
+{
+	// Starting a transfer aborts any in progress.
+	state = STATE_IDLE;
+
+	uint16_t addr = frame->data8 [1] | (frame->data8 [2] << 8);
+	uint16_t size = frame->data8 [3] | (frame->data8 [4] << 8);
+	if (size == 0 || size > BLOCK_TRANSFER_SIZE_MAX || !blockRangeCheck (addr, size))
+		return BLOCK_TRANSFER_STATUS_INVALID;
+
+	transferEeprom			= eeprom;
+	transferAddr			= addr;
+	transferSize			= size;
+	frameCount				= (size + BLOCK_TRANSFER_FRAME_SIZE - 1) / BLOCK_TRANSFER_FRAME_SIZE;
+	window					= frame->data8 [5] != 0 ? frame->data8 [5] : BLOCK_TRANSFER_WINDOW_DEFAULT;
+	sequence				= 0;
+	sequenceAcknowledged	= 0;
+	nackPending				= false;
+	state					= newState;
+
+	return BLOCK_TRANSFER_STATUS_OK;
+}
+
+void transmitResponse (CANDriver* driver, blockTransferOpcode_t opcode, blockTransferStatus_t status, uint32_t crc)
+{
+	CANTxFrame frame =
+	{
+		.DLC	= 8,
+		.IDE	= CAN_IDE_STD,
+		.SID	= BLOCK_TRANSFER_RESPONSE_MESSAGE_ID,
+		.data8	=
+		{
+			opcode,
+			status,
+			sequence & 0xFF,
+			(sequence >> 8) & 0xFF,
+			crc & 0xFF,
+			(crc >> 8) & 0xFF,
+			(crc >> 16) & 0xFF,
+			(crc >> 24) & 0xFF
+		}
+	};
+
+	canTransmitTimeout (driver, CAN_ANY_MAILBOX, &frame, TRANSMIT_TIMEOUT);
+}
+
+void transmitWindow (CANDriver* driver)
+{
+	while (sequence < frameCount && sequence - sequenceAcknowledged < window)
+	{
+		uint16_t offset = sequence * BLOCK_TRANSFER_FRAME_SIZE;
+		uint16_t count = transferSize - offset;
+		if (count > BLOCK_TRANSFER_FRAME_SIZE)
+			count = BLOCK_TRANSFER_FRAME_SIZE;
+
+		CANTxFrame frame =
+		{
+			.DLC	= 8,
+			.IDE	= CAN_IDE_STD,
+			.SID	= BLOCK_TRANSFER_DATA_OUT_MESSAGE_ID,
+			.data8	=
+			{
+				sequence & 0xFF,
+				(sequence >> 8) & 0xFF
+			}
+		};
+		memcpy (frame.data8 + 2, staging + offset, count);
+
+		if (canTransmitTimeout (driver, CAN_ANY_MAILBOX, &frame, TRANSMIT_TIMEOUT) != MSG_OK)
+			return;
+
+		++sequence;
+	}
+}
\ No newline at end of file
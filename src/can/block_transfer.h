@@ -0,0 +1,135 @@
+#ifndef BLOCK_TRANSFER_H
+#define BLOCK_TRANSFER_H
+
+// CAN EEPROM Block Transfer --------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.19
+//
+// Description: Extension of the CAN EEPROM protocol for transferring large blocks of memory. Where the standard protocol
+//   requires a round trip for every few bytes, a block transfer streams sequence-numbered data frames, only acknowledging
+//   every window of frames. Lost frames are recovered using go-back-N: the receiver discards any frame that isn't the next in
+//   sequence and reports the sequence it expects, from which the sender retransmits. Writes are staged in RAM and only
+//   committed to the EEPROM once the whole block has been received and its CRC verified, such that a partial transfer can
+//   never corrupt the configuration. Reads are snapshotted into the same staging buffer, such that the block is consistent.
+//
+//   Committing a block (up to 4 KB of EEPROM writes) and streaming a read window both block for a significant amount of time,
+//   so received frames are only queued by the CAN RX handlers. A dedicated worker thread performs the transfer, such that the
+//   bus's RX dispatcher is never stalled. Should the queue overflow, the dropped frames are recovered by go-back-N.
+//
+//   Messages:
+//   - Command  (0x752, host to VCU, DLC 8):
+//     - Byte 0: Opcode (see @c blockTransferOpcode_t ). A command shorter than its last field is rejected as invalid.
+//     - Begin write / begin read:
+//       - Bytes 1 & 2: Address (little endian).
+//       - Bytes 3 & 4: Size in bytes (little endian), at most @c BLOCK_TRANSFER_SIZE_MAX . The block must lie within the
+//         EEPROM's map.
+//       - Byte 5: Window size in frames, 0 selects @c BLOCK_TRANSFER_WINDOW_DEFAULT .
+//     - Commit:
+//       - Bytes 1 to 4: CRC-32 of the block (little endian), see @c crc.h .
+//     - Acknowledge (read only):
+//       - Bytes 1 & 2: The next sequence number the host expects. The VCU continues (or restarts) from here.
+//   - Data     (0x753, host to VCU, DLC 8) & (0x755, VCU to host, DLC 8):
+//     - Bytes 0 & 1: Sequence number (little endian). Frame N carries bytes [6N, 6N + 6) of the block.
+//     - Bytes 2 to 7: Data. The last frame is padded with zeros.
+//   - Response (0x754, VCU to host, DLC 8):
+//     - Byte 0: The opcode being responded to.
+//     - Byte 1: Status (see @c blockTransferStatus_t ).
+//     - Bytes 2 & 3: The next sequence number the VCU expects (writes), or has sent (reads).
+//     - Bytes 4 to 7: CRC-32 of the block (begin read & commit responses only).
+//
+//   Write sequence:
+//   - Host sends begin write, VCU responds.
+//   - Host streams data frames, keeping at most a window of frames unacknowledged. The VCU responds with an acknowledge after
+//     every window of in-order frames, or with a NACK as soon as a frame is out of sequence. Upon a NACK, the host resumes
+//     from the reported sequence number.
+//   - Once every frame is acknowledged, the host sends commit. The VCU verifies the CRC and writes the block to the EEPROM.
+//
+//   Read sequence:
+//   - Host sends begin read. The VCU snapshots the block and responds with its CRC, then sends the first window of frames.
+//   - Host acknowledges with the next sequence it expects, either after every window of frames (advancing the window) or upon
+//     detecting a gap (rewinding the window).
+//   - Once all frames are received, the host verifies the CRC.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "peripherals/interface/eeprom.h"
+
+// ChibiOS
+#include "hal.h"
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+#define BLOCK_TRANSFER_COMMAND_MESSAGE_ID	0x752
+#define BLOCK_TRANSFER_DATA_IN_MESSAGE_ID	0x753
+#define BLOCK_TRANSFER_RESPONSE_MESSAGE_ID	0x754
+#define BLOCK_TRANSFER_DATA_OUT_MESSAGE_ID	0x755
+
+/// @brief The maximum size of a single block, in bytes. Larger regions must be transferred in multiple blocks.
+#define BLOCK_TRANSFER_SIZE_MAX 0x1000
+
+/// @brief The number of data bytes in each data frame.
+#define BLOCK_TRANSFER_FRAME_SIZE 6
+
+/// @brief The window size used if the host doesn't specify one.
+#define BLOCK_TRANSFER_WINDOW_DEFAULT 16
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Function for checking whether a block lies within the EEPROM being transferred to / from.
+ * @param addr The starting address of the block.
+ * @param size The size of the block, in bytes.
+ * @return True if the block is valid, false otherwise.
+ */
+typedef bool (blockTransferRangeCheck_t) (uint16_t addr, uint16_t size);
+
+typedef enum
+{
+	BLOCK_TRANSFER_OPCODE_BEGIN_WRITE	= 0,
+	BLOCK_TRANSFER_OPCODE_BEGIN_READ	= 1,
+	BLOCK_TRANSFER_OPCODE_COMMIT		= 2,
+	BLOCK_TRANSFER_OPCODE_ABORT			= 3,
+	BLOCK_TRANSFER_OPCODE_ACKNOWLEDGE	= 4,
+	/// @brief Response only, indicates a data frame was received out of sequence.
+	BLOCK_TRANSFER_OPCODE_NACK			= 5
+} blockTransferOpcode_t;
+
+typedef enum
+{
+	BLOCK_TRANSFER_STATUS_OK			= 0,
+	/// @brief The command was malformed, or not valid in the current state.
+	BLOCK_TRANSFER_STATUS_INVALID		= 1,
+	/// @brief The CRC provided by the host did not match that of the staged block.
+	BLOCK_TRANSFER_STATUS_CRC_MISMATCH	= 2,
+	/// @brief The EEPROM rejected the access.
+	BLOCK_TRANSFER_STATUS_ACCESS_FAILED	= 3
+} blockTransferStatus_t;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Starts the block transfer worker thread. Must be called prior to any frames being handled.
+ * @param priority The priority to start the thread at.
+ * @param rangeCheck Function checking the block of each begin command, any block it rejects is rejected before being
+ * accessed.
+ */
+void blockTransferStart (tprio_t priority, blockTransferRangeCheck_t* rangeCheck);
+
+/**
+ * @brief Handles a received block transfer command message, queueing it for the worker thread.
+ * @param frame The received message.
+ * @param driver The CAN driver to respond on.
+ * @param eeprom The EEPROM to transfer to / from.
+ */
+void blockTransferHandleCommand (CANRxFrame* frame, CANDriver* driver, eeprom_t* eeprom);
+
+/**
+ * @brief Handles a received block transfer data message, queueing it for the worker thread.
+ * @param frame The received message.
+ * @param driver The CAN driver to respond on.
+ */
+void blockTransferHandleData (CANRxFrame* frame, CANDriver* driver);
+
+#endif // BLOCK_TRANSFER_H
\ No newline at end of file
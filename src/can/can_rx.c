@@ -0,0 +1,463 @@
+// Header
+#include "can_rx.h"
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The number of received frames that can be awaiting decoding. The bxCAN's RX FIFOs hold 3 frames each, so this
+/// buffers more than both of a bus's FIFOs could have prior to the frames being drained in the interrupt.
+#define FRAME_QUEUE_SIZE 8
+
+/// @brief The number of job descriptors. One per queued frame, one for the job being executed (whose frame may already have
+/// been released), and one for the timeout check.
+#define JOB_QUEUE_SIZE (FRAME_QUEUE_SIZE + 2)
+
+/// @brief The maximum number of frames anchored together. The FIFOs of a bus only hold 6 frames, so this is only exceeded if
+/// frames arrive while the FIFOs are being drained.
+#define BATCH_SIZE 6
+
+/// @brief The weight of each new sample in the average latency (as a power of 2).
+#define LATENCY_AVERAGE_SHIFT 4
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef struct
+{
+	/// @brief The node the timestamps belong to.
+	canNode_t* node;
+	/// @brief The arrival time of the most recent instance of each message.
+	systime_t timestamps [CAN_RX_MESSAGE_COUNT_MAX];
+	/// @brief Bitmask of the messages that have been received at least once.
+	uint8_t received;
+} canRxNodeTimestamps_t;
+
+_Static_assert (CAN_RX_MESSAGE_COUNT_MAX <= 8, "Received bitmask is too small.");
+
+typedef struct
+{
+	/// @brief The received frame.
+	CANRxFrame frame;
+	/// @brief The configuration of the bus the frame was received on.
+	const canRxBusConfig_t* bus;
+	/// @brief The system time the frame arrived at.
+	systime_t arrivalTime;
+} canRxRecord_t;
+
+// Global Data ----------------------------------------------------------------------------------------------------------------
+
+event_source_t canRxEventSource;
+
+canRxLatency_t canRxLatency;
+
+uint32_t canRxDropCount = 0;
+
+uint32_t canRxBridgeDropCount = 0;
+
+/// @brief The timestamps of every registered node.
+static canRxNodeTimestamps_t nodeTimestamps [CAN_RX_NODE_COUNT_MAX];
+
+/// @brief The number of elements of @c nodeTimestamps in use.
+static uint8_t nodeTimestampsCount = 0;
+
+/// @brief The configuration of the dispatcher, @c NULL until started.
+static const canRxConfig_t* rxConfig = NULL;
+
+/// @brief Pool of the records holding frames awaiting decoding.
+static memory_pool_t recordPool;
+static canRxRecord_t records [FRAME_QUEUE_SIZE];
+
+/// @brief Queue of the jobs posted by the RX interrupts & timeout timer, executed by the dispatcher thread.
+static jobs_queue_t jobs;
+static job_descriptor_t jobDescriptors [JOB_QUEUE_SIZE];
+static msg_t jobMessages [JOB_QUEUE_SIZE];
+
+/// @brief Timer responsible for posting the timeout check.
+static virtual_timer_t timeoutTimer;
+
+/// @brief Indicates a timeout check has been posted, but not yet executed.
+static bool timeoutPending = false;
+
+// Function Prototypes --------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Drains the RX FIFOs of a bus, posting a decode job for each frame. Frames are dropped if the queue is full. Must be
+ * called from a locked context.
+ * @param bus The bus to drain.
+ */
+static void receiveFramesI (const canRxBusConfig_t* bus);
+
+/**
+ * @brief Job decoding a received frame. Dispatches the frame to the node it belongs to, or the bus's handler, then notifies
+ * any consumers of the updated node.
+ * @param arg The @c canRxRecord_t of the frame. Released upon completion.
+ */
+static void decodeJob (void* arg);
+
+/**
+ * @brief Job checking every node for timeouts, notifying consumers of any node that changed state.
+ */
+static void timeoutJob (void* arg);
+
+/**
+ * @brief Gets the timestamps of a registered node, and its index within the registry.
+ * @return The timestamps of the node, @c NULL if the node is not registered.
+ */
+static canRxNodeTimestamps_t* getNodeTimestamps (canNode_t* node, uint8_t* index);
+
+/**
+ * @brief Converts the timestamp of a received frame into the system time it arrived at.
+ * @param anchorTime The system time of the anchor.
+ * @param anchorTimestamp The timestamp of the anchor.
+ * @param timestamp The timestamp of the frame.
+ * @param timeCurrent The current system time, being later than both the anchor and the frame.
+ * @return The arrival time of the frame.
+ */
+static systime_t getArrivalTime (systime_t anchorTime, uint16_t anchorTimestamp, uint16_t timestamp, systime_t timeCurrent);
+
+/**
+ * @brief Updates the latency statistics with a newly decoded frame.
+ * @param arrivalTime The time the frame arrived.
+ */
+static void updateLatency (systime_t arrivalTime);
+
+/**
+ * @brief Re-transmits a received frame on another bus. The frame is dropped (and counted) if no mailbox is free, rather than
+ * stalling the dispatcher.
+ */
+static void bridgeFrame (CANDriver* driver, const CANRxFrame* frame);
+
+/**
+ * @brief RX full callback of the CAN drivers. Drains the bus's FIFOs into the job queue.
+ */
+static void rxFullCallback (CANDriver* driver, uint32_t flags);
+
+/**
+ * @brief Callback of the timeout timer. Posts the timeout check, unless one is already pending.
+ */
+static void timeoutCallback (virtual_timer_t* timer, void* arg);
+
+// Thread Entrypoint ----------------------------------------------------------------------------------------------------------
+
+static THD_WORKING_AREA (canRxThreadWa, 768);
+THD_FUNCTION (canRxThread, arg)
+{
+	(void) arg;
+	chRegSetThreadName ("can_rx");
+
+	// Execute the jobs posted by the interrupts, in the order they were posted.
+	while (true)
+		chJobDispatch (&jobs);
+}
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+bool canRxStart (tprio_t priority, const canRxConfig_t* config)
+{
+	// Register the nodes for timestamping.
+	for (uint8_t busIndex = 0; busIndex < config->busCount; ++busIndex)
+	{
+		const canRxBusConfig_t* bus = &config->buses [busIndex];
+		if (nodeTimestampsCount + bus->nodeCount > CAN_RX_NODE_COUNT_MAX)
+			return false;
+
+		for (uint8_t index = 0; index < bus->nodeCount; ++index)
+		{
+			nodeTimestamps [nodeTimestampsCount] = (canRxNodeTimestamps_t)
+			{
+				.node		= bus->nodes [index],
+				.received	= 0
+			};
+			++nodeTimestampsCount;
+		}
+	}
+
+	chEvtObjectInit (&canRxEventSource);
+	chVTObjectInit (&timeoutTimer);
+	chPoolObjectInit (&recordPool, sizeof (canRxRecord_t), NULL);
+	chPoolLoadArray (&recordPool, records, FRAME_QUEUE_SIZE);
+	chJobObjectInit (&jobs, JOB_QUEUE_SIZE, jobDescriptors, jobMessages);
+
+	chThdCreateStatic (&canRxThreadWa, sizeof (canRxThreadWa), priority, canRxThread, NULL);
+
+	// Hook the RX interrupts. Frames may have been received prior to this (and the interrupt will not re-fire until the FIFOs
+	// are drained), so drain each bus once.
+	chSysLock ();
+	rxConfig = config;
+	for (uint8_t index = 0; index < config->busCount; ++index)
+	{
+		config->buses [index].driver->rxfull_cb = rxFullCallback;
+		receiveFramesI (&config->buses [index]);
+	}
+	chVTSetContinuousI (&timeoutTimer, config->timeoutPeriod, timeoutCallback, NULL);
+	chSchRescheduleS ();
+	chSysUnlock ();
+
+	return true;
+}
+
+eventflags_t canRxGetEventFlags (canNode_t* node)
+{
+	uint8_t index;
+	if (getNodeTimestamps (node, &index) == NULL)
+		return 0;
+
+	return (eventflags_t) 1 << index;
+}
+
+bool canRxGetTimestamp (canNode_t* node, uint8_t message, systime_t* timestamp)
+{
+	uint8_t index;
+	canRxNodeTimestamps_t* timestamps = getNodeTimestamps (node, &index);
+	if (timestamps == NULL || message >= CAN_RX_MESSAGE_COUNT_MAX)
+		return false;
+
+	chSysLock ();
+	bool received = (timestamps->received & (1 << message)) != 0;
+	*timestamp = timestamps->timestamps [message];
+	chSysUnlock ();
+
+	return received;
+}
+
+sysinterval_t canRxGetAge (canNode_t* node, uint8_t message)
+{
+	systime_t timestamp;
+	if (!canRxGetTimestamp (node, message, &timestamp))
+		return TIME_INFINITE;
+
+	return chTimeDiffX (timestamp, chVTGetSystemTimeX ());
+}
+
+void receiveFramesI (const canRxBusConfig_t* bus)
+{
+	// The interrupt only fires once the FIFOs have been emptied, so they must be drained completely, even if frames are
+	// dropped.
+	bool empty = false;
+	while (!empty)
+	{
+		canRxRecord_t* batch [BATCH_SIZE];
+		uint8_t batchCount = 0;
+		while (batchCount < BATCH_SIZE)
+		{
+			canRxRecord_t* record = chPoolAllocI (&recordPool);
+			if (record == NULL)
+			{
+				CANRxFrame frame;
+				empty = canTryReceiveI (bus->driver, CAN_ANY_MAILBOX, &frame);
+				if (empty)
+					break;
+
+				++canRxDropCount;
+				continue;
+			}
+
+			empty = canTryReceiveI (bus->driver, CAN_ANY_MAILBOX, &record->frame);
+			if (empty)
+			{
+				chPoolFreeI (&recordPool, record);
+				break;
+			}
+
+			record->bus = bus;
+			batch [batchCount] = record;
+			++batchCount;
+		}
+
+		if (batchCount == 0)
+			continue;
+
+		// Frames are drained as soon as they arrive, so the newest frame of the batch has only just arrived. Pairing its
+		// timestamp with the current system time anchors the batch. The decoding delay is therefore measured, not hidden. Note
+		// the FIFOs are drained in turn, so the newest frame isn't necessarily the last.
+		systime_t timeCurrent = chVTGetSystemTimeX ();
+		uint16_t oldestTimestamp = batch [0]->frame.TIME;
+		uint16_t anchorTimestamp = oldestTimestamp;
+		for (uint8_t index = 1; index < batchCount; ++index)
+			if ((uint16_t) (batch [index]->frame.TIME - oldestTimestamp) > (uint16_t) (anchorTimestamp - oldestTimestamp))
+				anchorTimestamp = batch [index]->frame.TIME;
+
+		for (uint8_t index = 0; index < batchCount; ++index)
+		{
+			canRxRecord_t* record = batch [index];
+			record->arrivalTime = getArrivalTime (timeCurrent, anchorTimestamp, record->frame.TIME, timeCurrent);
+
+			// Every record has a descriptor available, see JOB_QUEUE_SIZE.
+			job_descriptor_t* job = chJobGetI (&jobs);
+			if (job == NULL)
+			{
+				chPoolFreeI (&recordPool, record);
+				++canRxDropCount;
+				continue;
+			}
+
+			job->jobfunc = decodeJob;
+			job->jobarg = record;
+			chJobPostI (&jobs, job);
+		}
+	}
+}
+
+void decodeJob (void* arg)
+{
+	canRxRecord_t* record = arg;
+	const canRxBusConfig_t* bus = record->bus;
+	CANRxFrame* frame = &record->frame;
+	eventflags_t flags = 0;
+
+	// Find the node the frame belongs to, if any.
+	bool handled = false;
+	for (uint8_t index = 0; index < bus->nodeCount; ++index)
+	{
+		int8_t message = canNodeReceive (bus->nodes [index], frame);
+		if (message < 0)
+			continue;
+
+		uint8_t registryIndex;
+		canRxNodeTimestamps_t* timestamps = getNodeTimestamps (bus->nodes [index], &registryIndex);
+		if (timestamps != NULL && message < CAN_RX_MESSAGE_COUNT_MAX)
+		{
+			chSysLock ();
+			timestamps->timestamps [message] = record->arrivalTime;
+			timestamps->received |= 1 << message;
+			chSysUnlock ();
+
+			flags |= (eventflags_t) 1 << registryIndex;
+		}
+
+		updateLatency (record->arrivalTime);
+		handled = true;
+		break;
+	}
+
+	// Otherwise, pass it to the handler.
+	if (!handled && bus->rxHandler != NULL)
+		bus->rxHandler (bus->driver, frame);
+
+	if (bus->bridgeDriver != NULL)
+		bridgeFrame (bus->bridgeDriver, frame);
+
+	chPoolFree (&recordPool, record);
+
+	// Notify any consumers of the updated node.
+	if (flags != 0)
+		chEvtBroadcastFlags (&canRxEventSource, flags);
+}
+
+void timeoutJob (void* arg)
+{
+	(void) arg;
+
+	chSysLock ();
+	timeoutPending = false;
+	chSysUnlock ();
+
+	// A node's state is only written by the dispatcher, so needn't be locked here.
+	systime_t timeCurrent = chVTGetSystemTimeX ();
+	eventflags_t flags = 0;
+	for (uint8_t busIndex = 0; busIndex < rxConfig->busCount; ++busIndex)
+	{
+		const canRxBusConfig_t* bus = &rxConfig->buses [busIndex];
+		for (uint8_t index = 0; index < bus->nodeCount; ++index)
+		{
+			canNode_t* node = bus->nodes [index];
+			canNodeState_t statePrevious = node->state;
+			canNodeCheckTimeout (node, timeCurrent);
+			if (node->state != statePrevious)
+				flags |= canRxGetEventFlags (node);
+		}
+	}
+
+	if (flags != 0)
+		chEvtBroadcastFlags (&canRxEventSource, flags);
+}
+
+canRxNodeTimestamps_t* getNodeTimestamps (canNode_t* node, uint8_t* index)
+{
+	for (*index = 0; *index < nodeTimestampsCount; ++*index)
+		if (nodeTimestamps [*index].node == node)
+			return &nodeTimestamps [*index];
+
+	return NULL;
+}
+
+systime_t getArrivalTime (systime_t anchorTime, uint16_t anchorTimestamp, uint16_t timestamp, systime_t timeCurrent)
+{
+	// The counter only spans 65.536 ms (at 1 Mbps), so the offset of a frame from the anchor is ambiguous. The elapsed counts
+	// since the anchor (unsigned, modulo the counter's period) are taken to place the frame after the anchor, unless that
+	// would place it after the current time, in which case the frame arrived before the anchor. A frame can therefore never
+	// be placed in the future. Frames held for longer than the counter's period have their age underestimated by a multiple
+	// of it.
+	uint16_t elapsed = (uint16_t) (timestamp - anchorTimestamp);
+	sysinterval_t after = (sysinterval_t) ((uint64_t) elapsed * CH_CFG_ST_FREQUENCY / CAN_RX_TIMESTAMP_FREQUENCY);
+	if (after <= chTimeDiffX (anchorTime, timeCurrent))
+		return chTimeAddX (anchorTime, after);
+
+	uint32_t before = (uint32_t) UINT16_MAX + 1 - elapsed;
+	return anchorTime - (systime_t) ((uint64_t) before * CH_CFG_ST_FREQUENCY / CAN_RX_TIMESTAMP_FREQUENCY);
+}
+
+void updateLatency (systime_t arrivalTime)
+{
+	chSysLock ();
+
+	// Arrival times are never in the future, see getArrivalTime.
+	sysinterval_t interval = chTimeDiffX (arrivalTime, chVTGetSystemTimeX ());
+	uint32_t latency = TIME_I2US (interval);
+
+	if (latency > canRxLatency.max)
+		canRxLatency.max = latency;
+
+	int32_t error = (int32_t) latency - (int32_t) canRxLatency.average;
+	canRxLatency.average += error / (1 << LATENCY_AVERAGE_SHIFT);
+
+	chSysUnlock ();
+}
+
+void bridgeFrame (CANDriver* driver, const CANRxFrame* frame)
+{
+	CANTxFrame bridgedFrame =
+	{
+		.DLC	= frame->DLC,
+		.RTR	= frame->RTR,
+		.IDE	= frame->IDE,
+		.data64	= { frame->data64 [0] }
+	};
+
+	if (frame->IDE == CAN_IDE_STD)
+		bridgedFrame.SID = frame->SID;
+	else
+		bridgedFrame.EID = frame->EID;
+
+	if (canTransmitTimeout (driver, CAN_ANY_MAILBOX, &bridgedFrame, TIME_IMMEDIATE) != MSG_OK)
+		++canRxBridgeDropCount;
+}
+
+void rxFullCallback (CANDriver* driver, uint32_t flags)
+{
+	(void) flags;
+
+	chSysLockFromISR ();
+	for (uint8_t index = 0; index < rxConfig->busCount; ++index)
+		if (rxConfig->buses [index].driver == driver)
+			receiveFramesI (&rxConfig->buses [index]);
+	chSysUnlockFromISR ();
+}
+
+void timeoutCallback (virtual_timer_t* timer, void* arg)
+{
+	(void) timer;
+	(void) arg;
+
+	chSysLockFromISR ();
+	if (!timeoutPending)
+	{
+		job_descriptor_t* job = chJobGetI (&jobs);
+		if (job != NULL)
+		{
+			job->jobfunc = timeoutJob;
+			job->jobarg = NULL;
+			chJobPostI (&jobs, job);
+			timeoutPending = true;
+		}
+	}
+	chSysUnlockFromISR ();
+}
\ No newline at end of file
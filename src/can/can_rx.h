@@ -0,0 +1,145 @@
+#ifndef CAN_RX_H
+#define CAN_RX_H
+
+// VCU CAN Receive Dispatcher -------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.19
+//
+// Description: Dispatcher responsible for receiving CAN messages on the VCU's busses. Rather than a thread per bus polling the
+//   FIFOs, the RX interrupt of each bus drains its FIFOs into a queue of jobs, one per frame. A single dispatcher thread
+//   executes the jobs in the order they were posted, decoding each frame as soon as it is scheduled: the frame is dispatched
+//   to the CAN node it belongs to, or to a handler if it doesn't belong to any. Handlers must therefore be quick, as they
+//   delay the frames of both busses (slow work, such as block transfers, is deferred to its own thread). Node timeouts are
+//   checked by a job posted by a periodic timer. Frames can optionally be bridged to another bus, in which case they are
+//   dropped if no mailbox is free (see @c canRxBridgeDropCount ). Once a node's message has been decoded, or a node has
+//   changed state due to timing out, the @c canRxEventSource is broadcast, such that consumers can wait on fresh data rather
+//   than polling for it.
+//
+//   Should the queue be full, frames are dropped (in the interrupt, as the FIFOs must be emptied for it to re-fire), see
+//   @c canRxDropCount .
+//
+//   The time each frame arrived is recorded for every message of every node, allowing consumers to query the age of a value
+//   rather than only whether its node has timed out. Arrival times are derived from the bxCAN's time-triggered communication
+//   mode timestamps (see section 32.7.3 of the STM32F405 Reference Manual). The timestamp is a 16-bit counter of CAN bit
+//   times, so is converted into system time using an anchor: the RX interrupt fires as soon as a frame enters an empty FIFO,
+//   so the newest frame drained by the interrupt is paired with the current system time. All frames are then placed relative
+//   to the anchor, such that any scheduling delay between a frame's arrival and the dispatcher decoding it is measured, not
+//   hidden. The delay between a frame's arrival and it being decoded is tracked, see @c canRxLatency .
+//
+//   Note: This requires @c CAN_ENFORCE_USE_CALLBACKS , as the RX interrupt is hooked via the driver's @c rxfull_cb . In this
+//   mode the driver still wakes the threads blocked in @c canTransmitTimeout as mailboxes are freed, so blocking transmits
+//   are unaffected.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "can/can_node.h"
+
+// ChibiOS
+#include "hal.h"
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The maximum number of CAN nodes, across all busses, whose messages can be timestamped.
+#define CAN_RX_NODE_COUNT_MAX 8
+
+/// @brief The maximum number of messages per node that can be timestamped.
+#define CAN_RX_MESSAGE_COUNT_MAX 8
+
+/// @brief The frequency of the bxCAN's timestamp counter, in Hz. The counter increments once per CAN bit time, so this must
+/// match the baudrate of the busses.
+#define CAN_RX_TIMESTAMP_FREQUENCY 1000000
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Function for handling received frames that don't belong to any CAN node.
+ * @param driver The CAN driver the frame was received on.
+ * @param frame The received frame.
+ * @return 0 if handled, -1 otherwise.
+ */
+typedef int8_t (canRxHandler_t) (CANDriver* driver, CANRxFrame* frame);
+
+typedef struct
+{
+	/// @brief The CAN driver to receive from.
+	CANDriver* driver;
+	/// @brief The CAN nodes belonging to this bus.
+	canNode_t** nodes;
+	/// @brief The number of elements in @c nodes .
+	uint8_t nodeCount;
+	/// @brief Handler for frames not belonging to any node, may be @c NULL .
+	canRxHandler_t* rxHandler;
+	/// @brief The CAN driver to re-transmit all received frames on, may be @c NULL .
+	CANDriver* bridgeDriver;
+} canRxBusConfig_t;
+
+typedef struct
+{
+	/// @brief The configuration of each bus.
+	const canRxBusConfig_t* buses;
+	/// @brief The number of elements in @c buses .
+	uint8_t busCount;
+	/// @brief The period at which to check the nodes for timeouts.
+	sysinterval_t timeoutPeriod;
+} canRxConfig_t;
+
+typedef struct
+{
+	/// @brief The maximum delay between a frame arriving and it being decoded, in microseconds.
+	uint32_t max;
+	/// @brief The average delay between a frame arriving and it being decoded, in microseconds.
+	uint32_t average;
+} canRxLatency_t;
+
+// Global Data ----------------------------------------------------------------------------------------------------------------
+
+/// @brief Event source broadcast every time a node's message is decoded, or a node's state changes due to a timeout. The
+/// flags indicate which nodes were updated, see @c canRxGetEventFlags .
+extern event_source_t canRxEventSource;
+
+/// @brief Statistics of the delay between frames arriving and them being decoded.
+extern canRxLatency_t canRxLatency;
+
+/// @brief The number of received frames dropped due to the dispatcher's queue being full.
+extern uint32_t canRxDropCount;
+
+/// @brief The number of bridged frames dropped due to no mailbox of the destination bus being free.
+extern uint32_t canRxBridgeDropCount;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Starts the CAN RX dispatcher thread and hooks the RX interrupts of each bus.
+ * @param priority The priority to start the thread at.
+ * @param config The configuration of the dispatcher. Must remain in scope for the lifetime of the thread.
+ * @return False if the configuration is invalid, true otherwise.
+ */
+bool canRxStart (tprio_t priority, const canRxConfig_t* config);
+
+/**
+ * @brief Gets the flags of @c canRxEventSource that indicate a node has been updated.
+ * @param node The node to get the flags of.
+ * @return The flags of the node, 0 if the node is not registered.
+ */
+eventflags_t canRxGetEventFlags (canNode_t* node);
+
+/**
+ * @brief Gets the time at which a node's message was last received.
+ * @param node The node the message belongs to.
+ * @param message The index of the message, as returned by the node's receive handler.
+ * @param timestamp Written to contain the arrival time of the message, if it has been received.
+ * @return True if the message has been received, false otherwise.
+ */
+bool canRxGetTimestamp (canNode_t* node, uint8_t message, systime_t* timestamp);
+
+/**
+ * @brief Gets the amount of time elapsed since a node's message was last received.
+ * @param node The node the message belongs to.
+ * @param message The index of the message, as returned by the node's receive handler.
+ * @return The age of the message, @c TIME_INFINITE if it has never been received.
+ */
+sysinterval_t canRxGetAge (canNode_t* node, uint8_t message);
+
+#endif // CAN_RX_H
\ No newline at end of file
@@ -3,7 +3,7 @@
 
 // Includes
 #include "peripherals.h"
-#include "can/can_thread.h"
+#include "can/block_transfer.h"
 #include "can/eeprom_can.h"
 
 // Message IDs ----------------------------------------------------------------------------------------------------------------
@@ -12,13 +12,23 @@
 
 // Receive Functions ----------------------------------------------------------------------------------------------------------
 
-int8_t receiveMessage (void* configPtr, CANRxFrame* frame)
+int8_t receiveMessage (CANDriver* driver, CANRxFrame* frame)
 {
-	canThreadConfig_t* config = configPtr;
-
 	if (frame->SID == EEPROM_COMMAND_MESSAGE_ID)
 	{
-		eepromHandleCanCommand (frame, config->driver, (eeprom_t*) &virtualEeprom);
+		eepromHandleCanCommand (frame, driver, (eeprom_t*) &virtualEeprom);
+		return 0;
+	}
+
+	if (frame->SID == BLOCK_TRANSFER_COMMAND_MESSAGE_ID)
+	{
+		blockTransferHandleCommand (frame, driver, (eeprom_t*) &virtualEeprom);
+		return 0;
+	}
+
+	if (frame->SID == BLOCK_TRANSFER_DATA_IN_MESSAGE_ID)
+	{
+		blockTransferHandleData (frame, driver);
 		return 0;
 	}
 
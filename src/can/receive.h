@@ -18,10 +18,10 @@
 
 /**
  * @brief Handles the received CAN message, if it is intended for the VCU.
- * @param configPtr The config of the calling CAN thread.
+ * @param driver The CAN driver the message was received on.
  * @param frame The received CAN message.
  * @return 0 if handled, -1 otherwise.
  */
-int8_t receiveMessage (void* configPtr, CANRxFrame* frame);
+int8_t receiveMessage (CANDriver* driver, CANRxFrame* frame);
 
 #endif // RECEIVE_H
\ No newline at end of file
@@ -0,0 +1,574 @@
+#ifndef SIGNALS_H
+#define SIGNALS_H
+
+// VCU CAN Signals ------------------------------------------------------------------------------------------------------------
+//
+// Generated by tools/signal_codegen.py from src/can/signals.json, do not edit by hand.
+//
+// Description: Datatypes and packing functions for each message transmitted by the VCU. Packing functions are branch-free,
+//   with all scale factors and bit positions folded into constants. Delta functions check whether a newly packed payload
+//   differs enough from the previously transmitted one to warrant transmitting it, see @c can/telemetry.h .
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// C Standard Library
+#include <stdbool.h>
+#include <stdint.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief Hash of the signal specification these functions were generated from.
+#define SIGNALS_SPEC_HASH 0x59AA1CCBu
+
+// Helpers --------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Reads a little-endian payload into a single 64-bit word.
+ */
+static inline uint64_t signalsReadWord (const uint8_t* data, uint8_t dlc)
+{
+	uint64_t word = 0;
+	for (uint8_t index = 0; index < dlc; ++index)
+		word |= ((uint64_t) data [index]) << (index * 8);
+	return word;
+}
+
+// Status (0x100) -------------------------------------------------------------------------------------------------------------
+
+#define SIGNALS_STATUS_ID	0x100
+#define SIGNALS_STATUS_DLC	4
+
+/// @brief VCU status, vehicle state and sensor validity.
+typedef struct
+{
+	/// @brief The global state of the vehicle.
+	uint8_t vehicleState;
+	/// @brief Indicates the torque thread's request is plausible.
+	bool torquePlausible;
+	/// @brief Indicates the pedals are plausible (including the 100ms timeout).
+	bool pedalsPlausible;
+	/// @brief Indicates the torque request is being derated.
+	bool torqueDerating;
+	/// @brief The state of the on-board EEPROM.
+	uint8_t eepromState;
+	/// @brief Indicates the VCU is faulted.
+	bool vcuFault;
+	/// @brief The state of the APPS-1 sensor.
+	uint8_t apps1State;
+	/// @brief The state of the APPS-2 sensor.
+	uint8_t apps2State;
+	/// @brief The state of the BSE-F sensor.
+	uint8_t bseFState;
+	/// @brief The state of the BSE-R sensor.
+	uint8_t bseRState;
+	/// @brief Indicates the rear-left inverter is valid.
+	bool amkRlValid;
+	/// @brief Indicates the rear-right inverter is valid.
+	bool amkRrValid;
+	/// @brief Indicates the front-left inverter is valid.
+	bool amkFlValid;
+	/// @brief Indicates the front-right inverter is valid.
+	bool amkFrValid;
+	/// @brief Indicates any inverter is in an error or invalid state.
+	bool amkFault;
+	/// @brief The state of the steering-angle sensor.
+	uint8_t sasState;
+	/// @brief The voltage of the GLV battery. (V)
+	float glvVoltage;
+} signalsStatus_t;
+
+/**
+ * @brief Packs the payload of the status message.
+ * @param data The payload to write into, must be at least the DLC of the message in length.
+ * @param message The values to pack.
+ */
+static inline void signalsPackStatus (uint8_t* data, const signalsStatus_t* message)
+{
+	uint32_t vehicleState = (uint32_t) (uint8_t) message->vehicleState;
+	uint32_t torquePlausible = (uint32_t) (uint8_t) message->torquePlausible;
+	uint32_t pedalsPlausible = (uint32_t) (uint8_t) message->pedalsPlausible;
+	uint32_t torqueDerating = (uint32_t) (uint8_t) message->torqueDerating;
+	uint32_t eepromState = (uint32_t) (uint8_t) message->eepromState;
+	uint32_t vcuFault = (uint32_t) (uint8_t) message->vcuFault;
+	uint32_t apps1State = (uint32_t) (uint8_t) message->apps1State;
+	uint32_t apps2State = (uint32_t) (uint8_t) message->apps2State;
+	uint32_t bseFState = (uint32_t) (uint8_t) message->bseFState;
+	uint32_t bseRState = (uint32_t) (uint8_t) message->bseRState;
+	uint32_t amkRlValid = (uint32_t) (uint8_t) message->amkRlValid;
+	uint32_t amkRrValid = (uint32_t) (uint8_t) message->amkRrValid;
+	uint32_t amkFlValid = (uint32_t) (uint8_t) message->amkFlValid;
+	uint32_t amkFrValid = (uint32_t) (uint8_t) message->amkFrValid;
+	uint32_t amkFault = (uint32_t) (uint8_t) message->amkFault;
+	uint32_t sasState = (uint32_t) (uint8_t) message->sasState;
+	uint32_t glvVoltage = (uint32_t) (uint8_t) (message->glvVoltage * (85.0f / 6.0f));
+
+	uint32_t word = vehicleState |
+		(torquePlausible << 2) |
+		(pedalsPlausible << 3) |
+		(torqueDerating << 4) |
+		(eepromState << 5) |
+		(vcuFault << 7) |
+		(apps1State << 8) |
+		(apps2State << 10) |
+		(bseFState << 12) |
+		(bseRState << 14) |
+		(amkRlValid << 16) |
+		(amkRrValid << 17) |
+		(amkFlValid << 18) |
+		(amkFrValid << 19) |
+		(amkFault << 20) |
+		(sasState << 22) |
+		(glvVoltage << 24);
+
+	data [0] = (uint8_t) word;
+	data [1] = (uint8_t) (word >> 8);
+	data [2] = (uint8_t) (word >> 16);
+	data [3] = (uint8_t) (word >> 24);
+}
+
+/**
+ * @brief Checks whether any signal of the status message has changed by more than its threshold.
+ * @param previous The previously transmitted payload.
+ * @param current The newly packed payload.
+ * @return True if the change warrants transmitting the message, false otherwise.
+ */
+static inline bool signalsDeltaStatus (const uint8_t* previous, const uint8_t* current)
+{
+	uint64_t previousWord = signalsReadWord (previous, 4);
+	uint64_t currentWord = signalsReadWord (current, 4);
+	if (previousWord == currentWord)
+		return false;
+
+	// Signals without a threshold.
+	if (((previousWord ^ currentWord) & 0xDFFFFFu) != 0)
+		return true;
+
+	int32_t previousGlvVoltage = (int32_t) ((previousWord >> 24) & 0xFFu);
+	int32_t currentGlvVoltage = (int32_t) ((currentWord >> 24) & 0xFFu);
+	if (previousGlvVoltage - currentGlvVoltage > 1 || currentGlvVoltage - previousGlvVoltage > 1)
+		return true;
+
+	return false;
+}
+
+// SensorInputPercent (0x600) -------------------------------------------------------------------------------------------------
+
+#define SIGNALS_SENSOR_INPUT_PERCENT_ID	0x600
+#define SIGNALS_SENSOR_INPUT_PERCENT_DLC	8
+
+/// @brief Pedal sensor requests and steering angle.
+typedef struct
+{
+	/// @brief The request of the APPS-1 sensor. (%)
+	float apps1;
+	/// @brief The request of the APPS-2 sensor. (%)
+	float apps2;
+	/// @brief The request of the BSE-F sensor. (%)
+	float bseF;
+	/// @brief The request of the BSE-R sensor. (%)
+	float bseR;
+	/// @brief The angle of the steering wheel. (deg)
+	float sasAngle;
+} signalsSensorInputPercent_t;
+
+/**
+ * @brief Packs the payload of the sensorInputPercent message.
+ * @param data The payload to write into, must be at least the DLC of the message in length.
+ * @param message The values to pack.
+ */
+static inline void signalsPackSensorInputPercent (uint8_t* data, const signalsSensorInputPercent_t* message)
+{
+	uint32_t apps1 = (uint32_t) (uint16_t) (message->apps1 * (819.0f / 20.0f)) & 0xFFFu;
+	uint32_t apps2 = (uint32_t) (uint16_t) (message->apps2 * (819.0f / 20.0f)) & 0xFFFu;
+	uint32_t bseF = (uint32_t) (uint16_t) (message->bseF * (819.0f / 20.0f)) & 0xFFFu;
+	uint32_t bseR = (uint32_t) (uint16_t) (message->bseR * (819.0f / 20.0f)) & 0xFFFu;
+	uint32_t sasAngle = (uint32_t) (uint16_t) (int16_t) (message->sasAngle * (4369.0f / 24.0f));
+
+	uint64_t word = (uint64_t) apps1 |
+		((uint64_t) apps2 << 12) |
+		((uint64_t) bseF << 24) |
+		((uint64_t) bseR << 36) |
+		((uint64_t) sasAngle << 48);
+
+	data [0] = (uint8_t) word;
+	data [1] = (uint8_t) (word >> 8);
+	data [2] = (uint8_t) (word >> 16);
+	data [3] = (uint8_t) (word >> 24);
+	data [4] = (uint8_t) (word >> 32);
+	data [5] = (uint8_t) (word >> 40);
+	data [6] = (uint8_t) (word >> 48);
+	data [7] = (uint8_t) (word >> 56);
+}
+
+/**
+ * @brief Checks whether any signal of the sensorInputPercent message has changed by more than its threshold.
+ * @param previous The previously transmitted payload.
+ * @param current The newly packed payload.
+ * @return True if the change warrants transmitting the message, false otherwise.
+ */
+static inline bool signalsDeltaSensorInputPercent (const uint8_t* previous, const uint8_t* current)
+{
+	uint64_t previousWord = signalsReadWord (previous, 8);
+	uint64_t currentWord = signalsReadWord (current, 8);
+	if (previousWord == currentWord)
+		return false;
+
+	int32_t previousApps1 = (int32_t) ((previousWord >> 0) & 0xFFFu);
+	int32_t currentApps1 = (int32_t) ((currentWord >> 0) & 0xFFFu);
+	if (previousApps1 - currentApps1 > 8 || currentApps1 - previousApps1 > 8)
+		return true;
+
+	int32_t previousApps2 = (int32_t) ((previousWord >> 12) & 0xFFFu);
+	int32_t currentApps2 = (int32_t) ((currentWord >> 12) & 0xFFFu);
+	if (previousApps2 - currentApps2 > 8 || currentApps2 - previousApps2 > 8)
+		return true;
+
+	int32_t previousBseF = (int32_t) ((previousWord >> 24) & 0xFFFu);
+	int32_t currentBseF = (int32_t) ((currentWord >> 24) & 0xFFFu);
+	if (previousBseF - currentBseF > 8 || currentBseF - previousBseF > 8)
+		return true;
+
+	int32_t previousBseR = (int32_t) ((previousWord >> 36) & 0xFFFu);
+	int32_t currentBseR = (int32_t) ((currentWord >> 36) & 0xFFFu);
+	if (previousBseR - currentBseR > 8 || currentBseR - previousBseR > 8)
+		return true;
+
+	int32_t previousSasAngle = (int32_t) (((previousWord >> 48) & 0xFFFFu) ^ 0x8000u) - 0x8000;
+	int32_t currentSasAngle = (int32_t) (((currentWord >> 48) & 0xFFFFu) ^ 0x8000u) - 0x8000;
+	if (previousSasAngle - currentSasAngle > 18 || currentSasAngle - previousSasAngle > 18)
+		return true;
+
+	return false;
+}
+
+// Temperatures (0x7A0) -------------------------------------------------------------------------------------------------------
+
+#define SIGNALS_TEMPERATURES_ID	0x7A0
+#define SIGNALS_TEMPERATURES_DLC	4
+
+/// @brief Maximum inverter and motor temperatures.
+typedef struct
+{
+	/// @brief The maximum temperature of the 4 inverters. (C)
+	float inverterTemperatureMax;
+	/// @brief The maximum temperature of the 4 motors. (C)
+	float motorTemperatureMax;
+} signalsTemperatures_t;
+
+/**
+ * @brief Packs the payload of the temperatures message.
+ * @param data The payload to write into, must be at least the DLC of the message in length.
+ * @param message The values to pack.
+ */
+static inline void signalsPackTemperatures (uint8_t* data, const signalsTemperatures_t* message)
+{
+	uint32_t inverterTemperatureMax = (uint32_t) (uint16_t) (message->inverterTemperatureMax * 10.0f);
+	uint32_t motorTemperatureMax = (uint32_t) (uint16_t) (message->motorTemperatureMax * 10.0f);
+
+	uint32_t word = inverterTemperatureMax | (motorTemperatureMax << 16);
+
+	data [0] = (uint8_t) word;
+	data [1] = (uint8_t) (word >> 8);
+	data [2] = (uint8_t) (word >> 16);
+	data [3] = (uint8_t) (word >> 24);
+}
+
+/**
+ * @brief Checks whether any signal of the temperatures message has changed by more than its threshold.
+ * @param previous The previously transmitted payload.
+ * @param current The newly packed payload.
+ * @return True if the change warrants transmitting the message, false otherwise.
+ */
+static inline bool signalsDeltaTemperatures (const uint8_t* previous, const uint8_t* current)
+{
+	uint64_t previousWord = signalsReadWord (previous, 4);
+	uint64_t currentWord = signalsReadWord (current, 4);
+	if (previousWord == currentWord)
+		return false;
+
+	int32_t previousInverterTemperatureMax = (int32_t) ((previousWord >> 0) & 0xFFFFu);
+	int32_t currentInverterTemperatureMax = (int32_t) ((currentWord >> 0) & 0xFFFFu);
+	if (previousInverterTemperatureMax - currentInverterTemperatureMax > 5 || currentInverterTemperatureMax - previousInverterTemperatureMax > 5)
+		return true;
+
+	int32_t previousMotorTemperatureMax = (int32_t) ((previousWord >> 16) & 0xFFFFu);
+	int32_t currentMotorTemperatureMax = (int32_t) ((currentWord >> 16) & 0xFFFFu);
+	if (previousMotorTemperatureMax - currentMotorTemperatureMax > 5 || currentMotorTemperatureMax - previousMotorTemperatureMax > 5)
+		return true;
+
+	return false;
+}
+
+// Config (0x7A2) -------------------------------------------------------------------------------------------------------------
+
+#define SIGNALS_CONFIG_ID	0x7A2
+#define SIGNALS_CONFIG_DLC	8
+
+/// @brief Active vehicle configuration.
+typedef struct
+{
+	/// @brief The cumulative driving torque limit. (Nm)
+	float drivingTorqueLimit;
+	/// @brief The cumulative regenerative torque limit. (Nm)
+	float regenTorqueLimit;
+	/// @brief The index of the selected torque-vectoring algorithm.
+	uint8_t torqueAlgorithmIndex;
+	/// @brief The index of the active configuration profile.
+	uint8_t profileIndex;
+	/// @brief Indicates the most recent profile switch was rejected, as the profile's CRC was invalid.
+	bool profileRejected;
+	/// @brief The hash of the signal specification the firmware was built from (SIGNALS_SPEC_HASH).
+	uint32_t specHash;
+} signalsConfig_t;
+
+/**
+ * @brief Packs the payload of the config message.
+ * @param data The payload to write into, must be at least the DLC of the message in length.
+ * @param message The values to pack.
+ */
+static inline void signalsPackConfig (uint8_t* data, const signalsConfig_t* message)
+{
+	uint32_t drivingTorqueLimit = (uint32_t) (uint8_t) (message->drivingTorqueLimit * (51.0f / 20.0f));
+	uint32_t regenTorqueLimit = (uint32_t) (uint8_t) (message->regenTorqueLimit * (51.0f / 20.0f));
+	uint32_t torqueAlgorithmIndex = (uint32_t) (uint8_t) message->torqueAlgorithmIndex;
+	uint32_t profileIndex = (uint32_t) (uint8_t) message->profileIndex & 0xFu;
+	uint32_t profileRejected = (uint32_t) (uint8_t) message->profileRejected;
+	uint32_t specHash = (uint32_t) (uint32_t) message->specHash;
+
+	uint64_t word = (uint64_t) drivingTorqueLimit |
+		((uint64_t) regenTorqueLimit << 8) |
+		((uint64_t) torqueAlgorithmIndex << 16) |
+		((uint64_t) profileIndex << 24) |
+		((uint64_t) profileRejected << 28) |
+		((uint64_t) specHash << 32);
+
+	data [0] = (uint8_t) word;
+	data [1] = (uint8_t) (word >> 8);
+	data [2] = (uint8_t) (word >> 16);
+	data [3] = (uint8_t) (word >> 24);
+	data [4] = (uint8_t) (word >> 32);
+	data [5] = (uint8_t) (word >> 40);
+	data [6] = (uint8_t) (word >> 48);
+	data [7] = (uint8_t) (word >> 56);
+}
+
+/**
+ * @brief Checks whether any signal of the config message has changed by more than its threshold.
+ * @param previous The previously transmitted payload.
+ * @param current The newly packed payload.
+ * @return True if the change warrants transmitting the message, false otherwise.
+ */
+static inline bool signalsDeltaConfig (const uint8_t* previous, const uint8_t* current)
+{
+	uint64_t previousWord = signalsReadWord (previous, 8);
+	uint64_t currentWord = signalsReadWord (current, 8);
+	if (previousWord == currentWord)
+		return false;
+
+	// Signals without a threshold.
+	if (((previousWord ^ currentWord) & 0xFFFFFFFF1FFFFFFFu) != 0)
+		return true;
+
+	return false;
+}
+
+// Boot (0x7A3) ---------------------------------------------------------------------------------------------------------------
+
+#define SIGNALS_BOOT_ID	0x7A3
+#define SIGNALS_BOOT_DLC	6
+
+/// @brief Boot timing, transmitted once upon startup. Times are measured from the start of the kernel.
+typedef struct
+{
+	/// @brief The time at which the peripherals were initialized, including loading the EEPROM map. (ms)
+	uint16_t peripheralsTime;
+	/// @brief The time at which the CAN interface started, and the first telemetry frame was queued. (ms)
+	uint16_t canTime;
+	/// @brief The time at which all threads were started and the shutdown loop was allowed to close. (ms)
+	uint16_t readyTime;
+} signalsBoot_t;
+
+/**
+ * @brief Packs the payload of the boot message.
+ * @param data The payload to write into, must be at least the DLC of the message in length.
+ * @param message The values to pack.
+ */
+static inline void signalsPackBoot (uint8_t* data, const signalsBoot_t* message)
+{
+	uint32_t peripheralsTime = (uint32_t) (uint16_t) message->peripheralsTime;
+	uint32_t canTime = (uint32_t) (uint16_t) message->canTime;
+	uint32_t readyTime = (uint32_t) (uint16_t) message->readyTime;
+
+	uint64_t word = (uint64_t) peripheralsTime | ((uint64_t) canTime << 16) | ((uint64_t) readyTime << 32);
+
+	data [0] = (uint8_t) word;
+	data [1] = (uint8_t) (word >> 8);
+	data [2] = (uint8_t) (word >> 16);
+	data [3] = (uint8_t) (word >> 24);
+	data [4] = (uint8_t) (word >> 32);
+	data [5] = (uint8_t) (word >> 40);
+}
+
+/**
+ * @brief Checks whether any signal of the boot message has changed by more than its threshold.
+ * @param previous The previously transmitted payload.
+ * @param current The newly packed payload.
+ * @return True if the change warrants transmitting the message, false otherwise.
+ */
+static inline bool signalsDeltaBoot (const uint8_t* previous, const uint8_t* current)
+{
+	uint64_t previousWord = signalsReadWord (previous, 6);
+	uint64_t currentWord = signalsReadWord (current, 6);
+	if (previousWord == currentWord)
+		return false;
+
+	// Signals without a threshold.
+	if (((previousWord ^ currentWord) & 0xFFFFFFFFFFFFu) != 0)
+		return true;
+
+	return false;
+}
+
+// SensorHealth (0x7A4) -------------------------------------------------------------------------------------------------------
+
+#define SIGNALS_SENSOR_HEALTH_ID	0x7A4
+#define SIGNALS_SENSOR_HEALTH_DLC	8
+
+/// @brief Statistics of one sensor's raw samples since the sensor was last reported. Each transmission reports the next sensor in turn. Counts saturate at their maximum.
+typedef struct
+{
+	/// @brief The sensor being reported.
+	uint8_t channel;
+	/// @brief The mean of the in-range samples.
+	uint16_t mean;
+	/// @brief The standard deviation (square root of the variance) of the in-range samples.
+	float standardDeviation;
+	/// @brief The peak-to-peak range of the in-range samples.
+	uint16_t peakToPeak;
+	/// @brief The number of samples outside of the sensor's valid range.
+	uint8_t outOfRangeCount;
+	/// @brief The number of consecutive samples differing by more than the configured rate limit.
+	uint8_t rateViolationCount;
+	/// @brief The number of in-range samples.
+	uint16_t sampleCount;
+} signalsSensorHealth_t;
+
+/**
+ * @brief Packs the payload of the sensorHealth message.
+ * @param data The payload to write into, must be at least the DLC of the message in length.
+ * @param message The values to pack.
+ */
+static inline void signalsPackSensorHealth (uint8_t* data, const signalsSensorHealth_t* message)
+{
+	uint32_t channel = (uint32_t) (uint8_t) message->channel;
+	uint32_t mean = (uint32_t) (uint16_t) message->mean & 0xFFFu;
+	uint32_t standardDeviation = (uint32_t) (uint16_t) (message->standardDeviation * 8.0f) & 0x3FFu;
+	uint32_t peakToPeak = (uint32_t) (uint16_t) message->peakToPeak & 0xFFFu;
+	uint32_t outOfRangeCount = (uint32_t) (uint8_t) message->outOfRangeCount;
+	uint32_t rateViolationCount = (uint32_t) (uint8_t) message->rateViolationCount;
+	uint32_t sampleCount = (uint32_t) (uint16_t) message->sampleCount & 0x7FFu;
+
+	uint64_t word = (uint64_t) channel |
+		((uint64_t) mean << 3) |
+		((uint64_t) standardDeviation << 15) |
+		((uint64_t) peakToPeak << 25) |
+		((uint64_t) outOfRangeCount << 37) |
+		((uint64_t) rateViolationCount << 45) |
+		((uint64_t) sampleCount << 53);
+
+	data [0] = (uint8_t) word;
+	data [1] = (uint8_t) (word >> 8);
+	data [2] = (uint8_t) (word >> 16);
+	data [3] = (uint8_t) (word >> 24);
+	data [4] = (uint8_t) (word >> 32);
+	data [5] = (uint8_t) (word >> 40);
+	data [6] = (uint8_t) (word >> 48);
+	data [7] = (uint8_t) (word >> 56);
+}
+
+/**
+ * @brief Checks whether any signal of the sensorHealth message has changed by more than its threshold.
+ * @param previous The previously transmitted payload.
+ * @param current The newly packed payload.
+ * @return True if the change warrants transmitting the message, false otherwise.
+ */
+static inline bool signalsDeltaSensorHealth (const uint8_t* previous, const uint8_t* current)
+{
+	uint64_t previousWord = signalsReadWord (previous, 8);
+	uint64_t currentWord = signalsReadWord (current, 8);
+	if (previousWord == currentWord)
+		return false;
+
+	// Signals without a threshold.
+	if (((previousWord ^ currentWord) & 0xFFFFFFFFFFFFFFFFu) != 0)
+		return true;
+
+	return false;
+}
+
+// CanStatistics (0x7A5) ------------------------------------------------------------------------------------------------------
+
+#define SIGNALS_CAN_STATISTICS_ID	0x7A5
+#define SIGNALS_CAN_STATISTICS_DLC	8
+
+/// @brief Statistics of the CAN receive dispatcher. Values saturate at their maximum.
+typedef struct
+{
+	/// @brief The maximum delay between a frame arriving and it being decoded. (us)
+	uint16_t rxLatencyMax;
+	/// @brief The average delay between a frame arriving and it being decoded. (us)
+	uint16_t rxLatencyAverage;
+	/// @brief The number of received frames dropped due to the dispatcher's queue being full.
+	uint16_t rxDropCount;
+	/// @brief The number of bridged frames dropped due to no transmit mailbox being free.
+	uint16_t bridgeDropCount;
+} signalsCanStatistics_t;
+
+/**
+ * @brief Packs the payload of the canStatistics message.
+ * @param data The payload to write into, must be at least the DLC of the message in length.
+ * @param message The values to pack.
+ */
+static inline void signalsPackCanStatistics (uint8_t* data, const signalsCanStatistics_t* message)
+{
+	uint32_t rxLatencyMax = (uint32_t) (uint16_t) message->rxLatencyMax;
+	uint32_t rxLatencyAverage = (uint32_t) (uint16_t) message->rxLatencyAverage;
+	uint32_t rxDropCount = (uint32_t) (uint16_t) message->rxDropCount;
+	uint32_t bridgeDropCount = (uint32_t) (uint16_t) message->bridgeDropCount;
+
+	uint64_t word = (uint64_t) rxLatencyMax |
+		((uint64_t) rxLatencyAverage << 16) |
+		((uint64_t) rxDropCount << 32) |
+		((uint64_t) bridgeDropCount << 48);
+
+	data [0] = (uint8_t) word;
+	data [1] = (uint8_t) (word >> 8);
+	data [2] = (uint8_t) (word >> 16);
+	data [3] = (uint8_t) (word >> 24);
+	data [4] = (uint8_t) (word >> 32);
+	data [5] = (uint8_t) (word >> 40);
+	data [6] = (uint8_t) (word >> 48);
+	data [7] = (uint8_t) (word >> 56);
+}
+
+/**
+ * @brief Checks whether any signal of the canStatistics message has changed by more than its threshold.
+ * @param previous The previously transmitted payload.
+ * @param current The newly packed payload.
+ * @return True if the change warrants transmitting the message, false otherwise.
+ */
+static inline bool signalsDeltaCanStatistics (const uint8_t* previous, const uint8_t* current)
+{
+	uint64_t previousWord = signalsReadWord (previous, 8);
+	uint64_t currentWord = signalsReadWord (current, 8);
+	if (previousWord == currentWord)
+		return false;
+
+	// Signals without a threshold.
+	if (((previousWord ^ currentWord) & 0xFFFFFFFFFFFFFFFFu) != 0)
+		return true;
+
+	return false;
+}
+
+#endif // SIGNALS_H
\ No newline at end of file
@@ -0,0 +1,340 @@
+// Header
+#include "telemetry.h"
+
+// Includes
+#include "can/signals.h"
+#include "can/transmit.h"
+
+// C Standard Library
+#include <string.h>
+
+// Telemetry Table ------------------------------------------------------------------------------------------------------------
+
+// Note: Two messages can only share a slot if their phases are congruent modulo the GCD of their periods. The default phases
+//   below are chosen such that no two messages' scheduled slots coincide (the 10 slot messages take phases 0, 3 and 7, so
+//   the 25 slot messages must take phases not congruent to 0, 3 or 2 modulo 5). This is checked upon starting the thread.
+//   Send-on-delta messages are transmitted as soon as they change, so only their keep-alives are spread out.
+
+#define TELEMETRY_MESSAGE_COUNT (sizeof (TELEMETRY_MESSAGES) / sizeof (TELEMETRY_MESSAGES [0]))
+static const telemetryMessage_t TELEMETRY_MESSAGES [] =
+{
+	{
+		// Sensor input percent (on delta, 10 ms to 100 ms)
+		.id			= SIGNALS_SENSOR_INPUT_PERCENT_ID,
+		.period		= 10,
+		.minPeriod	= 1,
+		.phase		= 0,
+		.packer		= transmitPackSensorInputPercent,
+		.delta		= signalsDeltaSensorInputPercent
+	},
+	{
+		// Status (on delta, 10 ms to 100 ms)
+		.id			= SIGNALS_STATUS_ID,
+		.period		= 10,
+		.minPeriod	= 1,
+		.phase		= 3,
+		.packer		= transmitPackStatus,
+		.delta		= signalsDeltaStatus
+	},
+	{
+		// Temperatures (250 ms)
+		.id			= SIGNALS_TEMPERATURES_ID,
+		.period		= 25,
+		.minPeriod	= 0,
+		.phase		= 9,
+		.packer		= transmitPackTemperatures,
+		.delta		= signalsDeltaTemperatures
+	},
+	{
+		// Config (250 ms)
+		.id			= SIGNALS_CONFIG_ID,
+		.period		= 25,
+		.minPeriod	= 0,
+		.phase		= 6,
+		.packer		= transmitPackConfig,
+		.delta		= signalsDeltaConfig
+	},
+	{
+		// Sensor health (100 ms, each sensor every 600 ms). Never sent on delta, as packing consumes the sensor's statistics
+		// and advances to the next sensor.
+		.id			= SIGNALS_SENSOR_HEALTH_ID,
+		.period		= 10,
+		.minPeriod	= 0,
+		.phase		= 7,
+		.packer		= transmitPackSensorHealth,
+		.delta		= NULL
+	},
+	{
+		// CAN statistics (1 s)
+		.id			= SIGNALS_CAN_STATISTICS_ID,
+		.period		= 100,
+		.minPeriod	= 0,
+		.phase		= 1,
+		.packer		= transmitPackCanStatistics,
+		.delta		= NULL
+	}
+};
+
+_Static_assert (TELEMETRY_MESSAGE_COUNT <= TELEMETRY_MESSAGE_COUNT_MAX, "Telemetry table exceeds the configurable size.");
+
+// Global Data ----------------------------------------------------------------------------------------------------------------
+
+/// @brief The CAN driver to transmit telemetry on.
+static CANDriver* telemetryDriver;
+
+/// @brief The active period of each message, in slots.
+static uint16_t periods [TELEMETRY_MESSAGE_COUNT];
+
+/// @brief The active phase of each message, in slots.
+static uint16_t phases [TELEMETRY_MESSAGE_COUNT];
+
+/// @brief The active minimum period of each message, in slots. 0 indicates the message is sent periodically.
+static uint16_t minPeriods [TELEMETRY_MESSAGE_COUNT];
+
+// Function Prototypes --------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Converts a period from milliseconds to slots, rounding to the nearest slot (minimum of 1 slot).
+ */
+static uint16_t periodToSlots (uint16_t periodMs);
+
+/**
+ * @brief Calculates the greatest common divisor of two periods.
+ */
+static uint16_t gcd (uint16_t a, uint16_t b);
+
+/**
+ * @brief Counts the number of placed messages a message would share slots with. Messages sent every slot collide with
+ * everything, so are ignored.
+ * @param index The index of the message. All messages before this index are considered placed.
+ * @param period The period of the message, in slots.
+ * @param phase The phase of the message, in slots.
+ * @param periods The periods of the placed messages.
+ * @param phases The phases of the placed messages.
+ * @return The number of collisions.
+ */
+static uint8_t countCollisions (uint8_t index, uint16_t period, uint16_t phase, const uint16_t* periods,
+	const uint16_t* phases);
+
+/**
+ * @brief Selects the phase of a message that collides with the fewest already-placed messages. Ties are resolved in favor of
+ * the preferred phase, then the phases following it.
+ * @param index The index of the message to place. All messages before this index are considered placed.
+ * @param period The period of the message, in slots.
+ * @param preferred The preferred phase of the message, in slots.
+ * @param periods The periods of the placed messages.
+ * @param phases The phases of the placed messages.
+ * @return The selected phase.
+ */
+static uint16_t selectPhase (uint8_t index, uint16_t period, uint16_t preferred, const uint16_t* periods,
+	const uint16_t* phases);
+
+// Thread Entrypoint ----------------------------------------------------------------------------------------------------------
+
+static THD_WORKING_AREA (telemetryThreadWa, 512);
+THD_FUNCTION (telemetryThread, arg)
+{
+	(void) arg;
+	chRegSetThreadName ("telemetry");
+
+	// The slot each message was last transmitted in, and its payload at the time.
+	uint32_t slotsPrevious [TELEMETRY_MESSAGE_COUNT] = { 0 };
+	uint8_t dataPrevious [TELEMETRY_MESSAGE_COUNT][8] = { { 0 } };
+
+	uint32_t slot = 0;
+	systime_t timeCurrent = chVTGetSystemTimeX ();
+	while (true)
+	{
+		for (uint8_t index = 0; index < TELEMETRY_MESSAGE_COUNT; ++index)
+		{
+			chSysLock ();
+			uint16_t period = periods [index];
+			uint16_t phase = phases [index];
+			uint16_t minPeriod = minPeriods [index];
+			chSysUnlock ();
+
+			CANTxFrame frame;
+			if (minPeriod == 0)
+			{
+				// Periodic, only pack the message when it is scheduled.
+				if (slot % period != phase)
+					continue;
+
+				TELEMETRY_MESSAGES [index].packer (&frame);
+			}
+			else
+			{
+				// Send-on-delta, always transmit the keep-alive in the message's scheduled slot. Otherwise, pack the message
+				// once the minimum period has elapsed, but only transmit it if it changed enough. Note the keep-alive is
+				// scheduled by phase, not by the time since the last transmission, otherwise messages with equal periods
+				// would drift into (and stay in) the same slot.
+				bool keepAlive = slot % period == phase;
+				if (!keepAlive && slot - slotsPrevious [index] < minPeriod)
+					continue;
+
+				TELEMETRY_MESSAGES [index].packer (&frame);
+				if (!keepAlive && !TELEMETRY_MESSAGES [index].delta (dataPrevious [index], frame.data8))
+					continue;
+			}
+
+			frame.IDE = CAN_IDE_STD;
+			frame.SID = TELEMETRY_MESSAGES [index].id;
+			if (canTransmitTimeout (telemetryDriver, CAN_ANY_MAILBOX, &frame, TELEMETRY_SLOT_PERIOD) != MSG_OK)
+				continue;
+
+			slotsPrevious [index] = slot;
+			memcpy (dataPrevious [index], frame.data8, sizeof (dataPrevious [index]));
+		}
+
+		++slot;
+
+		// Sleep until the next slot.
+		systime_t timeNext = chTimeAddX (timeCurrent, TELEMETRY_SLOT_PERIOD);
+		chThdSleepUntilWindowed (timeCurrent, timeNext);
+		timeCurrent = timeNext;
+	}
+}
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+bool telemetryStart (CANDriver* driver, tprio_t priority)
+{
+	// Check the default phases don't share any slots, see the note on the telemetry table.
+	uint16_t defaultPeriods [TELEMETRY_MESSAGE_COUNT];
+	uint16_t defaultPhases [TELEMETRY_MESSAGE_COUNT];
+	for (uint8_t index = 0; index < TELEMETRY_MESSAGE_COUNT; ++index)
+	{
+		defaultPeriods [index] = TELEMETRY_MESSAGES [index].period;
+		defaultPhases [index] = TELEMETRY_MESSAGES [index].phase;
+		if (countCollisions (index, defaultPeriods [index], defaultPhases [index], defaultPeriods, defaultPhases) != 0)
+			return false;
+	}
+
+	telemetryDriver = driver;
+
+	// If the thread is started before the first reconfiguration, use the defaults.
+	for (uint8_t index = 0; index < TELEMETRY_MESSAGE_COUNT; ++index)
+	{
+		if (periods [index] != 0)
+			continue;
+
+		periods [index] = TELEMETRY_MESSAGES [index].period;
+		phases [index] = TELEMETRY_MESSAGES [index].phase;
+		minPeriods [index] = TELEMETRY_MESSAGES [index].delta != NULL ? TELEMETRY_MESSAGES [index].minPeriod : 0;
+	}
+
+	chThdCreateStatic (&telemetryThreadWa, sizeof (telemetryThreadWa), priority, telemetryThread, NULL);
+	return true;
+}
+
+bool telemetryReconfigure (const telemetryConfig_t* config)
+{
+	bool result = true;
+
+	uint16_t newPeriods [TELEMETRY_MESSAGE_COUNT];
+	uint16_t newPhases [TELEMETRY_MESSAGE_COUNT];
+	uint16_t newMinPeriods [TELEMETRY_MESSAGE_COUNT];
+
+	for (uint8_t index = 0; index < TELEMETRY_MESSAGE_COUNT; ++index)
+	{
+		uint16_t period = TELEMETRY_MESSAGES [index].period;
+		if (config->periods [index] != 0)
+			period = periodToSlots (config->periods [index]);
+
+		// Send-on-delta requires a delta function, otherwise the message is always periodic. Requesting it for such a message
+		// is rejected.
+		uint16_t minPeriod = TELEMETRY_MESSAGES [index].minPeriod;
+		if (TELEMETRY_MESSAGES [index].delta == NULL)
+		{
+			minPeriod = 0;
+			if (config->minPeriods [index] != 0 && config->minPeriods [index] != TELEMETRY_DELTA_DISABLED)
+				result = false;
+		}
+		else if (config->minPeriods [index] == TELEMETRY_DELTA_DISABLED)
+			minPeriod = 0;
+		else if (config->minPeriods [index] != 0)
+			minPeriod = periodToSlots (config->minPeriods [index]);
+		newMinPeriods [index] = minPeriod;
+
+		// Place the message relative to those before it.
+		uint16_t preferred = TELEMETRY_MESSAGES [index].phase % period;
+		newPeriods [index] = period;
+		newPhases [index] = selectPhase (index, period, preferred, newPeriods, newPhases);
+	}
+
+	chSysLock ();
+	for (uint8_t index = 0; index < TELEMETRY_MESSAGE_COUNT; ++index)
+	{
+		periods [index] = newPeriods [index];
+		phases [index] = newPhases [index];
+		minPeriods [index] = newMinPeriods [index];
+	}
+	chSysUnlock ();
+
+	return result;
+}
+
+uint16_t periodToSlots (uint16_t periodMs)
+{
+	uint32_t slotMs = TIME_I2MS (TELEMETRY_SLOT_PERIOD);
+	uint16_t period = (periodMs + slotMs / 2) / slotMs;
+	if (period == 0)
+		period = 1;
+	return period;
+}
+
+uint16_t gcd (uint16_t a, uint16_t b)
+{
+	while (b != 0)
+	{
+		uint16_t remainder = a % b;
+		a = b;
+		b = remainder;
+	}
+	return a;
+}
+
+uint8_t countCollisions (uint8_t index, uint16_t period, uint16_t phase, const uint16_t* periods,
+	const uint16_t* phases)
+{
+	if (period == 1)
+		return 0;
+
+	// Two messages collide if their phases are congruent modulo the GCD of their periods.
+	uint8_t collisions = 0;
+	for (uint8_t placed = 0; placed < index; ++placed)
+	{
+		if (periods [placed] == 1)
+			continue;
+
+		uint16_t divisor = gcd (period, periods [placed]);
+		if (phase % divisor == phases [placed] % divisor)
+			++collisions;
+	}
+	return collisions;
+}
+
+uint16_t selectPhase (uint8_t index, uint16_t period, uint16_t preferred, const uint16_t* periods,
+	const uint16_t* phases)
+{
+	uint16_t phaseBest = preferred;
+	uint8_t collisionsBest = UINT8_MAX;
+
+	for (uint16_t offset = 0; offset < period; ++offset)
+	{
+		// Start at the preferred phase so that it wins any tie.
+		uint16_t phase = (preferred + offset) % period;
+		uint8_t collisions = countCollisions (index, period, phase, periods, phases);
+
+		if (collisions < collisionsBest)
+		{
+			phaseBest = phase;
+			collisionsBest = collisions;
+		}
+
+		if (collisions == 0)
+			break;
+	}
+
+	return phaseBest;
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+// VCU CAN Telemetry ----------------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.19
+//
+// Description: Scheduler responsible for transmitting all of the VCU's periodic CAN messages. Each message is described by an
+//   entry in the telemetry table, giving its ID, period, phase offset, and packing function. Time is divided into fixed-length
+//   slots, a message is transmitted in every slot that matches its phase modulo its period. Phase offsets are chosen such that
+//   messages with different periods are spread across different slots, rather than bursting in the same one.
+//
+//   Messages can alternatively be sent on delta. In this mode the message is packed every slot, but only transmitted if a
+//   signal has changed by more than its threshold (see @c can/signals.json ) and the minimum period has elapsed since it was
+//   last transmitted. Additionally, a keep-alive is transmitted in every slot matching the message's phase, such that
+//   receivers can still detect a timeout and keep-alives of different messages remain spread across slots. This cuts the bus
+//   load while idle or in steady-state, without delaying the response to a change.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// ChibiOS
+#include "hal.h"
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The length of a single telemetry time slot. All message periods and phases are integer multiples of this.
+#define TELEMETRY_SLOT_PERIOD TIME_MS2I (10)
+
+/// @brief The maximum number of messages in the telemetry table (the number of configurable periods in the EEPROM).
+#define TELEMETRY_MESSAGE_COUNT_MAX 8
+
+/// @brief Value of a message's minimum period that disables send-on-delta.
+#define TELEMETRY_DELTA_DISABLED 0xFFFF
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Function responsible for packing the payload of a telemetry message.
+ * @note The ID of the frame is set by the scheduler after packing, this function should only set the DLC and data fields.
+ * @param frame The frame to write into.
+ */
+typedef void (telemetryPacker_t) (CANTxFrame* frame);
+
+/**
+ * @brief Function responsible for checking whether a message's payload has changed enough to warrant transmitting it.
+ * @param previous The payload of the previously transmitted frame.
+ * @param current The payload of the newly packed frame.
+ * @return True if the frame should be transmitted, false otherwise.
+ */
+typedef bool (telemetryDelta_t) (const uint8_t* previous, const uint8_t* current);
+
+typedef struct
+{
+	/// @brief The standard ID of the message.
+	uint16_t id;
+	/// @brief The default period of the message, in slots. For send-on-delta messages, this is the maximum interval.
+	uint16_t period;
+	/// @brief The default minimum interval of send-on-delta messages, in slots. 0 indicates the message is sent periodically.
+	/// Ignored if @c delta is @c NULL .
+	uint16_t minPeriod;
+	/// @brief The preferred phase offset of the message, in slots. Must be less than @c period .
+	uint16_t phase;
+	/// @brief The function used to pack the message's payload.
+	telemetryPacker_t* packer;
+	/// @brief The function used to check the message's payload for changes, @c NULL if the message can't be sent on delta.
+	/// Send-on-delta messages are packed every slot, so this must be @c NULL if @c packer has side effects.
+	telemetryDelta_t* delta;
+} telemetryMessage_t;
+
+typedef struct
+{
+	/// @brief The period of each message in the telemetry table, in milliseconds. Rounded to the nearest slot. A value of 0
+	/// selects the message's default period. For send-on-delta messages, this is the maximum interval.
+	uint16_t periods [TELEMETRY_MESSAGE_COUNT_MAX];
+	/// @brief The minimum interval of each send-on-delta message, in milliseconds. Rounded to the nearest slot. A value of 0
+	/// selects the message's default, a value of @c TELEMETRY_DELTA_DISABLED sends the message periodically instead.
+	uint16_t minPeriods [TELEMETRY_MESSAGE_COUNT_MAX];
+} telemetryConfig_t;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Starts the telemetry thread.
+ * @param driver The CAN driver to transmit on.
+ * @param priority The priority to start the thread at.
+ * @return False if the default phases of any two messages share a slot (in which case the thread is not started), true
+ * otherwise.
+ */
+bool telemetryStart (CANDriver* driver, tprio_t priority);
+
+/**
+ * @brief Applies a new set of message periods, re-balancing the phase of each message as needed.
+ * @param config The configuration to apply.
+ * @return False if a minimum period was configured for a message that can't be sent on delta (in which case the message is
+ * sent periodically), true otherwise.
+ */
+bool telemetryReconfigure (const telemetryConfig_t* config);
+
+#endif // TELEMETRY_H
\ No newline at end of file
@@ -6,7 +6,8 @@
 // Author: Cole Barach
 // Date Created: 2024.10.21
 //
-// Description: Functions for transmitting CAN messages that aren't directed towards a specific CAN node.
+// Description: Functions for packing CAN messages that aren't directed towards a specific CAN node. These are transmitted by
+//   the telemetry scheduler, see @c can/telemetry.h for more details.
 
 // Includes -------------------------------------------------------------------------------------------------------------------
 
@@ -16,35 +17,49 @@
 // Functions ------------------------------------------------------------------------------------------------------------------
 
 /**
- * @brief Transmits the VCU status message, given its current state.
- * @param driver The CAN driver to use.
- * @param timeout The interval to timeout after.
- * @return The result of the CAN operation.
+ * @brief Packs the VCU status message, given its current state.
+ * @param frame The frame to write into.
  */
-msg_t transmitStatusMessage (CANDriver* driver, sysinterval_t timeout);
+void transmitPackStatus (CANTxFrame* frame);
 
 /**
- * @brief Transmits the VCU sensor input percent message, given the current sensor inputs.
- * @param driver The CAN driver to use.
- * @param timeout The interval to timeout after.
- * @return The result of the CAN operation.
+ * @brief Packs the VCU sensor input percent message, given the current sensor inputs.
+ * @param frame The frame to write into.
  */
-msg_t transmitSensorInputPercent (CANDriver* driver, sysinterval_t timeout);
+void transmitPackSensorInputPercent (CANTxFrame* frame);
 
 /**
- * @brief Transmits the VCU temperatures message.
- * @param driver The CAN driver to use.
- * @param timeout The interval to timeout after.
- * @return The result of the CAN operation.
+ * @brief Packs the VCU temperatures message.
+ * @param frame The frame to write into.
  */
-msg_t transmitTemperaturesMessage (CANDriver* driver, sysinterval_t timeout);
+void transmitPackTemperatures (CANTxFrame* frame);
 
 /**
- * @brief Transmits the vehicle configuration message.
- * @param driver The CAN driver to use.
- * @param timeout The interval to timeout after.
- * @return The result of the CAN operation.
+ * @brief Packs the vehicle configuration message.
+ * @param frame The frame to write into.
  */
-msg_t transmitConfigMessage (CANDriver* driver, sysinterval_t timeout);
+void transmitPackConfig (CANTxFrame* frame);
+
+/**
+ * @brief Packs the sensor health message. Each call reports the next sensor in turn, starting a new window of its statistics.
+ * @param frame The frame to write into.
+ */
+void transmitPackSensorHealth (CANTxFrame* frame);
+
+/**
+ * @brief Packs the CAN statistics message, reporting the latency and drops of the CAN receive dispatcher.
+ * @param frame The frame to write into.
+ */
+void transmitPackCanStatistics (CANTxFrame* frame);
+
+/**
+ * @brief Packs the boot timing message. Unlike the other messages, this is not transmitted by the telemetry scheduler, rather
+ * it is transmitted once upon startup.
+ * @param frame The frame to write into.
+ * @param peripheralsTime The time at which the peripherals were initialized.
+ * @param canTime The time at which the CAN interface was started.
+ * @param readyTime The time at which the VCU finished starting up.
+ */
+void transmitPackBoot (CANTxFrame* frame, systime_t peripheralsTime, systime_t canTime, systime_t readyTime);
 
 #endif // TRANSMIT_H
\ No newline at end of file
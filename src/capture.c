@@ -0,0 +1,250 @@
+// Header
+#include "capture.h"
+
+// C Standard Library
+#include <stddef.h>
+#include <string.h>
+
+// Global Data ----------------------------------------------------------------------------------------------------------------
+
+captureState_t captureState = CAPTURE_STATE_IDLE;
+
+eeprom_t captureEeprom;
+
+/// @brief The ring buffer of recorded samples.
+static captureSample_t samples [CAPTURE_SAMPLE_COUNT];
+
+/// @brief The index of the next sample to be written.
+static uint16_t sampleHead = 0;
+
+/// @brief The number of samples recorded since the capture was armed (saturates at the buffer size).
+static uint16_t sampleCount = 0;
+
+/// @brief The number of samples remaining to record after the trigger.
+static uint16_t postTriggerRemaining = 0;
+
+/// @brief The active trigger configuration.
+static captureConfig_t config =
+{
+	.trigger			= CAPTURE_TRIGGER_MANUAL,
+	.preTriggerCount	= CAPTURE_SAMPLE_COUNT / 2
+};
+
+/// @brief The previous sample, used for detecting edges.
+static captureSample_t samplePrevious;
+
+/// @brief Indicates @c samplePrevious is valid.
+static bool samplePreviousValid = false;
+
+/// @brief The offset of each threshold channel within a sample.
+static const uint8_t CHANNEL_OFFSETS [CAPTURE_CHANNEL_COUNT] =
+{
+	[CAPTURE_CHANNEL_TORQUE_RL]		= offsetof (captureSample_t, torqueRl),
+	[CAPTURE_CHANNEL_TORQUE_RR]		= offsetof (captureSample_t, torqueRr),
+	[CAPTURE_CHANNEL_TORQUE_FL]		= offsetof (captureSample_t, torqueFl),
+	[CAPTURE_CHANNEL_TORQUE_FR]		= offsetof (captureSample_t, torqueFr),
+	[CAPTURE_CHANNEL_SPEED_RL]		= offsetof (captureSample_t, speedRl),
+	[CAPTURE_CHANNEL_SPEED_RR]		= offsetof (captureSample_t, speedRr),
+	[CAPTURE_CHANNEL_SPEED_FL]		= offsetof (captureSample_t, speedFl),
+	[CAPTURE_CHANNEL_SPEED_FR]		= offsetof (captureSample_t, speedFr),
+	[CAPTURE_CHANNEL_POWER]			= offsetof (captureSample_t, power),
+	[CAPTURE_CHANNEL_POWER_PID_XP]	= offsetof (captureSample_t, powerPidXp),
+	[CAPTURE_CHANNEL_POWER_PID_XI]	= offsetof (captureSample_t, powerPidXi),
+	[CAPTURE_CHANNEL_POWER_PID_XD]	= offsetof (captureSample_t, powerPidXd)
+};
+
+_Static_assert (sizeof (captureSample_t) == 64, "Capture sample size changed, update the capture region size.");
+
+// Function Prototypes --------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Triggers the capture, if armed. Must be called from a locked context.
+ */
+static void triggerS (void);
+
+/**
+ * @brief Evaluates the trigger condition against the newest sample.
+ * @param sample The newest sample.
+ * @return True if the capture should trigger, false otherwise.
+ */
+static bool evaluateTrigger (const captureSample_t* sample);
+
+/**
+ * @brief Gets the value of a threshold channel of a sample.
+ */
+static float getChannel (const captureSample_t* sample, uint8_t channel);
+
+/**
+ * @brief Reads from the capture buffer, ordered oldest to newest. Only valid once the capture is complete.
+ */
+static bool captureRead (void* object, uint16_t addr, void* data, uint16_t dataCount);
+
+/**
+ * @brief Rejects all writes to the capture buffer.
+ */
+static bool captureWrite (void* object, uint16_t addr, const void* data, uint16_t dataCount);
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+void captureInit (void)
+{
+	eepromInit (&captureEeprom, captureWrite, captureRead);
+}
+
+void captureReconfigure (const captureConfig_t* newConfig)
+{
+	chSysLock ();
+
+	config = *newConfig;
+	if (config.preTriggerCount >= CAPTURE_SAMPLE_COUNT)
+		config.preTriggerCount = CAPTURE_SAMPLE_COUNT - 1;
+
+	// Changing the trigger mid-capture would invalidate the pre-trigger window.
+	if (captureState == CAPTURE_STATE_ARMED || captureState == CAPTURE_STATE_TRIGGERED)
+		captureState = CAPTURE_STATE_IDLE;
+
+	chSysUnlock ();
+}
+
+void captureArm (void)
+{
+	chSysLock ();
+	sampleHead = 0;
+	sampleCount = 0;
+	samplePreviousValid = false;
+	captureState = CAPTURE_STATE_ARMED;
+	chSysUnlock ();
+}
+
+void captureTrigger (void)
+{
+	chSysLock ();
+	triggerS ();
+	chSysUnlock ();
+}
+
+void captureRecord (const captureSample_t* sample)
+{
+	// The record is a single state transition, otherwise arming or reconfiguring the capture part way through would leave the
+	// sample written at a stale head, or counted towards a discarded capture. The sample is only copied twice, so this is
+	// short.
+	chSysLock ();
+
+	if (captureState != CAPTURE_STATE_ARMED && captureState != CAPTURE_STATE_TRIGGERED)
+	{
+		chSysUnlock ();
+		return;
+	}
+
+	samples [sampleHead] = *sample;
+	sampleHead = (sampleHead + 1) % CAPTURE_SAMPLE_COUNT;
+	if (sampleCount < CAPTURE_SAMPLE_COUNT)
+		++sampleCount;
+
+	// Only trigger once the pre-trigger window has been filled.
+	if (captureState == CAPTURE_STATE_ARMED && sampleCount > config.preTriggerCount && evaluateTrigger (sample))
+		triggerS ();
+
+	samplePrevious = *sample;
+	samplePreviousValid = true;
+
+	// Complete once the post-trigger window is filled. If manually triggered before the pre-trigger window was filled, keep
+	// recording until the whole buffer is.
+	if (captureState == CAPTURE_STATE_TRIGGERED)
+	{
+		if (postTriggerRemaining > 0)
+			--postTriggerRemaining;
+
+		if (postTriggerRemaining == 0 && sampleCount == CAPTURE_SAMPLE_COUNT)
+			captureState = CAPTURE_STATE_COMPLETE;
+	}
+
+	chSysUnlock ();
+}
+
+void triggerS (void)
+{
+	if (captureState != CAPTURE_STATE_ARMED)
+		return;
+
+	postTriggerRemaining = CAPTURE_SAMPLE_COUNT - config.preTriggerCount;
+	captureState = CAPTURE_STATE_TRIGGERED;
+}
+
+bool evaluateTrigger (const captureSample_t* sample)
+{
+	// All triggers are edge-triggered, so require a previous sample.
+	if (!samplePreviousValid)
+		return false;
+
+	switch (config.trigger)
+	{
+	case CAPTURE_TRIGGER_PLAUSIBILITY_LOSS:
+		return (samplePrevious.torquePlausible && !sample->torquePlausible) ||
+			(samplePrevious.pedalsPlausible && !sample->pedalsPlausible);
+
+	case CAPTURE_TRIGGER_DERATING:
+		return !samplePrevious.torqueDerating && sample->torqueDerating;
+
+	case CAPTURE_TRIGGER_THRESHOLD_RISING:
+		return getChannel (&samplePrevious, config.channel) <= config.threshold &&
+			getChannel (sample, config.channel) > config.threshold;
+
+	case CAPTURE_TRIGGER_THRESHOLD_FALLING:
+		return getChannel (&samplePrevious, config.channel) >= config.threshold &&
+			getChannel (sample, config.channel) < config.threshold;
+
+	default:
+		return false;
+	}
+}
+
+float getChannel (const captureSample_t* sample, uint8_t channel)
+{
+	if (channel >= CAPTURE_CHANNEL_COUNT)
+		return 0.0f;
+
+	float value;
+	memcpy (&value, (const uint8_t*) sample + CHANNEL_OFFSETS [channel], sizeof (value));
+	return value;
+}
+
+bool captureRead (void* object, uint16_t addr, void* data, uint16_t dataCount)
+{
+	(void) object;
+
+	if (captureState != CAPTURE_STATE_COMPLETE)
+		return false;
+
+	if (addr + dataCount > CAPTURE_BUFFER_SIZE)
+		return false;
+
+	// The buffer is full once complete, so the oldest sample is the one at the head.
+	uint8_t* dataBytes = data;
+	while (dataCount > 0)
+	{
+		uint16_t sampleIndex = (sampleHead + addr / sizeof (captureSample_t)) % CAPTURE_SAMPLE_COUNT;
+		uint16_t sampleOffset = addr % sizeof (captureSample_t);
+		uint16_t count = sizeof (captureSample_t) - sampleOffset;
+		if (count > dataCount)
+			count = dataCount;
+
+		memcpy (dataBytes, (uint8_t*) &samples [sampleIndex] + sampleOffset, count);
+
+		dataBytes += count;
+		addr += count;
+		dataCount -= count;
+	}
+
+	return true;
+}
+
+bool captureWrite (void* object, uint16_t addr, const void* data, uint16_t dataCount)
+{
+	(void) object;
+	(void) addr;
+	(void) data;
+	(void) dataCount;
+
+	return false;
+}
\ No newline at end of file
@@ -0,0 +1,158 @@
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+// Triggered Capture ----------------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.19
+//
+// Description: On-board 'oscilloscope' for diagnosing single events, such as a torque dropout. While armed, a snapshot of the
+//   control signals is recorded every control cycle into a RAM ring buffer. When the trigger condition is met, recording
+//   continues until the post-trigger window is filled, after which the buffer is frozen. The buffer is then downloadable via
+//   the virtual EEPROM, ordered oldest to newest, as an array of @c captureSample_t .
+//
+//   Usage:
+//   - Configure the trigger via the EEPROM map (see @c captureConfig_t ).
+//   - Arm the capture via the write-only command.
+//   - Once the capture state reads complete, read the samples from the capture region of the virtual EEPROM.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "peripherals/interface/eeprom.h"
+
+// ChibiOS
+#include "ch.h"
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The number of samples in the capture buffer.
+#define CAPTURE_SAMPLE_COUNT 256
+
+/// @brief The size of the capture buffer, in bytes.
+#define CAPTURE_BUFFER_SIZE (CAPTURE_SAMPLE_COUNT * sizeof (captureSample_t))
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef enum
+{
+	/// @brief Nothing is being recorded.
+	CAPTURE_STATE_IDLE = 0,
+	/// @brief Samples are being recorded, waiting for the trigger condition.
+	CAPTURE_STATE_ARMED = 1,
+	/// @brief The trigger condition has been met, samples are being recorded until the post-trigger window is filled.
+	CAPTURE_STATE_TRIGGERED = 2,
+	/// @brief The capture is complete, the buffer is ready to be read.
+	CAPTURE_STATE_COMPLETE = 3
+} captureState_t;
+
+typedef enum
+{
+	/// @brief Only triggered manually, via the write-only command.
+	CAPTURE_TRIGGER_MANUAL = 0,
+	/// @brief Triggered when either the torque request or the pedals become implausible.
+	CAPTURE_TRIGGER_PLAUSIBILITY_LOSS = 1,
+	/// @brief Triggered when the torque request begins derating.
+	CAPTURE_TRIGGER_DERATING = 2,
+	/// @brief Triggered when the selected channel rises above the threshold.
+	CAPTURE_TRIGGER_THRESHOLD_RISING = 3,
+	/// @brief Triggered when the selected channel falls below the threshold.
+	CAPTURE_TRIGGER_THRESHOLD_FALLING = 4
+} captureTrigger_t;
+
+/// @brief The channels of a sample that threshold triggers can be applied to.
+typedef enum
+{
+	CAPTURE_CHANNEL_TORQUE_RL		= 0,
+	CAPTURE_CHANNEL_TORQUE_RR		= 1,
+	CAPTURE_CHANNEL_TORQUE_FL		= 2,
+	CAPTURE_CHANNEL_TORQUE_FR		= 3,
+	CAPTURE_CHANNEL_SPEED_RL		= 4,
+	CAPTURE_CHANNEL_SPEED_RR		= 5,
+	CAPTURE_CHANNEL_SPEED_FL		= 6,
+	CAPTURE_CHANNEL_SPEED_FR		= 7,
+	CAPTURE_CHANNEL_POWER			= 8,
+	CAPTURE_CHANNEL_POWER_PID_XP	= 9,
+	CAPTURE_CHANNEL_POWER_PID_XI	= 10,
+	CAPTURE_CHANNEL_POWER_PID_XD	= 11,
+	CAPTURE_CHANNEL_COUNT			= 12
+} captureChannel_t;
+
+/// @brief A snapshot of the control signals during a single control cycle.
+typedef struct
+{
+	systime_t time;						// 0x00
+	uint16_t apps1Sample;				// 0x04
+	uint16_t apps2Sample;				// 0x06
+	uint16_t bseFSample;				// 0x08
+	uint16_t bseRSample;				// 0x0A
+	uint16_t sasSample;					// 0x0C
+	uint8_t vehicleState;				// 0x0E
+	bool torquePlausible : 1;			// 0x0F
+	bool torqueDerating : 1;
+	bool pedalsPlausible : 1;
+	bool feedbackConfident : 1;
+	float torqueRl;						// 0x10
+	float torqueRr;						// 0x14
+	float torqueFl;						// 0x18
+	float torqueFr;						// 0x1C
+	float speedRl;						// 0x20
+	float speedRr;						// 0x24
+	float speedFl;						// 0x28
+	float speedFr;						// 0x2C
+	float power;						// 0x30
+	float powerPidXp;					// 0x34
+	float powerPidXi;					// 0x38
+	float powerPidXd;					// 0x3C
+} captureSample_t;
+
+typedef struct
+{
+	/// @brief The condition to trigger on, see @c captureTrigger_t .
+	uint8_t trigger;
+	/// @brief The channel to apply threshold triggers to, see @c captureChannel_t .
+	uint8_t channel;
+	/// @brief The number of samples to keep preceding the trigger, the remainder of the buffer is used for samples following it.
+	uint16_t preTriggerCount;
+	/// @brief The threshold of threshold triggers.
+	float threshold;
+} captureConfig_t;
+
+// Global Data ----------------------------------------------------------------------------------------------------------------
+
+/// @brief The current state of the capture.
+extern captureState_t captureState;
+
+/// @brief Virtual EEPROM exposing the capture buffer, see @c CAPTURE_BUFFER_SIZE .
+extern eeprom_t captureEeprom;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Initializes the capture module.
+ */
+void captureInit (void);
+
+/**
+ * @brief Applies a new trigger configuration. Disarms the capture if it was in progress.
+ * @param config The configuration to apply.
+ */
+void captureReconfigure (const captureConfig_t* config);
+
+/**
+ * @brief Arms the capture, discarding any previously captured samples.
+ */
+void captureArm (void);
+
+/**
+ * @brief Manually triggers the capture, if armed.
+ */
+void captureTrigger (void);
+
+/**
+ * @brief Records a sample into the capture buffer, evaluating the trigger condition. Should be called once per control cycle.
+ * @param sample The sample to record.
+ */
+void captureRecord (const captureSample_t* sample);
+
+#endif // CAPTURE_H
\ No newline at end of file
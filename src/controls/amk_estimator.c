@@ -0,0 +1,154 @@
+// Header
+#include "amk_estimator.h"
+
+// C Standard Library
+#include <math.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief Conversion factor from RPM to rad/s.
+#define RPM_TO_RAD_PER_S (2.0f * (float) M_PI / 60.0f)
+
+/// @brief The weight of each new interval in the average frame period.
+#define FRAME_PERIOD_GAIN 0.125f
+
+/// @brief Intervals longer than this multiple of the average frame period are assumed to contain lost frames, so are excluded
+/// from the average.
+#define FRAME_PERIOD_OUTLIER 1.5f
+
+// Global Data ----------------------------------------------------------------------------------------------------------------
+
+amkEstimate_t amkEstimates [AMK_COUNT];
+
+uint8_t amkEstimatesConfident = 0;
+
+static const amkEstimatorConfig_t DEFAULT_CONFIG =
+{
+	.missedFrameMax = 0
+};
+
+static const amkEstimatorConfig_t* config = &DEFAULT_CONFIG;
+
+/// @brief The signal carrying the speed of each inverter. The power is part of the same frame.
+static const canSignal_t SPEED_SIGNALS [AMK_COUNT] =
+{
+	CAN_SIGNAL_AMK_RL_ACTUAL_SPEED,
+	CAN_SIGNAL_AMK_RR_ACTUAL_SPEED,
+	CAN_SIGNAL_AMK_FL_ACTUAL_SPEED,
+	CAN_SIGNAL_AMK_FR_ACTUAL_SPEED
+};
+
+// Function Prototypes --------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Updates the estimate of a single inverter.
+ * @param estimate The estimate to update.
+ * @param index The index of the inverter.
+ * @param timeCurrent The time of the current control cycle.
+ * @param torque The torque commanded of the inverter, in Nm.
+ * @return True if the estimate is confident, false otherwise.
+ */
+static bool updateEstimate (amkEstimate_t* estimate, uint8_t index, systime_t timeCurrent, float torque);
+
+/**
+ * @brief Records a newly received frame.
+ */
+static void updateSample (amkEstimate_t* estimate, uint8_t index, systime_t sampleTime, float torque);
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+void amkEstimatorReconfigure (const amkEstimatorConfig_t* newConfig)
+{
+	config = newConfig;
+}
+
+void amkEstimatorUpdate (systime_t timeCurrent, const tvOutput_t* torqueCommanded)
+{
+	const float torques [AMK_COUNT] =
+	{
+		torqueCommanded->torqueRl,
+		torqueCommanded->torqueRr,
+		torqueCommanded->torqueFl,
+		torqueCommanded->torqueFr
+	};
+
+	uint8_t confident = 0;
+	for (uint8_t index = 0; index < AMK_COUNT; ++index)
+	{
+		amkEstimates [index].confident = updateEstimate (&amkEstimates [index], index, timeCurrent, torques [index]);
+		if (amkEstimates [index].confident)
+			confident |= 1 << index;
+	}
+
+	amkEstimatesConfident = confident;
+}
+
+float amkEstimatorGetCumulativePower (void)
+{
+	float power = 0.0f;
+	for (uint8_t index = 0; index < AMK_COUNT; ++index)
+		power += amkEstimates [index].power;
+	return power;
+}
+
+bool updateEstimate (amkEstimate_t* estimate, uint8_t index, systime_t timeCurrent, float torque)
+{
+	// Check for a new frame.
+	systime_t sampleTime;
+	if (canGetSignalTimestamp (SPEED_SIGNALS [index], &sampleTime) && (!estimate->sampled || sampleTime != estimate->sampleTime))
+		updateSample (estimate, index, sampleTime, torque);
+
+	// Default to the most recent measurement.
+	estimate->speed = estimate->sampleSpeed;
+	estimate->power = estimate->samplePower;
+
+	if (!estimate->sampled || estimate->framePeriod == 0.0f || config->missedFrameMax == 0 ||
+		!amkGetValidityLock (&amks [index]))
+		return false;
+
+	// The frame may have arrived after the start of the control cycle.
+	int32_t ageTicks = (int32_t) (timeCurrent - estimate->sampleTime);
+	if (ageTicks < 0)
+		ageTicks = 0;
+	float age = TIME_I2US (ageTicks) / 1000000.0f;
+
+	// Only extrapolate within the horizon.
+	if (age > estimate->framePeriod * (config->missedFrameMax + 1))
+		return false;
+
+	estimate->speed = estimate->sampleSpeed + estimate->speedRate * age;
+	estimate->power = estimate->samplePower +
+		(torque * estimate->speed - estimate->sampleTorque * estimate->sampleSpeed) * RPM_TO_RAD_PER_S;
+	return true;
+}
+
+void updateSample (amkEstimate_t* estimate, uint8_t index, systime_t sampleTime, float torque)
+{
+	amkInverter_t* amk = &amks [index];
+
+	canNodeLock ((canNode_t*) amk);
+	float speed = amk->actualSpeed;
+	canNodeUnlock ((canNode_t*) amk);
+
+	float power = amksGetCumulativePower (amk, 1);
+
+	if (estimate->sampled)
+	{
+		float interval = TIME_I2US (chTimeDiffX (estimate->sampleTime, sampleTime)) / 1000000.0f;
+		if (interval > 0.0f)
+		{
+			estimate->speedRate = (speed - estimate->sampleSpeed) / interval;
+
+			if (estimate->framePeriod == 0.0f)
+				estimate->framePeriod = interval;
+			else if (interval < estimate->framePeriod * FRAME_PERIOD_OUTLIER)
+				estimate->framePeriod += (interval - estimate->framePeriod) * FRAME_PERIOD_GAIN;
+		}
+	}
+
+	estimate->sampled		= true;
+	estimate->sampleTime	= sampleTime;
+	estimate->sampleSpeed	= speed;
+	estimate->samplePower	= power;
+	estimate->sampleTorque	= torque;
+}
\ No newline at end of file
@@ -0,0 +1,107 @@
+#ifndef AMK_ESTIMATOR_H
+#define AMK_ESTIMATOR_H
+
+// AMK Feedback Estimator -----------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.19
+//
+// Description: Short-horizon dead-reckoning of the AMK inverters' feedback. Without this, a single lost actual-values frame
+//   leaves the control loop running on a stale speed and power until the inverter's node times out. Instead, each control
+//   cycle the speed and power are extrapolated from the arrival time of the most recent frame:
+//   - The speed is extrapolated linearly, using the rate of change between the two most recent frames.
+//   - The power is extrapolated from the most recent measurement, adding the change in mechanical power (torque * speed) from
+//     the torque commanded since the frame and the extrapolated speed.
+//
+//   The period of the actual-values frames is measured rather than assumed. An estimate is only confident while the number of
+//   consecutive frames missed is within the configured limit, beyond this the estimate falls back to the most recent
+//   measurement (identical to the behaviour without an estimator) and the node's timeout remains responsible for invalidating
+//   it.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "can.h"
+#include "controls/torque_vectoring.h"
+
+// ChibiOS
+#include "ch.h"
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef struct
+{
+	/// @brief The maximum number of consecutive frames that can be missed before the estimate is no longer confident. 0
+	/// disables extrapolation entirely.
+	uint16_t missedFrameMax;
+} amkEstimatorConfig_t;
+
+typedef struct
+{
+	/// @brief The estimated motor speed, in RPM.
+	float speed;
+	/// @brief The estimated power consumption, in Watts.
+	float power;
+	/// @brief Indicates whether the estimate is within the configured horizon. If false, @c speed and @c power are the most
+	/// recent measurements.
+	bool confident;
+
+	/// @brief Indicates whether at least one frame has been received.
+	bool sampled;
+	/// @brief The arrival time of the most recent frame.
+	systime_t sampleTime;
+	/// @brief The speed of the most recent frame, in RPM.
+	float sampleSpeed;
+	/// @brief The power of the most recent frame, in Watts.
+	float samplePower;
+	/// @brief The torque commanded at the time of the most recent frame, in Nm.
+	float sampleTorque;
+	/// @brief The rate of change of speed between the two most recent frames, in RPM/s.
+	float speedRate;
+	/// @brief The average period of the frames, in seconds. 0 until measured.
+	float framePeriod;
+} amkEstimate_t;
+
+// Global Data ----------------------------------------------------------------------------------------------------------------
+
+/// @brief The estimate of the rear-left AMK inverter.
+#define amkEstimateRl (amkEstimates [0])
+
+/// @brief The estimate of the rear-right AMK inverter.
+#define amkEstimateRr (amkEstimates [1])
+
+/// @brief The estimate of the front-left AMK inverter.
+#define amkEstimateFl (amkEstimates [2])
+
+/// @brief The estimate of the front-right AMK inverter.
+#define amkEstimateFr (amkEstimates [3])
+
+/// @brief The estimates of each inverter, indexed the same as @c amks .
+extern amkEstimate_t amkEstimates [AMK_COUNT];
+
+/// @brief Bitmask of the confident estimates, bit N corresponding to @c amkEstimates [N] .
+extern uint8_t amkEstimatesConfident;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Updates the configuration of the estimator.
+ * @param config The configuration to use. Must remain in scope.
+ */
+void amkEstimatorReconfigure (const amkEstimatorConfig_t* config);
+
+/**
+ * @brief Updates the estimates of every inverter. Should be called once per control cycle, prior to any of the estimates being
+ * used.
+ * @param timeCurrent The time of the current control cycle.
+ * @param torqueCommanded The torque commanded of each inverter in the previous control cycle.
+ */
+void amkEstimatorUpdate (systime_t timeCurrent, const tvOutput_t* torqueCommanded);
+
+/**
+ * @brief Gets the estimated cumulative power consumption of all inverters.
+ * @return The estimated power, in Watts.
+ */
+float amkEstimatorGetCumulativePower (void);
+
+#endif // AMK_ESTIMATOR_H
\ No newline at end of file
@@ -0,0 +1,212 @@
+// Header
+#include "sample_filter.h"
+
+// C Standard Library
+#include <math.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The largest possible sample.
+#define SAMPLE_MAX UINT16_MAX
+
+/// @brief The Q15 representation of 0.5, for rounding.
+#define Q15_HALF (1 << 14)
+
+// Function Prototypes --------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Validates a filter's (copied) configuration, calculating its group delay.
+ * @return True if the configuration is valid, false otherwise.
+ */
+static bool validate (sampleFilter_t* filter);
+
+/**
+ * @brief Primes the filter's state, such that its output is in steady-state for a constant input of @c sample .
+ */
+static void prime (sampleFilter_t* filter, uint16_t sample);
+
+/**
+ * @brief Gets the sample @c delay samples prior to the most recent one.
+ */
+static inline uint16_t historyGet (sampleFilter_t* filter, uint8_t delay);
+
+/**
+ * @brief Saturates a value to the range of a sample.
+ */
+static inline uint16_t saturate (float value);
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+bool sampleFilterInit (sampleFilter_t* filter, const sampleFilterConfig_t* config)
+{
+	filter->config = *config;
+	filter->primed = false;
+	filter->historyIndex = 0;
+
+	bool result = validate (filter);
+	if (!result)
+	{
+		filter->type = SAMPLE_FILTER_NONE;
+		filter->groupDelay = 0.0f;
+	}
+
+	return result;
+}
+
+uint16_t sampleFilterUpdate (sampleFilter_t* filter, uint16_t sample)
+{
+	if (filter->type == SAMPLE_FILTER_NONE)
+		return sample;
+
+	if (!filter->primed)
+		prime (filter, sample);
+
+	filter->historyIndex = (filter->historyIndex + 1) % SAMPLE_FILTER_HISTORY_SIZE;
+	filter->history [filter->historyIndex] = sample;
+
+	const sampleFilterConfig_t* config = &filter->config;
+	switch (filter->type)
+	{
+	case SAMPLE_FILTER_BIQUAD:
+	{
+		// Direct form II transposed.
+		const float* c = config->coefficients;
+		float x = sample;
+		float y = c [0] * x + filter->state [0];
+		filter->state [0] = c [1] * x - c [3] * y + filter->state [1];
+		filter->state [1] = c [2] * x - c [4] * y;
+		return saturate (y);
+	}
+
+	case SAMPLE_FILTER_MEDIAN:
+	{
+		// Insertion sort of the window, which is small enough for this to be cheaper than a running median structure.
+		uint16_t window [SAMPLE_FILTER_WINDOW_MAX];
+		for (uint8_t index = 0; index < config->length; ++index)
+		{
+			uint16_t value = historyGet (filter, index);
+			uint8_t position = index;
+			for (; position > 0 && window [position - 1] > value; --position)
+				window [position] = window [position - 1];
+			window [position] = value;
+		}
+		return window [config->length / 2];
+	}
+
+	case SAMPLE_FILTER_FIR:
+	{
+		// Multiply-accumulate in Q15, rounding the result. A 64-bit accumulator can't overflow for any combination of samples
+		// and taps (and is a single instruction on the Cortex-M4).
+		int64_t accumulator = Q15_HALF;
+		for (uint8_t index = 0; index < config->length; ++index)
+			accumulator += (int32_t) config->taps [index] * historyGet (filter, index);
+
+		int64_t y = accumulator >> 15;
+		if (y < 0)
+			return 0;
+		if (y > SAMPLE_MAX)
+			return SAMPLE_MAX;
+		return y;
+	}
+
+	default:
+		return sample;
+	}
+}
+
+bool validate (sampleFilter_t* filter)
+{
+	const sampleFilterConfig_t* config = &filter->config;
+	filter->type = config->type;
+
+	switch (config->type)
+	{
+	case SAMPLE_FILTER_NONE:
+		filter->groupDelay = 0.0f;
+		return true;
+
+	case SAMPLE_FILTER_BIQUAD:
+	{
+		const float* c = config->coefficients;
+		for (uint8_t index = 0; index < 5; ++index)
+			if (!isfinite (c [index]))
+				return false;
+
+		// Stability triangle: both poles inside the unit circle.
+		if (fabsf (c [4]) >= 1.0f || fabsf (c [3]) >= 1.0f + c [4])
+			return false;
+
+		float numerator = c [0] + c [1] + c [2];
+		float denominator = 1.0f + c [3] + c [4];
+		if (numerator == 0.0f)
+			return false;
+
+		// Group delay at DC: that of the numerator less that of the denominator.
+		filter->groupDelay = (c [1] + 2.0f * c [2]) / numerator - (c [3] + 2.0f * c [4]) / denominator;
+		return true;
+	}
+
+	case SAMPLE_FILTER_MEDIAN:
+		if (config->length == 0 || config->length > SAMPLE_FILTER_WINDOW_MAX || config->length % 2 == 0)
+			return false;
+
+		filter->groupDelay = (config->length - 1) / 2.0f;
+		return true;
+
+	case SAMPLE_FILTER_FIR:
+	{
+		if (config->length == 0 || config->length > SAMPLE_FILTER_TAP_COUNT_MAX)
+			return false;
+
+		int32_t sum = 0;
+		int32_t moment = 0;
+		for (uint8_t index = 0; index < config->length; ++index)
+		{
+			sum += config->taps [index];
+			moment += index * config->taps [index];
+		}
+
+		if (sum <= 0)
+			return false;
+
+		// Group delay at DC: the centroid of the taps.
+		filter->groupDelay = (float) moment / sum;
+		return true;
+	}
+
+	default:
+		return false;
+	}
+}
+
+void prime (sampleFilter_t* filter, uint16_t sample)
+{
+	for (uint8_t index = 0; index < SAMPLE_FILTER_HISTORY_SIZE; ++index)
+		filter->history [index] = sample;
+
+	if (filter->type == SAMPLE_FILTER_BIQUAD)
+	{
+		// Steady-state of the direct form II transposed, for a constant input x and output y = x * DC gain.
+		const float* c = filter->config.coefficients;
+		float x = sample;
+		float y = x * (c [0] + c [1] + c [2]) / (1.0f + c [3] + c [4]);
+		filter->state [1] = c [2] * x - c [4] * y;
+		filter->state [0] = c [1] * x - c [3] * y + filter->state [1];
+	}
+
+	filter->primed = true;
+}
+
+uint16_t historyGet (sampleFilter_t* filter, uint8_t delay)
+{
+	return filter->history [(filter->historyIndex + SAMPLE_FILTER_HISTORY_SIZE - delay) % SAMPLE_FILTER_HISTORY_SIZE];
+}
+
+uint16_t saturate (float value)
+{
+	if (value <= 0.0f)
+		return 0;
+	if (value >= SAMPLE_MAX)
+		return SAMPLE_MAX;
+	return (uint16_t) (value + 0.5f);
+}
\ No newline at end of file
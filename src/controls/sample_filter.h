@@ -0,0 +1,113 @@
+#ifndef SAMPLE_FILTER_H
+#define SAMPLE_FILTER_H
+
+// Sample Filter --------------------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.19
+//
+// Description: Configurable digital filter for the raw samples of an analog input, applied before the sample is mapped to a
+//   value. The following filters are available:
+//   - Biquad: 2nd-order IIR (direct form II transposed). Cheapest for a given amount of smoothing, but rings on steps
+//     depending on its coefficients.
+//   - Median: Moving median of the most recent N samples. Removes isolated spikes entirely, without smearing steps.
+//   - FIR: Fixed-point (Q15) FIR of up to 8 taps. Linear phase if the taps are symmetric.
+//
+//   Every filter adds lag, quantified by its group delay (at DC), in samples. This is calculated upon initialization, such
+//   that the lag of a configuration can be checked before driving. An invalid configuration falls back to no filtering.
+//
+//   The filter's state is primed using the first sample, such that the output doesn't ramp up from 0 upon startup (which
+//   would appear as an out-of-range sample).
+//
+//   This module is independent of ChibiOS, allowing it to be benchmarked on a host (see
+//   tools/sample_filter/sample_filter_bench.c).
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// C Standard Library
+#include <stdbool.h>
+#include <stdint.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The maximum number of taps of an FIR filter.
+#define SAMPLE_FILTER_TAP_COUNT_MAX 8
+
+/// @brief The maximum window length of a median filter.
+#define SAMPLE_FILTER_WINDOW_MAX 9
+
+/// @brief The number of samples of history kept by a filter.
+#define SAMPLE_FILTER_HISTORY_SIZE SAMPLE_FILTER_WINDOW_MAX
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef enum
+{
+	/// @brief No filtering, samples are passed through.
+	SAMPLE_FILTER_NONE = 0,
+
+	/// @brief 2nd-order IIR filter. y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2]. The poles must lie
+	/// inside the unit circle and the DC gain must not be 0.
+	SAMPLE_FILTER_BIQUAD = 1,
+
+	/// @brief Moving median. The window length must be odd.
+	SAMPLE_FILTER_MEDIAN = 2,
+
+	/// @brief Fixed-point FIR filter. y[n] = sum (h[k] x[n-k]) / 32768. The taps must sum to a positive value, unity gain
+	/// being a sum of 32768.
+	SAMPLE_FILTER_FIR = 3
+} sampleFilterType_t;
+
+typedef struct
+{
+	/// @brief The type of the filter, see @c sampleFilterType_t .
+	uint8_t type;
+	/// @brief The window length of a median filter, or the number of taps of an FIR filter.
+	uint8_t length;
+	uint8_t pad0 [2];
+	/// @brief The coefficients of a biquad filter, in the order b0, b1, b2, a1, a2 (a0 being 1).
+	float coefficients [5];
+	/// @brief The taps of an FIR filter, in Q15 format.
+	int16_t taps [SAMPLE_FILTER_TAP_COUNT_MAX];
+} sampleFilterConfig_t;
+
+typedef struct
+{
+	/// @brief The type of the filter, @c SAMPLE_FILTER_NONE if the configuration is invalid.
+	sampleFilterType_t type;
+	/// @brief Copy of the validated configuration. The source may be modified at any time (ex. by an overlay write), so
+	/// only this copy is used after initialization.
+	sampleFilterConfig_t config;
+
+	/// @brief The state of a biquad filter.
+	float state [2];
+	/// @brief The most recent samples, as a circular buffer.
+	uint16_t history [SAMPLE_FILTER_HISTORY_SIZE];
+	/// @brief The index of the most recent sample in @c history .
+	uint8_t historyIndex;
+	/// @brief Indicates the filter's state has been primed by a sample.
+	bool primed;
+
+	/// @brief The group delay of the filter at DC, in samples.
+	float groupDelay;
+} sampleFilter_t;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Initializes a filter, validating its configuration and calculating its group delay.
+ * @param filter The filter to initialize.
+ * @param config The configuration to use. This is copied, so need not remain in scope.
+ * @return True if successful, false if the configuration is invalid (in which case samples are passed through unfiltered).
+ */
+bool sampleFilterInit (sampleFilter_t* filter, const sampleFilterConfig_t* config);
+
+/**
+ * @brief Passes a sample through a filter.
+ * @param filter The filter to update.
+ * @param sample The sample to filter.
+ * @return The filtered sample.
+ */
+uint16_t sampleFilterUpdate (sampleFilter_t* filter, uint16_t sample);
+
+#endif // SAMPLE_FILTER_H
\ No newline at end of file
@@ -0,0 +1,93 @@
+// Header
+#include "sensor_health.h"
+
+// Function Prototypes --------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Resets the statistics of the window, keeping the previous sample.
+ */
+static void resetWindow (sensorHealth_t* health);
+
+/**
+ * @brief Increments a counter, saturating at its maximum.
+ */
+static inline void incrementSaturated (uint16_t* counter);
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+void sensorHealthInit (sensorHealth_t* health)
+{
+	health->previous = 0;
+	health->previousValid = false;
+	resetWindow (health);
+}
+
+void sensorHealthUpdate (sensorHealth_t* health, uint16_t sample, bool inRange, uint16_t rateLimit)
+{
+	if (!inRange)
+	{
+		incrementSaturated (&health->outOfRangeCount);
+		return;
+	}
+
+	if (rateLimit != 0 && health->previousValid)
+	{
+		uint16_t difference = sample > health->previous ? sample - health->previous : health->previous - sample;
+		if (difference > rateLimit)
+			incrementSaturated (&health->rateViolationCount);
+	}
+
+	health->previous = sample;
+	health->previousValid = true;
+
+	// Welford's update: the deviation from the old mean, multiplied by the deviation from the new mean, is the sample's
+	// contribution to the sum of squared differences.
+	++health->count;
+	float delta = sample - health->mean;
+	health->mean += delta / health->count;
+	health->m2 += delta * (sample - health->mean);
+
+	if (sample < health->min)
+		health->min = sample;
+	if (sample > health->max)
+		health->max = sample;
+}
+
+void sensorHealthTakeStats (sensorHealth_t* health, sensorHealthStats_t* stats)
+{
+	stats->count				= health->count;
+	stats->outOfRangeCount		= health->outOfRangeCount;
+	stats->rateViolationCount	= health->rateViolationCount;
+
+	if (health->count == 0)
+	{
+		stats->mean			= 0.0f;
+		stats->variance		= 0.0f;
+		stats->peakToPeak	= 0;
+	}
+	else
+	{
+		stats->mean			= health->mean;
+		stats->variance		= health->m2 / health->count;
+		stats->peakToPeak	= health->max - health->min;
+	}
+
+	resetWindow (health);
+}
+
+void resetWindow (sensorHealth_t* health)
+{
+	health->count				= 0;
+	health->mean				= 0.0f;
+	health->m2					= 0.0f;
+	health->min					= UINT16_MAX;
+	health->max					= 0;
+	health->outOfRangeCount		= 0;
+	health->rateViolationCount	= 0;
+}
+
+void incrementSaturated (uint16_t* counter)
+{
+	if (*counter != UINT16_MAX)
+		++*counter;
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+#ifndef SENSOR_HEALTH_H
+#define SENSOR_HEALTH_H
+
+// Sensor Health Monitor ------------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.19
+//
+// Description: Streaming statistics of a sensor's samples, used to spot a degrading sensor or connector before it causes a
+//   plausibility fault. Over a window of samples, the following are tracked:
+//   - The mean and variance of the in-range samples. These are updated incrementally using Welford's algorithm, which is
+//     constant-time per sample and (unlike accumulating the sum of squares) doesn't lose precision when the variance is
+//     small relative to the mean, as is the case for sensor noise.
+//   - The peak-to-peak range of the in-range samples.
+//   - The number of out-of-range samples. These are excluded from the other statistics, as a single open-circuit sample would
+//     otherwise dominate them.
+//   - The number of rate-of-change violations, that being consecutive samples differing by more than a limit. A sensor can
+//     only move so fast, so a larger step indicates an intermittent connection.
+//
+//   The window is ended by reading the statistics, at which point they are reset. The previous sample is kept, such that the
+//   rate-of-change check spans windows.
+//
+//   Note the variance includes any actual movement of the sensor over the window. It only measures noise while the sensor is
+//   stationary (for instance, with the pedals released).
+//
+//   This module is independent of ChibiOS.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// C Standard Library
+#include <stdbool.h>
+#include <stdint.h>
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef struct
+{
+	/// @brief The number of in-range samples in the window.
+	uint32_t count;
+	/// @brief The running mean of the in-range samples.
+	float mean;
+	/// @brief The running sum of squared differences from the mean (the variance multiplied by the count).
+	float m2;
+	/// @brief The smallest in-range sample in the window.
+	uint16_t min;
+	/// @brief The largest in-range sample in the window.
+	uint16_t max;
+	/// @brief The number of out-of-range samples in the window.
+	uint16_t outOfRangeCount;
+	/// @brief The number of rate-of-change violations in the window.
+	uint16_t rateViolationCount;
+	/// @brief The most recent in-range sample.
+	uint16_t previous;
+	/// @brief Indicates @c previous is valid (an in-range sample has been received).
+	bool previousValid;
+} sensorHealth_t;
+
+typedef struct
+{
+	/// @brief The number of in-range samples in the window.
+	uint32_t count;
+	/// @brief The mean of the in-range samples, 0 if there were none.
+	float mean;
+	/// @brief The (population) variance of the in-range samples, 0 if there were none.
+	float variance;
+	/// @brief The peak-to-peak range of the in-range samples, 0 if there were none.
+	uint16_t peakToPeak;
+	/// @brief The number of out-of-range samples in the window.
+	uint16_t outOfRangeCount;
+	/// @brief The number of rate-of-change violations in the window.
+	uint16_t rateViolationCount;
+} sensorHealthStats_t;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Initializes a health monitor, starting its first window.
+ * @param health The monitor to initialize.
+ */
+void sensorHealthInit (sensorHealth_t* health);
+
+/**
+ * @brief Updates a health monitor with a new sample.
+ * @param health The monitor to update.
+ * @param sample The sample.
+ * @param inRange Indicates whether the sample is within the sensor's valid range.
+ * @param rateLimit The maximum difference between consecutive in-range samples. 0 disables the check.
+ */
+void sensorHealthUpdate (sensorHealth_t* health, uint16_t sample, bool inRange, uint16_t rateLimit);
+
+/**
+ * @brief Gets the statistics of the current window, then starts a new window.
+ * @param health The monitor to read.
+ * @param stats Written to contain the statistics.
+ */
+void sensorHealthTakeStats (sensorHealth_t* health, sensorHealthStats_t* stats);
+
+#endif // SENSOR_HEALTH_H
\ No newline at end of file
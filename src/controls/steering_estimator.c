@@ -0,0 +1,91 @@
+// Header
+#include "steering_estimator.h"
+
+// C Standard Library
+#include <math.h>
+
+// Global Data ----------------------------------------------------------------------------------------------------------------
+
+steeringEstimate_t steeringEstimate =
+{
+	.valid = false
+};
+
+/// @brief Copy of the validated configuration. The source may be modified at any time (ex. by an overlay write), so only this
+/// copy is used.
+static steeringEstimatorConfig_t config;
+
+/// @brief Indicates whether the observer is enabled (the configuration is valid).
+static bool enabled = false;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+bool steeringEstimatorReconfigure (const steeringEstimatorConfig_t* newConfig)
+{
+	// Validate a copy of the configuration, such that it can't change after being validated.
+	steeringEstimatorConfig_t copy = *newConfig;
+	bool valid =
+		isfinite (copy.alpha) && isfinite (copy.beta) && isfinite (copy.latency) &&
+		copy.alpha > 0.0f && copy.alpha <= 1.0f &&
+		copy.beta >= 0.0f && 2.0f * copy.alpha + copy.beta < 4.0f &&
+		copy.latency >= 0.0f;
+
+	// Apply the configuration atomically, as the estimate is updated by another thread.
+	chSysLock ();
+	config = copy;
+	enabled = valid;
+	steeringEstimate.valid = false;
+	chSysUnlock ();
+
+	return valid;
+}
+
+void steeringEstimatorUpdate (systime_t sampleTime, systime_t timeCurrent, float angle, bool valid)
+{
+	steeringEstimate_t* estimate = &steeringEstimate;
+
+	if (!valid)
+	{
+		// Reset upon an invalid sample, the next valid sample re-initializes the estimate.
+		estimate->valid = false;
+		estimate->angle = angle;
+		estimate->rate = 0.0f;
+		estimate->anglePredicted = angle;
+		return;
+	}
+
+	if (!enabled || !estimate->valid)
+	{
+		estimate->angle = angle;
+		estimate->rate = 0.0f;
+	}
+	else
+	{
+		// Only correct upon a new sample.
+		float dt = TIME_I2US (chTimeDiffX (estimate->sampleTime, sampleTime)) / 1000000.0f;
+		if (dt > 0.0f)
+		{
+			float residual = angle - (estimate->angle + estimate->rate * dt);
+			estimate->angle += estimate->rate * dt + config.alpha * residual;
+			estimate->rate += config.beta / dt * residual;
+		}
+	}
+
+	estimate->valid = true;
+	estimate->sampleTime = sampleTime;
+
+	if (!enabled)
+	{
+		estimate->anglePredicted = angle;
+		return;
+	}
+
+	// Extrapolate from the sample to the present, plus the latency. The sample may be timestamped after the start of the
+	// control cycle.
+	int32_t ageTicks = (int32_t) (timeCurrent - sampleTime);
+	if (ageTicks < 0)
+		ageTicks = 0;
+	float horizon = TIME_I2US (ageTicks) / 1000000.0f + config.latency;
+
+	estimate->anglePredicted = estimate->angle + estimate->rate * horizon;
+}
\ No newline at end of file
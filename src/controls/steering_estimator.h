@@ -0,0 +1,79 @@
+#ifndef STEERING_ESTIMATOR_H
+#define STEERING_ESTIMATOR_H
+
+// Steering Angle Estimator ---------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.19
+//
+// Description: Estimates the steering angle and rate from the samples of the steering-angle sensor, and predicts the angle
+//   ahead of the present to compensate for latency. The sensor is read over I2C, so each sample is already old by the time
+//   the torque-vectoring algorithm acts on it, and the torque request takes further time to take effect. During fast
+//   direction changes (for instance, a slalom) this lag is significant.
+//
+//   The estimator is a fixed-gain alpha-beta observer (a steady-state Kalman filter for a constant-rate model). Upon each
+//   sample, the angle is predicted from the previous estimate using the time elapsed between the samples' timestamps, then
+//   corrected by the residual:
+//     angle = angle + rate * dt + alpha * residual
+//     rate = rate + beta / dt * residual
+//   The predicted angle extrapolates the estimate from the sample's timestamp to the present, plus the configured latency.
+//
+//   The gains must satisfy 0 < alpha <= 1, 0 <= beta and 2 * alpha + beta < 4 for the observer to be stable. An invalid
+//   configuration disables the observer, such that the angle and predicted angle are the measurement and the rate is 0. Any
+//   invalid sample resets the observer.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// ChibiOS
+#include "ch.h"
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef struct
+{
+	/// @brief The gain of the angle correction.
+	float alpha;
+	/// @brief The gain of the rate correction.
+	float beta;
+	/// @brief The latency to compensate for, beyond the age of the sample, in seconds.
+	float latency;
+} steeringEstimatorConfig_t;
+
+typedef struct
+{
+	/// @brief The estimated angle at the time of the most recent sample, in radians.
+	float angle;
+	/// @brief The estimated rate of change of the angle, in radians per second.
+	float rate;
+	/// @brief The predicted angle, compensated for the age of the sample and the configured latency, in radians.
+	float anglePredicted;
+	/// @brief Indicates whether the estimate is valid (the most recent sample was valid).
+	bool valid;
+	/// @brief The timestamp of the most recent sample.
+	systime_t sampleTime;
+} steeringEstimate_t;
+
+// Global Data ----------------------------------------------------------------------------------------------------------------
+
+/// @brief The estimate of the steering angle.
+extern steeringEstimate_t steeringEstimate;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Updates the configuration of the estimator, resetting the estimate.
+ * @param config The configuration to use. This is copied, so need not remain in scope.
+ * @return True if the configuration is valid, false otherwise (in which case the observer is disabled).
+ */
+bool steeringEstimatorReconfigure (const steeringEstimatorConfig_t* config);
+
+/**
+ * @brief Updates the estimate. Should be called once per control cycle, after the sensor has been sampled.
+ * @param sampleTime The timestamp of the sample.
+ * @param timeCurrent The time of the current control cycle.
+ * @param angle The sampled angle, in radians.
+ * @param valid Indicates whether the sample is valid.
+ */
+void steeringEstimatorUpdate (systime_t sampleTime, systime_t timeCurrent, float angle, bool valid);
+
+#endif // STEERING_ESTIMATOR_H
\ No newline at end of file
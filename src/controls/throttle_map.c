@@ -0,0 +1,94 @@
+// Header
+#include "throttle_map.h"
+
+// Function Prototypes --------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Validates the curve of a throttle map's configuration.
+ * @return True if the curve is valid, false otherwise.
+ */
+static bool validate (const throttleMapConfig_t* config);
+
+/**
+ * @brief Evaluates a curve by searching for the segment containing the input. Only used to build the lookup table.
+ */
+static float curveEvaluate (const throttleMapConfig_t* config, float input);
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+bool throttleMapInit (throttleMap_t* map, const throttleMapConfig_t* config)
+{
+	// An empty curve explicitly selects the linear map.
+	bool linear = config->pointCount == 0;
+	bool result = linear || validate (config);
+
+	for (uint16_t index = 0; index <= THROTTLE_MAP_LUT_INTERVALS; ++index)
+	{
+		float input = (float) index / THROTTLE_MAP_LUT_INTERVALS;
+		map->lut [index] = (result && !linear) ? curveEvaluate (config, input) : input;
+	}
+
+	return result;
+}
+
+float throttleMapEvaluate (const throttleMap_t* map, float request)
+{
+	// A released pedal never requests torque, regardless of the curve. Note the negated comparison also saturates NaN to 0.
+	if (!(request > 0.0f))
+		return 0.0f;
+	if (request >= 1.0f)
+		return map->lut [THROTTLE_MAP_LUT_INTERVALS];
+
+	float position = request * THROTTLE_MAP_LUT_INTERVALS;
+	uint16_t index = (uint16_t) position;
+	if (index >= THROTTLE_MAP_LUT_INTERVALS)
+		index = THROTTLE_MAP_LUT_INTERVALS - 1;
+
+	float fraction = position - index;
+	return map->lut [index] + (map->lut [index + 1] - map->lut [index]) * fraction;
+}
+
+bool validate (const throttleMapConfig_t* config)
+{
+	if (config->pointCount < 2 || config->pointCount > THROTTLE_MAP_POINT_COUNT_MAX)
+		return false;
+
+	// The curve saturates at its first point, so this is its output at a released pedal, which must not request torque.
+	if (config->outputs [0] != 0.0f)
+		return false;
+
+	for (uint8_t index = 0; index < config->pointCount; ++index)
+	{
+		float input = config->inputs [index];
+		float output = config->outputs [index];
+
+		// Note the negated comparisons also reject NaN.
+		if (!(input >= 0.0f && input <= 1.0f && output >= 0.0f && output <= 1.0f))
+			return false;
+
+		if (index > 0 && (input <= config->inputs [index - 1] || output < config->outputs [index - 1]))
+			return false;
+	}
+
+	return true;
+}
+
+float curveEvaluate (const throttleMapConfig_t* config, float input)
+{
+	uint8_t last = config->pointCount - 1;
+
+	if (input <= config->inputs [0])
+		return config->outputs [0];
+	if (input >= config->inputs [last])
+		return config->outputs [last];
+
+	uint8_t index = 1;
+	while (config->inputs [index] < input)
+		++index;
+
+	float x0 = config->inputs [index - 1];
+	float y0 = config->outputs [index - 1];
+	float x1 = config->inputs [index];
+	float y1 = config->outputs [index];
+	return y0 + (y1 - y0) * (input - x0) / (x1 - x0);
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+#ifndef THROTTLE_MAP_H
+#define THROTTLE_MAP_H
+
+// Throttle Map ---------------------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.19
+//
+// Description: Maps the throttle request (the fraction of pedal travel) to the fraction of the driving torque limit to
+//   request. The response is defined by a curve of up to 8 points, allowing for progressive maps or a softened tip-in, which
+//   differ by event. The curve is piecewise-linear between its points, and saturates at its first and last points.
+//
+//   Searching the curve for the segment containing a request would cost a variable amount of time in the control loop, so the
+//   curve is instead expanded into a lookup table upon initialization. The table is sampled on a uniform grid over the range
+//   of requests, such that evaluating the map is a single indexed interpolation. The table's interpolation cuts across any
+//   point of the curve not lying on the grid, deviating from the curve by at most a quarter of the grid's spacing (1/64)
+//   multiplied by the change in slope at that point.
+//
+//   The curve must be monotonic: the inputs strictly increasing, and the outputs non-decreasing (a larger request must never
+//   request less torque). Both must lie in the range [0, 1]. The first output must be 0, such that a released pedal never
+//   requests torque (a deadband is configured by the first input instead). An invalid curve falls back to the linear map
+//   (the output being the request).
+//
+//   This module is independent of ChibiOS.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// C Standard Library
+#include <stdbool.h>
+#include <stdint.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The maximum number of points in a curve.
+#define THROTTLE_MAP_POINT_COUNT_MAX 8
+
+/// @brief The number of intervals of the lookup table's grid.
+#define THROTTLE_MAP_LUT_INTERVALS 64
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef struct
+{
+	/// @brief The number of points in the curve. 0 selects the linear map.
+	uint8_t pointCount;
+	uint8_t pad0 [3];
+	/// @brief The throttle requests of the curve's points, as fractions of pedal travel.
+	float inputs [THROTTLE_MAP_POINT_COUNT_MAX];
+	/// @brief The outputs of the curve's points, as fractions of the driving torque limit.
+	float outputs [THROTTLE_MAP_POINT_COUNT_MAX];
+} throttleMapConfig_t;
+
+typedef struct
+{
+	/// @brief The outputs of the map at each point of the grid, the Nth point being at a request of
+	/// N / @c THROTTLE_MAP_LUT_INTERVALS .
+	float lut [THROTTLE_MAP_LUT_INTERVALS + 1];
+} throttleMap_t;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Initializes a throttle map, validating its curve and expanding it into the lookup table.
+ * @param map The map to initialize.
+ * @param config The configuration to use. Need not remain in scope.
+ * @return True if successful, false if the curve is invalid (in which case the linear map is used).
+ */
+bool throttleMapInit (throttleMap_t* map, const throttleMapConfig_t* config);
+
+/**
+ * @brief Evaluates a throttle map.
+ * @param map The map to evaluate.
+ * @param request The throttle request, as a fraction of pedal travel. Saturated to the range [0, 1].
+ * @return The fraction of the driving torque limit to request. Always 0 for a request of 0 or less (including NaN).
+ */
+float throttleMapEvaluate (const throttleMap_t* map, float request);
+
+#endif // THROTTLE_MAP_H
\ No newline at end of file
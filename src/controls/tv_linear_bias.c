@@ -4,28 +4,30 @@
 // Includes
 #include "peripherals.h"
 #include "controls/lerp.h"
-#include "can.h"
+#include "controls/amk_estimator.h"
+#include "controls/steering_estimator.h"
 
 tvOutput_t tvLinearBias (const tvInput_t* input, const void* configPointer)
 {
 	const tvLinearBiasConfig_t* config = configPointer;
 
 	// Lerp from beginning motor speed & bias to end motor speed & bias.
-	float motorSpeed = (amkRl.actualSpeed + amkRr.actualSpeed) / 2.0f;
+	float motorSpeed = (amkEstimateRl.speed + amkEstimateRr.speed) / 2.0f;
 	float biasRear = lerp2dSaturated (motorSpeed,
 		config->motorSpeedBiasBegin, config->frontRearBiasBegin,
 		config->motorSpeedBiasEnd, config->frontRearBiasEnd);
 	float biasFront = 1.0f - biasRear;
 
-	// Lerp from beginning angle & 50% bias to end angle & bias (for both positive and negative).
-	float steeringAngle = sas.value;
+	// Lerp from beginning angle & 50% bias to end angle & bias (for both positive and negative). The latency-compensated
+	// angle is used, which is the measured angle if the estimator isn't configured.
+	float steeringAngle = steeringEstimate.anglePredicted;
 	float biasLeft;
 	if (steeringAngle >= 0.0f)
-		biasLeft = lerp2dSaturated (sas.value,
+		biasLeft = lerp2dSaturated (steeringAngle,
 			config->steeringAngleBiasBegin, 0.5f,
 			config->steeringAngleBiasEnd, config->leftRightBiasEnd);
 	else
-		biasLeft = lerp2dSaturated (-sas.value,
+		biasLeft = lerp2dSaturated (-steeringAngle,
 			config->steeringAngleBiasBegin, 0.5f,
 			config->steeringAngleBiasEnd, 1.0f - config->leftRightBiasEnd);
 	float biasRight = 1.0f - biasLeft;
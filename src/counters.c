@@ -0,0 +1,230 @@
+// Header
+#include "counters.h"
+
+// Includes
+#include "can.h"
+#include "flash_kv.h"
+#include "state_thread.h"
+#include "controls/amk_estimator.h"
+#include "peripherals/stm_flash.h"
+
+// C Standard Library
+#include <math.h>
+#include <string.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The first of the two flash sectors used by the store.
+#define FLASH_SECTOR_BASE 10
+
+_Static_assert (FLASH_SECTOR_BASE >= 8 && FLASH_SECTOR_BASE + 1 <= 11, "Store must be within the reserved flash sectors.");
+
+/// @brief The key of the counters record in the store.
+#define COUNTERS_KEY 0
+
+/// @brief The free space below which the store is compacted, if the vehicle is in the low-voltage state.
+#define COMPACT_THRESHOLD (STM_FLASH_SECTOR_SIZE / 4)
+
+/// @brief The speed above which a motor is considered to be spinning, in RPM.
+#define MOTOR_RUNNING_SPEED 10.0f
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The fractional parts of the fixed-point counters, carried between samples.
+typedef struct
+{
+	float motorRevolutions;
+	float energyConsumed;
+	float energyRegenerated;
+	float motorRunTime;
+} remainders_t;
+
+// Function Prototypes --------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Erase function of the flash store, maps the store's sectors to the flash's.
+ */
+static bool flashErase (void* object, uint8_t sector);
+
+/**
+ * @brief Program function of the flash store.
+ */
+static bool flashProgram (void* object, uint32_t* addr, const uint32_t* data, uint32_t count);
+
+/**
+ * @brief Accumulates the counters over a single sample period.
+ * @param accumulator The counters to update.
+ * @param remainders The fractional parts of the counters to update.
+ * @param period The length of the sample period, in seconds.
+ */
+static void accumulate (counters_t* accumulator, remainders_t* remainders, float period);
+
+/**
+ * @brief Adds an increment to a fixed-point counter, carrying the fractional part in the remainder.
+ * @param counter The counter to update.
+ * @param remainder The fractional part of the counter, in the counter's units.
+ * @param increment The amount to add, in the counter's units.
+ */
+static void accumulateFixed (uint64_t* counter, float* remainder, float increment);
+
+/**
+ * @brief Writes the counters to the store, compacting it if needed and permitted.
+ * @return True if successful, false otherwise.
+ */
+static bool save (const counters_t* accumulator);
+
+// Global Data ----------------------------------------------------------------------------------------------------------------
+
+counters_t counters;
+
+/// @brief The flash store holding the counters.
+static flashKv_t store;
+
+/// @brief Indicates whether the store was mounted successfully.
+static bool storeMounted = false;
+
+static const flashKvConfig_t STORE_CONFIG =
+{
+	.sectors		= { STM_FLASH_SECTOR_ADDR (FLASH_SECTOR_BASE), STM_FLASH_SECTOR_ADDR (FLASH_SECTOR_BASE + 1) },
+	.sectorSize		= STM_FLASH_SECTOR_SIZE,
+	.erase			= flashErase,
+	.program		= flashProgram,
+	.object			= NULL
+};
+
+// Thread Entrypoint ----------------------------------------------------------------------------------------------------------
+
+static THD_WORKING_AREA (countersThreadWa, 512);
+THD_FUNCTION (countersThread, arg)
+{
+	(void) arg;
+	chRegSetThreadName ("counters");
+
+	counters_t accumulator = counters;
+	counters_t saved = counters;
+	remainders_t remainders = { 0 };
+	bool failedPrevious = false;
+
+	systime_t timePrevious = chVTGetSystemTime ();
+	systime_t timeSave = timePrevious;
+	while (true)
+	{
+		systime_t timeCurrent = chVTGetSystemTime ();
+
+		accumulate (&accumulator, &remainders, TIME_I2US (chTimeDiffX (timePrevious, timeCurrent)) / 1000000.0f);
+
+		// Count each entry into the failed state. Faults are saved immediately, as they may precede a power loss.
+		bool failed = vehicleState == VEHICLE_STATE_FAILED;
+		bool saveNow = failed && !failedPrevious;
+		if (saveNow)
+			++accumulator.faultCount;
+		failedPrevious = failed;
+
+		chSysLock ();
+		counters = accumulator;
+		chSysUnlock ();
+
+		// Only write the store if the counters have changed.
+		if ((saveNow || chTimeDiffX (timeSave, timeCurrent) >= COUNTERS_SAVE_PERIOD) &&
+			memcmp (&accumulator, &saved, sizeof (counters_t)) != 0)
+		{
+			timeSave = timeCurrent;
+			if (save (&accumulator))
+				saved = accumulator;
+		}
+
+		// Sleep until the next sample
+		timePrevious = timeCurrent;
+		systime_t timeNext = chTimeAddX (timeCurrent, COUNTERS_SAMPLE_PERIOD);
+		chThdSleepUntilWindowed (timeCurrent, timeNext);
+	}
+}
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+bool countersInit (void)
+{
+	memset (&counters, 0, sizeof (counters));
+
+	storeMounted = flashKvInit (&store, &STORE_CONFIG);
+	if (storeMounted)
+		flashKvRead (&store, COUNTERS_KEY, &counters, sizeof (counters));
+
+	return storeMounted;
+}
+
+void countersStart (tprio_t priority)
+{
+	chThdCreateStatic (&countersThreadWa, sizeof (countersThreadWa), priority, countersThread, NULL);
+}
+
+bool flashErase (void* object, uint8_t sector)
+{
+	(void) object;
+	return stmFlashErase (FLASH_SECTOR_BASE + sector);
+}
+
+bool flashProgram (void* object, uint32_t* addr, const uint32_t* data, uint32_t count)
+{
+	(void) object;
+	return stmFlashProgram (addr, data, count);
+}
+
+void accumulate (counters_t* accumulator, remainders_t* remainders, float period)
+{
+	float speed = 0.0f;
+	float power = 0.0f;
+	uint8_t validCount = 0;
+	bool running = false;
+
+	for (uint8_t index = 0; index < AMK_COUNT; ++index)
+	{
+		if (!amkGetValidityLock (&amks [index]))
+			continue;
+
+		float motorSpeed = fabsf (amkEstimates [index].speed);
+		speed += motorSpeed;
+		power += amkEstimates [index].power;
+		running |= motorSpeed > MOTOR_RUNNING_SPEED;
+		++validCount;
+	}
+
+	// Revolutions in thousandths, energy in mWh, time in ms.
+	if (validCount != 0)
+		accumulateFixed (&accumulator->motorRevolutions, &remainders->motorRevolutions,
+			speed / validCount / 60.0f * period * 1000.0f);
+
+	if (power > 0.0f)
+		accumulateFixed (&accumulator->energyConsumed, &remainders->energyConsumed, power * period / 3.6f);
+	else
+		accumulateFixed (&accumulator->energyRegenerated, &remainders->energyRegenerated, -power * period / 3.6f);
+
+	if (running)
+		accumulateFixed (&accumulator->motorRunTime, &remainders->motorRunTime, period * 1000.0f);
+
+	if (temperatureInverterMax > accumulator->temperatureInverterPeak)
+		accumulator->temperatureInverterPeak = temperatureInverterMax;
+
+	if (temperatureMotorMax > accumulator->temperatureMotorPeak)
+		accumulator->temperatureMotorPeak = temperatureMotorMax;
+}
+
+void accumulateFixed (uint64_t* counter, float* remainder, float increment)
+{
+	*remainder += increment;
+	float whole = floorf (*remainder);
+	*remainder -= whole;
+	*counter += (uint64_t) whole;
+}
+
+bool save (const counters_t* accumulator)
+{
+	if (!storeMounted)
+		return false;
+
+	// Compaction stalls the CPU, so is only done while the vehicle is de-energized.
+	if (flashKvGetFree (&store) < COMPACT_THRESHOLD && vehicleState == VEHICLE_STATE_LOW_VOLTAGE)
+		flashKvCompact (&store);
+
+	return flashKvWrite (&store, COUNTERS_KEY, accumulator, sizeof (counters_t));
+}
\ No newline at end of file
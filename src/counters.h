@@ -0,0 +1,78 @@
+#ifndef COUNTERS_H
+#define COUNTERS_H
+
+// Persistent Counters --------------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.19
+//
+// Description: Lifetime counters of the vehicle (odometer, energy, run time, faults, peak temperatures), persisted across
+//   power cycles. These change far too frequently for the I2C EEPROM, so are instead stored in a log-structured key-value
+//   store in the internal flash (see @c flash_kv.h ), using sectors 10 & 11.
+//
+//   The counters are accumulated in RAM and written to the store periodically, as a single record (so all counters are
+//   updated atomically). A power loss therefore loses at most one save period of accumulation. Compacting the store requires
+//   erasing a sector, which stalls the CPU for 1 to 2 s, so is only done while the vehicle is in the low-voltage state. For
+//   the same reason, the store is mounted (and formatted, if need be) prior to starting the control threads.
+//
+//   Cumulative counters are stored in 64-bit fixed-point, as a float stops accumulating once the increment of a single sample
+//   falls below its resolution (ex. the run time would saturate at 2^18 s when incremented by 10 ms). The fractional part of
+//   each sample is carried to the next, rather than being discarded.
+//
+//   The counters are readable through the read-only region of the virtual EEPROM, see @c eeprom_map.h .
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// ChibiOS
+#include "ch.h"
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The period at which the counters are accumulated.
+#define COUNTERS_SAMPLE_PERIOD TIME_MS2I (10)
+
+/// @brief The period at which the counters are written to the flash, if they have changed.
+#define COUNTERS_SAVE_PERIOD TIME_S2I (30)
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef struct
+{
+	/// @brief The cumulative revolutions of the motors (averaged across the valid inverters), in thousandths of a revolution.
+	/// The distance travelled is this, divided by the gear ratio, multiplied by the wheel circumference.
+	uint64_t motorRevolutions;
+	/// @brief The cumulative energy consumed by the inverters, in mWh.
+	uint64_t energyConsumed;
+	/// @brief The cumulative energy regenerated by the inverters, in mWh.
+	uint64_t energyRegenerated;
+	/// @brief The cumulative time any motor has been spinning, in milliseconds.
+	uint64_t motorRunTime;
+	/// @brief The number of times the vehicle has entered the failed state.
+	uint32_t faultCount;
+	/// @brief The peak inverter temperature recorded, in C.
+	float temperatureInverterPeak;
+	/// @brief The peak motor temperature recorded, in C.
+	float temperatureMotorPeak;
+} counters_t;
+
+// Global Data ----------------------------------------------------------------------------------------------------------------
+
+/// @brief The current value of the counters.
+extern counters_t counters;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Mounts the counters' flash store, loading the counters. If the store has not been formatted, this erases a sector,
+ * so must be called prior to starting any time-critical threads.
+ * @return False if the flash store could not be mounted, true otherwise. The counters start from 0 if the store failed.
+ */
+bool countersInit (void);
+
+/**
+ * @brief Starts the counters thread. Must be called after @c countersInit and @c canInterfaceInit .
+ * @param priority The priority to start the thread at.
+ */
+void countersStart (tprio_t priority);
+
+#endif // COUNTERS_H
\ No newline at end of file
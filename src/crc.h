@@ -0,0 +1,46 @@
+#ifndef CRC_H
+#define CRC_H
+
+// CRC-32 ---------------------------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.19
+//
+// Description: Standard (IEEE 802.3) CRC-32, matching Python's zlib.crc32 & binascii.crc32. The calculation is done a nibble at
+//   a time using a 16-entry table, trading some speed for flash.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// C Standard Library
+#include <stddef.h>
+#include <stdint.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The initial value to pass to @c crc32Update .
+#define CRC32_INITIAL 0x00000000
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Updates a running CRC with a block of data. The CRC of a buffer split into multiple blocks is the same as that of the
+ * whole buffer.
+ * @param crc The CRC of the preceding data, @c CRC32_INITIAL if there is none.
+ * @param data The data to update with.
+ * @param size The size of @c data , in bytes.
+ * @return The updated CRC.
+ */
+uint32_t crc32Update (uint32_t crc, const void* data, size_t size);
+
+/**
+ * @brief Calculates the CRC of a block of data.
+ * @param data The data to calculate the CRC of.
+ * @param size The size of @c data , in bytes.
+ * @return The calculated CRC.
+ */
+static inline uint32_t crc32Calculate (const void* data, size_t size)
+{
+	return crc32Update (CRC32_INITIAL, data, size);
+}
+
+#endif // CRC_H
\ No newline at end of file
@@ -0,0 +1,247 @@
+// Header
+#include "flash_kv.h"
+
+// Includes
+#include "crc.h"
+
+// C Standard Library
+#include <string.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief Value of the first word of a valid sector.
+#define SECTOR_MAGIC 0x4B56534D
+
+/// @brief The size of the sector header, in words.
+#define SECTOR_HEADER_SIZE 2
+
+/// @brief Value of an erased word.
+#define WORD_ERASED 0xFFFFFFFF
+
+/// @brief The size of a record's overhead (header & CRC), in words.
+#define RECORD_OVERHEAD 2
+
+// Macros ---------------------------------------------------------------------------------------------------------------------
+
+#define RECORD_HEADER(key, length)	((uint32_t) (key) | ((uint32_t) (length) << 16))
+#define RECORD_KEY(header)			((uint16_t) ((header) & 0xFFFF))
+#define RECORD_LENGTH(header)		((uint16_t) ((header) >> 16))
+
+/// @brief The size of a value, in words.
+#define DATA_WORDS(length)			(((uint32_t) (length) + 3) / 4)
+
+// Function Prototypes --------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Checks whether a sector has a valid header.
+ * @param sequence Written to contain the sector's sequence number, if valid.
+ */
+static bool sectorIsValid (flashKv_t* kv, uint8_t sector, uint32_t* sequence);
+
+/**
+ * @brief Checks whether a sector is entirely erased.
+ */
+static bool sectorIsErased (flashKv_t* kv, uint8_t sector);
+
+/**
+ * @brief Erases a sector, then writes its header, making it the active sector.
+ */
+static bool sectorFormat (flashKv_t* kv, uint8_t sector, uint32_t sequence);
+
+/**
+ * @brief Scans the active sector, building the index and locating the end of the log.
+ */
+static void sectorScan (flashKv_t* kv);
+
+/**
+ * @brief Appends a record to a sector.
+ * @param head The word offset to append at, incremented past the record if successful.
+ */
+static bool recordAppend (flashKv_t* kv, uint8_t sector, uint32_t* head, uint16_t key, const void* data, uint16_t dataCount);
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+bool flashKvInit (flashKv_t* kv, const flashKvConfig_t* config)
+{
+	kv->config = config;
+
+	uint32_t sequences [2];
+	bool valid [2] =
+	{
+		sectorIsValid (kv, 0, &sequences [0]),
+		sectorIsValid (kv, 1, &sequences [1])
+	};
+
+	// Neither sector is valid, format the first.
+	if (!valid [0] && !valid [1])
+		return sectorFormat (kv, 0, 0);
+
+	// Select the newest valid sector.
+	if (valid [0] && valid [1])
+		kv->sector = (int32_t) (sequences [1] - sequences [0]) > 0 ? 1 : 0;
+	else
+		kv->sector = valid [0] ? 0 : 1;
+
+	kv->sequence = sequences [kv->sector];
+	sectorScan (kv);
+
+	// Discard the other sector, either superseded or an interrupted compaction. Erasing is skipped when possible, as it is
+	// slow.
+	uint8_t other = kv->sector ^ 1;
+	if (!sectorIsErased (kv, other))
+		kv->config->erase (kv->config->object, other);
+
+	return true;
+}
+
+bool flashKvRead (flashKv_t* kv, uint16_t key, void* data, uint16_t dataCount)
+{
+	if (key >= FLASH_KV_KEY_COUNT || kv->index [key] == 0)
+		return false;
+
+	const uint32_t* record = kv->config->sectors [kv->sector] + kv->index [key];
+	uint16_t length = RECORD_LENGTH (record [0]);
+	memcpy (data, record + 1, length < dataCount ? length : dataCount);
+	return true;
+}
+
+bool flashKvWrite (flashKv_t* kv, uint16_t key, const void* data, uint16_t dataCount)
+{
+	if (key >= FLASH_KV_KEY_COUNT || dataCount > FLASH_KV_VALUE_SIZE_MAX)
+		return false;
+
+	uint32_t offset = kv->head;
+	if (!recordAppend (kv, kv->sector, &kv->head, key, data, dataCount))
+		return false;
+
+	kv->index [key] = offset;
+	return true;
+}
+
+bool flashKvCompact (flashKv_t* kv)
+{
+	uint8_t source = kv->sector;
+	uint8_t destination = source ^ 1;
+
+	if (!sectorIsErased (kv, destination) && !kv->config->erase (kv->config->object, destination))
+		return false;
+
+	// Copy the most recent record of each key.
+	uint32_t head = SECTOR_HEADER_SIZE;
+	uint32_t index [FLASH_KV_KEY_COUNT] = { 0 };
+	for (uint16_t key = 0; key < FLASH_KV_KEY_COUNT; ++key)
+	{
+		if (kv->index [key] == 0)
+			continue;
+
+		const uint32_t* record = kv->config->sectors [source] + kv->index [key];
+		index [key] = head;
+		if (!recordAppend (kv, destination, &head, key, record + 1, RECORD_LENGTH (record [0])))
+			return false;
+	}
+
+	// Programming the header commits the compaction.
+	uint32_t header [SECTOR_HEADER_SIZE] = { SECTOR_MAGIC, kv->sequence + 1 };
+	if (!kv->config->program (kv->config->object, kv->config->sectors [destination], header, SECTOR_HEADER_SIZE))
+		return false;
+
+	kv->sector = destination;
+	kv->sequence = header [1];
+	kv->head = head;
+	memcpy (kv->index, index, sizeof (index));
+
+	// Failing to erase the old sector is not fatal, it is re-attempted upon the next compaction or mount.
+	kv->config->erase (kv->config->object, source);
+	return true;
+}
+
+uint32_t flashKvGetFree (flashKv_t* kv)
+{
+	return kv->config->sectorSize - kv->head * sizeof (uint32_t);
+}
+
+bool sectorIsValid (flashKv_t* kv, uint8_t sector, uint32_t* sequence)
+{
+	const uint32_t* base = kv->config->sectors [sector];
+	*sequence = base [1];
+	return base [0] == SECTOR_MAGIC && base [1] != WORD_ERASED;
+}
+
+bool sectorIsErased (flashKv_t* kv, uint8_t sector)
+{
+	const uint32_t* base = kv->config->sectors [sector];
+	for (uint32_t offset = 0; offset < kv->config->sectorSize / sizeof (uint32_t); ++offset)
+		if (base [offset] != WORD_ERASED)
+			return false;
+	return true;
+}
+
+bool sectorFormat (flashKv_t* kv, uint8_t sector, uint32_t sequence)
+{
+	if (!kv->config->erase (kv->config->object, sector))
+		return false;
+
+	uint32_t header [SECTOR_HEADER_SIZE] = { SECTOR_MAGIC, sequence };
+	if (!kv->config->program (kv->config->object, kv->config->sectors [sector], header, SECTOR_HEADER_SIZE))
+		return false;
+
+	kv->sector = sector;
+	kv->sequence = sequence;
+	kv->head = SECTOR_HEADER_SIZE;
+	memset (kv->index, 0, sizeof (kv->index));
+	return true;
+}
+
+void sectorScan (flashKv_t* kv)
+{
+	const uint32_t* base = kv->config->sectors [kv->sector];
+	uint32_t size = kv->config->sectorSize / sizeof (uint32_t);
+
+	memset (kv->index, 0, sizeof (kv->index));
+
+	uint32_t offset = SECTOR_HEADER_SIZE;
+	while (offset < size && base [offset] != WORD_ERASED)
+	{
+		uint16_t key = RECORD_KEY (base [offset]);
+		uint16_t length = RECORD_LENGTH (base [offset]);
+
+		// A corrupt header leaves the remainder of the log unreadable. Nothing further is appended, such that the next
+		// compaction recovers everything before this point.
+		uint32_t words = RECORD_OVERHEAD + DATA_WORDS (length);
+		if (length > FLASH_KV_VALUE_SIZE_MAX || offset + words > size)
+		{
+			offset = size;
+			break;
+		}
+
+		// Records failing their CRC are interrupted writes, skip them.
+		uint32_t crc = crc32Calculate (base + offset, (words - 1) * sizeof (uint32_t));
+		if (crc == base [offset + words - 1] && key < FLASH_KV_KEY_COUNT)
+			kv->index [key] = offset;
+
+		offset += words;
+	}
+
+	kv->head = offset;
+}
+
+bool recordAppend (flashKv_t* kv, uint8_t sector, uint32_t* head, uint16_t key, const void* data, uint16_t dataCount)
+{
+	uint32_t words = RECORD_OVERHEAD + DATA_WORDS (dataCount);
+	if (*head + words > kv->config->sectorSize / sizeof (uint32_t))
+		return false;
+
+	// Build the record, padding the value with erased bytes.
+	uint32_t record [RECORD_OVERHEAD + DATA_WORDS (FLASH_KV_VALUE_SIZE_MAX)];
+	memset (record, 0xFF, sizeof (record));
+	record [0] = RECORD_HEADER (key, dataCount);
+	memcpy (record + 1, data, dataCount);
+	record [words - 1] = crc32Calculate (record, (words - 1) * sizeof (uint32_t));
+
+	// The header & data are programmed first, the CRC last, such that the record is only valid once complete. The head is
+	// advanced even if programming fails, as the words may be partially programmed.
+	uint32_t* addr = kv->config->sectors [sector] + *head;
+	*head += words;
+	return kv->config->program (kv->config->object, addr, record, words - 1) &&
+		kv->config->program (kv->config->object, addr + words - 1, record + words - 1, 1);
+}
\ No newline at end of file
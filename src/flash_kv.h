@@ -0,0 +1,144 @@
+#ifndef FLASH_KV_H
+#define FLASH_KV_H
+
+// Flash Key-Value Store ------------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.19
+//
+// Description: Log-structured key-value store for NOR flash, intended for values that change too frequently for the I2C
+//   EEPROM (odometer, energy counters, etc.). The store occupies two equally sized flash sectors, only one of which is active
+//   at a time. Writes are appended to the end of the active sector, such that an update costs only the words it programs and
+//   never an erase. Once the active sector is full, it is compacted: the most recent value of each key is copied into the other
+//   sector, which then becomes active. The sectors alternate, so erases are spread evenly between them.
+//
+//   Record layout (all fields are 32-bit words, as the flash is programmed a word at a time):
+//   - Header: key in the lower 16 bits, length (in bytes) in the upper 16 bits.
+//   - Data: the value, padded to a multiple of 4 bytes.
+//   - CRC: CRC-32 of the header & data, programmed last.
+//   A record is only valid once its CRC has been programmed, so an update interrupted by a power loss is discarded, leaving
+//   the previous value in place (updates are atomic). The end of the log is the first erased header word.
+//
+//   Sector layout: the first two words are the sector's header, a magic number followed by a sequence number. The header is
+//   programmed after compaction completes, so a sector without one is either erased or an interrupted compaction. Should both
+//   sectors be valid (power loss after compaction, before the old sector is erased), the higher sequence number wins.
+//
+//   Upon mounting, the active sector is scanned once to build a RAM index of the most recent record of each key, such that
+//   reads are O(1). Keys are small integers, less than @c FLASH_KV_KEY_COUNT .
+//
+//   This module is independent of ChibiOS & the STM32. The flash is accessed through the functions of @c flashKvConfig_t ,
+//   allowing the store to be run against an emulated flash on a host (see tools/flash_kv/flash_kv_bench.c). The caller is
+//   responsible for any mutual exclusion.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// C Standard Library
+#include <stdbool.h>
+#include <stdint.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The number of keys the store can hold. Valid keys are in the range [0, count).
+#define FLASH_KV_KEY_COUNT 16
+
+/// @brief The maximum length of a single value, in bytes.
+#define FLASH_KV_VALUE_SIZE_MAX 64
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Function for erasing a sector of the flash. All bytes of the sector must read 0xFF afterwards.
+ * @param object The object of the configuration.
+ * @param sector The index of the sector to erase, 0 or 1.
+ * @return True if successful, false otherwise.
+ */
+typedef bool (flashKvErase_t) (void* object, uint8_t sector);
+
+/**
+ * @brief Function for programming words of the flash. Programming can only clear bits.
+ * @param object The object of the configuration.
+ * @param addr The address to program, must be word aligned.
+ * @param data The words to program.
+ * @param count The number of words to program.
+ * @return True if successful, false otherwise.
+ */
+typedef bool (flashKvProgram_t) (void* object, uint32_t* addr, const uint32_t* data, uint32_t count);
+
+typedef struct
+{
+	/// @brief The (memory-mapped) base address of each sector.
+	uint32_t* sectors [2];
+	/// @brief The size of each sector, in bytes.
+	uint32_t sectorSize;
+	/// @brief Function for erasing a sector.
+	flashKvErase_t* erase;
+	/// @brief Function for programming words.
+	flashKvProgram_t* program;
+	/// @brief Object passed to @c erase & @c program , may be @c NULL .
+	void* object;
+} flashKvConfig_t;
+
+typedef struct
+{
+	/// @brief The configuration of the store.
+	const flashKvConfig_t* config;
+	/// @brief The index of the active sector.
+	uint8_t sector;
+	/// @brief The sequence number of the active sector.
+	uint32_t sequence;
+	/// @brief Word offset of the end of the log in the active sector.
+	uint32_t head;
+	/// @brief Word offset of the most recent record of each key, 0 if the key has not been written.
+	uint32_t index [FLASH_KV_KEY_COUNT];
+} flashKv_t;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Mounts the store, scanning the active sector to build the index. If neither sector is valid, the store is formatted.
+ * Any interrupted compaction is discarded.
+ * @param kv The store to mount.
+ * @param config The configuration to use. Must remain in scope.
+ * @return True if successful, false if the flash could not be formatted.
+ */
+bool flashKvInit (flashKv_t* kv, const flashKvConfig_t* config);
+
+/**
+ * @brief Reads the most recent value of a key.
+ * @param kv The store to read from.
+ * @param key The key to read.
+ * @param data Buffer to write the value into.
+ * @param dataCount The size of @c data . If the stored value is shorter, the remainder of the buffer is left unchanged.
+ * @return True if the key has a value, false otherwise.
+ */
+bool flashKvRead (flashKv_t* kv, uint16_t key, void* data, uint16_t dataCount);
+
+/**
+ * @brief Writes a new value to a key, appending it to the log. This never erases the flash, if there is insufficient space
+ * the write fails and the store must be compacted, see @c flashKvCompact .
+ * @param kv The store to write to.
+ * @param key The key to write.
+ * @param data The value to write.
+ * @param dataCount The size of the value, at most @c FLASH_KV_VALUE_SIZE_MAX bytes.
+ * @return True if successful, false otherwise.
+ */
+bool flashKvWrite (flashKv_t* kv, uint16_t key, const void* data, uint16_t dataCount);
+
+/**
+ * @brief Compacts the store, copying the most recent value of each key into the inactive sector, then erasing the previously
+ * active sector.
+ * @note This erases both sectors, which stalls any code executing from the same flash bank. Only call this when doing so is
+ * safe.
+ * @param kv The store to compact.
+ * @return True if successful, false otherwise. On failure, the previously active sector remains active.
+ */
+bool flashKvCompact (flashKv_t* kv);
+
+/**
+ * @brief Gets the amount of space remaining in the active sector.
+ * @param kv The store to check.
+ * @return The remaining space, in bytes.
+ */
+uint32_t flashKvGetFree (flashKv_t* kv);
+
+#endif // FLASH_KV_H
\ No newline at end of file
@@ -0,0 +1,321 @@
+// Header
+#include "journal.h"
+
+// Includes
+#include "crc.h"
+#include "peripherals.h"
+#include "state_thread.h"
+#include "torque_thread.h"
+#include "peripherals/stm_flash.h"
+
+// C Standard Library
+#include <stddef.h>
+#include <string.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The first of the two flash sectors used by the journal.
+#define FLASH_SECTOR_BASE 8
+
+/// @brief The number of entries in each sector.
+#define SECTOR_ENTRY_COUNT (STM_FLASH_SECTOR_SIZE / sizeof (journalEntry_t))
+
+/// @brief The number of entries in the journal.
+#define ENTRY_COUNT (2 * SECTOR_ENTRY_COUNT)
+
+/// @brief The number of entries in the active sector after which the other sector is erased.
+#define ERASE_THRESHOLD (SECTOR_ENTRY_COUNT * 3 / 4)
+
+/// @brief The number of entries that can be queued for writing.
+#define QUEUE_SIZE 16
+
+/// @brief The interval at which the thread re-checks whether the next sector can be erased.
+#define ERASE_POLL_PERIOD TIME_S2I (1)
+
+/// @brief The size of an entry, in words.
+#define ENTRY_WORDS (sizeof (journalEntry_t) / sizeof (uint32_t))
+
+/// @brief Value of an erased word.
+#define WORD_ERASED 0xFFFFFFFF
+
+_Static_assert (JOURNAL_PAGE_COUNT * JOURNAL_PAGE_SIZE == ENTRY_COUNT * sizeof (journalEntry_t),
+	"Journal pages must span the journal's sectors.");
+
+// Global Data ----------------------------------------------------------------------------------------------------------------
+
+uint32_t journalSequence = 0;
+
+uint16_t journalDropCount = 0;
+
+eeprom_t journalEeprom;
+
+/// @brief The entries of the journal, in the flash.
+static journalEntry_t* const entries = (journalEntry_t*) STM_FLASH_SECTOR_ADDR (FLASH_SECTOR_BASE);
+
+/// @brief The index of the next entry to write.
+static uint32_t head;
+
+/// @brief Indicates which sectors are entirely erased.
+static bool sectorsErased [2];
+
+/// @brief Entries awaiting writing.
+static journalEntry_t queue [QUEUE_SIZE];
+static uint8_t queueHead = 0;
+static uint8_t queueCount = 0;
+
+/// @brief The page mapped by the journal window.
+static uint8_t page = 0;
+
+/// @brief The thread writing the queued entries.
+static thread_t* writerThread;
+
+// Function Prototypes --------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Scans the journal, locating the most recent entry and the erased sectors.
+ */
+static void scan (void);
+
+/**
+ * @brief Writes an entry to the flash.
+ * @return True if the entry was written (or discarded), false if no space is available yet.
+ */
+static bool writeEntry (journalEntry_t* entry);
+
+/**
+ * @brief Erases the sector the journal is about to enter, if erasing is safe.
+ */
+static void prepareSector (void);
+
+/**
+ * @brief Checks whether an entry is entirely erased.
+ */
+static bool entryIsErased (const journalEntry_t* entry);
+
+/**
+ * @brief Checks whether an entry is valid.
+ */
+static bool entryIsValid (const journalEntry_t* entry);
+
+/**
+ * @brief Read handler of the @c journalEeprom . Reads from the selected page of the flash.
+ */
+static bool journalRead (void* object, uint16_t addr, void* data, uint16_t dataCount);
+
+/**
+ * @brief Write handler of the @c journalEeprom . The journal is read-only.
+ */
+static bool journalWrite (void* object, uint16_t addr, const void* data, uint16_t dataCount);
+
+// Thread Entrypoint ----------------------------------------------------------------------------------------------------------
+
+static THD_WORKING_AREA (journalThreadWa, 512);
+THD_FUNCTION (journalThread, arg)
+{
+	(void) arg;
+	chRegSetThreadName ("journal");
+
+	// Scanning reads the whole journal, so is done here rather than delaying startup. Entries appended in the meantime are
+	// queued.
+	scan ();
+
+	while (true)
+	{
+		chEvtWaitAnyTimeout (ALL_EVENTS, ERASE_POLL_PERIOD);
+
+		prepareSector ();
+
+		while (true)
+		{
+			chSysLock ();
+			if (queueCount == 0)
+			{
+				chSysUnlock ();
+				break;
+			}
+			journalEntry_t entry = queue [queueHead];
+			chSysUnlock ();
+
+			// If no space is available, leave the entry queued until the next sector is erased.
+			if (!writeEntry (&entry))
+				break;
+
+			chSysLock ();
+			queueHead = (queueHead + 1) % QUEUE_SIZE;
+			--queueCount;
+			chSysUnlock ();
+		}
+	}
+}
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+void journalStart (tprio_t priority)
+{
+	eepromInit (&journalEeprom, journalWrite, journalRead);
+
+	writerThread = chThdCreateStatic (&journalThreadWa, sizeof (journalThreadWa), priority, journalThread, NULL);
+	journalAppend (JOURNAL_EVENT_BOOT, 0);
+}
+
+bool journalAppend (journalEvent_t event, uint8_t detail)
+{
+	// Snapshot the signals outside of the critical section, the sequence number & CRC are assigned by the journal thread.
+	journalEntry_t entry =
+	{
+		.timestamp		= TIME_I2MS (chVTGetSystemTimeX ()),
+		.event			= event,
+		.detail			= detail,
+		.vehicleState	= vehicleState,
+		.amksState		= amksState,
+		.flags			= torquePlausible | pedals.plausible << 1 | torqueDerating << 2 | vcuFault << 3,
+		.pad0			= 0xFF,
+		.samples		=
+		{
+			pedals.apps1.sample,
+			pedals.apps2.sample,
+			pedals.bseF.sample,
+			pedals.bseR.sample,
+			glvBattery.sample
+		},
+		.torqueRequest	= torqueRequest.torqueRl + torqueRequest.torqueRr + torqueRequest.torqueFl + torqueRequest.torqueFr
+	};
+
+	chSysLock ();
+	if (queueCount == QUEUE_SIZE)
+	{
+		++journalDropCount;
+		chSysUnlock ();
+		return false;
+	}
+
+	queue [(queueHead + queueCount) % QUEUE_SIZE] = entry;
+	++queueCount;
+	chSysUnlock ();
+
+	chEvtSignal (writerThread, EVENT_MASK (0));
+	return true;
+}
+
+bool journalSelectPage (uint8_t index)
+{
+	if (index >= JOURNAL_PAGE_COUNT)
+		return false;
+
+	page = index;
+	return true;
+}
+
+void scan (void)
+{
+	bool found = false;
+	uint32_t sequenceMax = 0;
+	head = 0;
+	sectorsErased [0] = true;
+	sectorsErased [1] = true;
+
+	for (uint32_t index = 0; index < ENTRY_COUNT; ++index)
+	{
+		if (entryIsErased (&entries [index]))
+			continue;
+
+		sectorsErased [index / SECTOR_ENTRY_COUNT] = false;
+
+		if (!entryIsValid (&entries [index]))
+			continue;
+
+		if (!found || (int32_t) (entries [index].sequence - sequenceMax) > 0)
+		{
+			found = true;
+			sequenceMax = entries [index].sequence;
+			head = (index + 1) % ENTRY_COUNT;
+		}
+	}
+
+	journalSequence = found ? sequenceMax + 1 : 0;
+}
+
+bool writeEntry (journalEntry_t* entry)
+{
+	while (true)
+	{
+		uint8_t sector = head / SECTOR_ENTRY_COUNT;
+
+		// Entering a sector requires it to be erased.
+		if (head % SECTOR_ENTRY_COUNT == 0)
+		{
+			if (!sectorsErased [sector])
+				return false;
+			sectorsErased [sector] = false;
+		}
+
+		// Skip any entries interrupted by a power loss.
+		if (entryIsErased (&entries [head]))
+			break;
+
+		head = (head + 1) % ENTRY_COUNT;
+	}
+
+	entry->sequence = journalSequence++;
+	entry->crc = crc32Calculate (entry, offsetof (journalEntry_t, crc));
+
+	// A failed write still consumes the entry's space, the entry is discarded.
+	stmFlashProgram ((uint32_t*) &entries [head], (const uint32_t*) entry, ENTRY_WORDS);
+	head = (head + 1) % ENTRY_COUNT;
+	return true;
+}
+
+void prepareSector (void)
+{
+	// The active sector needs erasing if the head is waiting to enter it, otherwise the next sector needs erasing once the active
+	// one is getting full.
+	uint8_t sector = head / SECTOR_ENTRY_COUNT;
+	if (head % SECTOR_ENTRY_COUNT != 0 || sectorsErased [sector])
+	{
+		if (head % SECTOR_ENTRY_COUNT < ERASE_THRESHOLD)
+			return;
+
+		sector = (sector + 1) % 2;
+	}
+
+	// Erasing stalls the CPU, so is only done while the vehicle is de-energized.
+	if (sectorsErased [sector] || vehicleState != VEHICLE_STATE_LOW_VOLTAGE)
+		return;
+
+	if (stmFlashErase (FLASH_SECTOR_BASE + sector))
+		sectorsErased [sector] = true;
+}
+
+bool entryIsErased (const journalEntry_t* entry)
+{
+	const uint32_t* words = (const uint32_t*) entry;
+	for (uint8_t index = 0; index < ENTRY_WORDS; ++index)
+		if (words [index] != WORD_ERASED)
+			return false;
+	return true;
+}
+
+bool entryIsValid (const journalEntry_t* entry)
+{
+	return entry->crc == crc32Calculate (entry, offsetof (journalEntry_t, crc));
+}
+
+bool journalRead (void* object, uint16_t addr, void* data, uint16_t dataCount)
+{
+	(void) object;
+
+	if (addr + dataCount > JOURNAL_PAGE_SIZE)
+		return false;
+
+	memcpy (data, (uint8_t*) entries + page * JOURNAL_PAGE_SIZE + addr, dataCount);
+	return true;
+}
+
+bool journalWrite (void* object, uint16_t addr, const void* data, uint16_t dataCount)
+{
+	(void) object;
+	(void) addr;
+	(void) data;
+	(void) dataCount;
+	return false;
+}
\ No newline at end of file
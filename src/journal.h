@@ -0,0 +1,126 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+// Fault & Event Journal ------------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.19
+//
+// Description: Persistent, append-only journal of faults and significant events, stored in sectors 8 & 9 of the internal
+//   flash. Each entry records when the event occurred, what it was, the vehicle's state, and a snapshot of the key control
+//   signals at the time. Entries are protected by a CRC, such that an entry interrupted by a power loss is discarded.
+//
+//   Appending an entry only snapshots the signals into a RAM queue, so is safe to call from the control loop. The journal
+//   thread then writes the entry to the flash. The two sectors form a ring: once the active sector is mostly full, the other
+//   (containing the oldest entries) is erased in preparation. As erasing stalls the CPU for 1 to 2 s, this is only done while
+//   the vehicle is in the low-voltage state. Should the queue overflow (or the next sector not be erased in time), entries are
+//   dropped, which is indicated by @c journalDropCount .
+//
+//   The journal is readable over CAN through the journal window of the virtual EEPROM. The window maps a single page (256
+//   entries) of the raw flash, selected via the write-only region (see @c eeprom_map.h ). Reading every page yields the whole
+//   journal, which can be decoded using tools/journal_decode.py. Entries are ordered by their sequence number, rather than
+//   their position.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "peripherals/interface/eeprom.h"
+
+// ChibiOS
+#include "ch.h"
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The number of entries in a page of the journal window.
+#define JOURNAL_PAGE_ENTRY_COUNT 256
+
+/// @brief The size of a page of the journal window, in bytes.
+#define JOURNAL_PAGE_SIZE (JOURNAL_PAGE_ENTRY_COUNT * sizeof (journalEntry_t))
+
+/// @brief The number of pages in the journal.
+#define JOURNAL_PAGE_COUNT 32
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef enum
+{
+	/// @brief The VCU started. Detail: 0.
+	JOURNAL_EVENT_BOOT = 0,
+
+	/// @brief The vehicle entered the failed state. Detail: bit 0 - AMKs invalid, bit 1 - EEPROM invalid.
+	JOURNAL_EVENT_VEHICLE_FAILED = 1,
+
+	/// @brief The torque request became implausible. Detail: 0.
+	JOURNAL_EVENT_TORQUE_IMPLAUSIBLE = 2,
+
+	/// @brief The pedals became implausible. Detail: 0.
+	JOURNAL_EVENT_PEDALS_IMPLAUSIBLE = 3,
+
+	/// @brief The AMK inverters entered the error state. Detail: 0.
+	JOURNAL_EVENT_AMK_ERROR = 4
+} journalEvent_t;
+
+typedef struct
+{
+	/// @brief Sequence number of the entry, incrementing across power cycles.
+	uint32_t sequence;
+	/// @brief The time of the event, in milliseconds since startup.
+	uint32_t timestamp;
+	/// @brief The event that occurred, see @c journalEvent_t .
+	uint8_t event;
+	/// @brief Event-specific detail, see @c journalEvent_t .
+	uint8_t detail;
+	/// @brief The vehicle state at the time of the event, see @c vehicleState_t .
+	uint8_t vehicleState;
+	/// @brief The state of the AMK inverters, see @c amkInverterState_t .
+	uint8_t amksState;
+	/// @brief Bit 0 - torque plausible, bit 1 - pedals plausible, bit 2 - torque derating, bit 3 - VCU fault.
+	uint8_t flags;
+	uint8_t pad0;
+	/// @brief The raw samples of the APPS-1, APPS-2, BSE-F, BSE-R, & GLV battery inputs.
+	uint16_t samples [5];
+	/// @brief The cumulative torque request, in Nm.
+	float torqueRequest;
+	/// @brief CRC-32 of the preceding fields.
+	uint32_t crc;
+} journalEntry_t;
+
+_Static_assert (sizeof (journalEntry_t) == 32, "Journal entry must be 32 bytes.");
+
+// Global Data ----------------------------------------------------------------------------------------------------------------
+
+/// @brief The sequence number of the next entry to be written.
+extern uint32_t journalSequence;
+
+/// @brief The number of entries dropped since startup.
+extern uint16_t journalDropCount;
+
+/// @brief EEPROM interface to the journal window.
+extern eeprom_t journalEeprom;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Starts the journal thread, which scans the journal to locate its end. A boot entry is appended. Must be called prior
+ * to any other thread appending entries.
+ * @param priority The priority to start the thread at.
+ */
+void journalStart (tprio_t priority);
+
+/**
+ * @brief Appends an entry to the journal. This only snapshots the current signals, the entry is written to the flash by the
+ * journal thread.
+ * @param event The event that occurred.
+ * @param detail Event-specific detail, see @c journalEvent_t .
+ * @return True if the entry was queued, false if it was dropped.
+ */
+bool journalAppend (journalEvent_t event, uint8_t detail);
+
+/**
+ * @brief Selects the page of the journal mapped by the journal window.
+ * @param page The index of the page, must be less than @c JOURNAL_PAGE_COUNT .
+ * @return True if successful, false otherwise.
+ */
+bool journalSelectPage (uint8_t page);
+
+#endif // JOURNAL_H
\ No newline at end of file
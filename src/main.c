@@ -11,6 +11,10 @@
 // Includes
 #include "debug.h"
 #include "can.h"
+#include "can/signals.h"
+#include "can/transmit.h"
+#include "counters.h"
+#include "journal.h"
 #include "peripherals.h"
 #include "state_thread.h"
 #include "torque_thread.h"
@@ -42,12 +46,20 @@ int main (void)
 	ioline_t ledLine = LINE_LED_HEARTBEAT;
 	debugHeartbeatStart (&ledLine, LOWPRIO);
 
-	// Peripheral initialization
-	if (!peripheralsInit ())
+	// Peripheral initialization. Re-configuration is done below all other threads, as it is the least time-critical.
+	if (!peripheralsInit (NORMALPRIO - 2))
 	{
 		hardFaultCallback ();
 		while (true);
 	}
+	systime_t peripheralsTime = chVTGetSystemTime ();
+
+	// Journal initialization. Start this prior to any threads that may append to it.
+	journalStart (NORMALPRIO - 3);
+
+	// Persistent counters initialization. Mounting the store may erase a flash sector, stalling the CPU, so this must be done
+	// prior to starting the control threads. A failure to mount the store is not fatal, the counters are only diagnostic.
+	countersInit ();
 
 	// CAN initialization. Start this first as to invalidate all can nodes before any other threads attempt reading
 	// any data.
@@ -56,6 +68,7 @@ int main (void)
 		hardFaultCallback ();
 		while (true);
 	}
+	systime_t canTime = chVTGetSystemTime ();
 
 	// Torque thread initialization. Start this at the highest priority as it has the strictest timing.
 	torqueThreadStart (NORMALPRIO + 1);
@@ -63,8 +76,20 @@ int main (void)
 	// State thread initialization. Start this at a lower priority as it has the least strict timing.
 	stateThreadStart (NORMALPRIO - 1);
 
+	// Persistent counters thread. Start this below re-configuration, as flash writes stall the CPU and are the least
+	// time-critical.
+	countersStart (NORMALPRIO - 3);
+
 	// Allow the shutdown loop to close.
 	palSetLine (LINE_SHUTDOWN_CONTROL);
+	systime_t readyTime = chVTGetSystemTime ();
+
+	// Report the boot timing.
+	CANTxFrame frame;
+	transmitPackBoot (&frame, peripheralsTime, canTime, readyTime);
+	frame.IDE = CAN_IDE_STD;
+	frame.SID = SIGNALS_BOOT_ID;
+	canTransmitTimeout (&CAND1, CAN_ANY_MAILBOX, &frame, TIME_MS2I (100));
 
 	// Do nothing.
 	while (true)
@@ -5,48 +5,114 @@
 
 // Includes
 #include "torque_thread.h"
+#include "can/telemetry.h"
+#include "capture.h"
+#include "controls/amk_estimator.h"
 #include "controls/lerp.h"
+#include "controls/steering_estimator.h"
+#include "crc.h"
+#include "journal.h"
+#include "peripherals/eeprom_cache.h"
+
+// C Standard Library
+#include <string.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+// Regions of the virtual EEPROM. Regions must be ordered by address and must not overlap.
+#define VIRTUAL_CONFIG_ADDR					0x0000
+#define VIRTUAL_CONFIG_SIZE					0x1000
+#define VIRTUAL_READONLY_WRITEONLY_ADDR		0x1000
+#define VIRTUAL_READONLY_WRITEONLY_SIZE		0x1000
+#define VIRTUAL_OVERLAY_ADDR				0x3000
+#define VIRTUAL_OVERLAY_SIZE				sizeof (eepromMap_t)
+#define VIRTUAL_CAPTURE_ADDR				0x4000
+#define VIRTUAL_CAPTURE_SIZE				CAPTURE_BUFFER_SIZE
+#define VIRTUAL_JOURNAL_ADDR				0x8000
+#define VIRTUAL_JOURNAL_SIZE				JOURNAL_PAGE_SIZE
+
+/// @brief The range of voltages the GLV battery is expected to measure, in volts. The ADC's analog watchdog window is widened
+/// to contain this range, such that the GLV battery's channel doesn't trip it.
+#define GLV_BATTERY_VOLTAGE_MIN 8.0f
+#define GLV_BATTERY_VOLTAGE_MAX 16.0f
 
 // Global Peripherals ---------------------------------------------------------------------------------------------------------
 
 // Public
-stmAdc_t		adc;
+adcStream_t		adc;
+i2cSupervisor_t	i2c1Supervisor;
+i2cSupervisor_t	i2c2Supervisor;
 mc24lc32_t		physicalEeprom;
 virtualEeprom_t virtualEeprom;
 linearSensor_t	glvBattery;
 pedals_t		pedals;
+sampleFilter_t	apps1Filter;
+sampleFilter_t	apps2Filter;
+sampleFilter_t	bseFFilter;
+sampleFilter_t	bseRFilter;
+sampleFilter_t	glvBatteryFilter;
 //am4096_t		sasDriver;
 as5600_t		sasADC;
 sas_t			sas;
+eepromMap_t		activeEepromMap;
+bool			overlayDirty = false;
+uint8_t			activeProfile = 0;
+bool			profileRejected = false;
 
 // Private
 eeprom_t		readonlyWriteonlyEeprom;
+eeprom_t		configEeprom;
+eeprom_t		overlayEeprom;
 
 // Configuration --------------------------------------------------------------------------------------------------------------
 
-/// @brief Configuration for the I2C1 bus.
+/// @brief Configuration for the I2C1 bus. Fast-mode (400 kHz).
 static const I2CConfig I2C1_CONFIG =
 {
 	.op_mode		= OPMODE_I2C,
-	.clock_speed	= 100000,
-	.duty_cycle		= STD_DUTY_CYCLE
+	.clock_speed	= 400000,
+	.duty_cycle		= FAST_DUTY_CYCLE_2
 };
 
-/// @brief Configuration for the I2C2 bus.
+/// @brief Configuration for the I2C2 bus. Fast-mode (400 kHz).
 static const I2CConfig I2C2_CONFIG =
 {
 	.op_mode		= OPMODE_I2C,
-	.clock_speed	= 100000,
-	.duty_cycle		= STD_DUTY_CYCLE
+	.clock_speed	= 400000,
+	.duty_cycle		= FAST_DUTY_CYCLE_2
 };
 
-/// @brief Configuration for the steering-angle-sensor's ADC driver.
+/// @brief The mode of the I2C lines when used by the peripherals.
+#define I2C_LINE_MODE (PAL_MODE_ALTERNATE (4) | PAL_STM32_OTYPE_OPENDRAIN | PAL_STM32_PUPDR_PULLUP)
+
+/// @brief Configuration for the I2C1 bus's supervisor.
+static const i2cSupervisorConfig_t I2C1_SUPERVISOR_CONFIG =
+{
+	.driver			= &I2CD1,
+	.config			= &I2C1_CONFIG,
+	.sclLine		= LINE_I2C1_SCL,
+	.sdaLine		= LINE_I2C1_SDA,
+	.alternateMode	= I2C_LINE_MODE
+};
+
+/// @brief Configuration for the I2C2 bus's supervisor.
+static const i2cSupervisorConfig_t I2C2_SUPERVISOR_CONFIG =
+{
+	.driver			= &I2CD2,
+	.config			= &I2C2_CONFIG,
+	.sclLine		= LINE_I2C2_SCL,
+	.sdaLine		= LINE_I2C2_SDA,
+	.alternateMode	= I2C_LINE_MODE
+};
+
+/// @brief Configuration for the steering-angle-sensor's ADC driver. A read takes ~0.1 ms, so the timeout only needs to bound
+/// the time lost to a stuck bus within the torque thread's period.
 static as5600Config_t sasADCConfig =
 {
 	.addr		= 0x36,
 	.i2c 		= &I2CD2,
 	.sensor 	= (analogSensor_t*) &sas,
-	.timeout 	= TIME_MS2I (100)
+	.timeout 	= TIME_MS2I (2)
 };
 // AS5600 registers: ZPOS=0x01, MPOS=0x03, ANGLE=0x0E AS5600 Datasheet Pg. 18
 
@@ -60,27 +126,65 @@ static as5600Config_t sasADCConfig =
 //	.timeout	= TIME_MS2I (5)
 //};
 
-/// @brief Configuration for the ADC1 peripheral.
-static const stmAdcConfig_t ADC_CONFIG =
+/// @brief Configuration for the ADC1 peripheral. Sequences are triggered by TIM3 at 10 kHz, such that each half of the buffer
+/// completes every 0.8 ms. The pedals are averaged over 4 conversions (0.4 ms), the slower GLV battery over all 8. The
+/// oversampled samples are then filtered (once per sample) as configured by the EEPROM. The sensors' supply isn't routed to
+/// an ADC input on this board, so the pedals are corrected for deviations of VDDA only (via VREFINT).
+static const adcStreamConfig_t ADC_CONFIG =
 {
-	.driver = &ADCD1,
-	.channels =
+	.driver		= &ADCD1,
+	.timer		= &GPTD3,
+	.extsel		= ADC_CR2_EXTSEL_SRC (8), // TIM3 TRGO
+	.frequency	= 10000,
+	.depth		= 8,
+	.channels	=
 	{
-		ADC_CHANNEL_IN10,	// APPS-1
-		ADC_CHANNEL_IN11,	// APPS-2
-		ADC_CHANNEL_IN12,	// BSE-F
-		ADC_CHANNEL_IN13,	// BSE-R
-		ADC_CHANNEL_IN0		// GLV Battery
+		{
+			// APPS-1
+			.channel		= ADC_CHANNEL_IN10,
+			.sensor			= (analogSensor_t*) &pedals.apps1,
+			.oversampling	= 4,
+			.filter			= &apps1Filter
+		},
+		{
+			// APPS-2
+			.channel		= ADC_CHANNEL_IN11,
+			.sensor			= (analogSensor_t*) &pedals.apps2,
+			.oversampling	= 4,
+			.filter			= &apps2Filter
+		},
+		{
+			// BSE-F
+			.channel		= ADC_CHANNEL_IN12,
+			.sensor			= (analogSensor_t*) &pedals.bseF,
+			.oversampling	= 4,
+			.filter			= &bseFFilter
+		},
+		{
+			// BSE-R
+			.channel		= ADC_CHANNEL_IN13,
+			.sensor			= (analogSensor_t*) &pedals.bseR,
+			.oversampling	= 4,
+			.filter			= &bseRFilter
+		},
+		{
+			// GLV Battery
+			.channel		= ADC_CHANNEL_IN0,
+			.sensor			= (analogSensor_t*) &glvBattery,
+			.oversampling	= 8,
+			.filter			= &glvBatteryFilter
+		},
+		{
+			// VREFINT
+			.channel		= ADC_CHANNEL_VREFINT,
+			.sensor			= NULL,
+			.oversampling	= 8,
+			.filter			= NULL
+		}
 	},
-	.channelCount = 5,
-	.sensors =
-	{
-		(analogSensor_t*) &pedals.apps1,
-		(analogSensor_t*) &pedals.apps2,
-		(analogSensor_t*) &pedals.bseF,
-		(analogSensor_t*) &pedals.bseR,
-		(analogSensor_t*) &glvBattery
-	}
+	.channelCount	= 6,
+	.supplyIndex	= -1,
+	.vrefintIndex	= 5
 };
 
 /// @brief Configuration for the on-board EEPROM.
@@ -90,24 +194,39 @@ static const mc24lc32Config_t PHYSICAL_EEPROM_CONFIG =
 	.i2c			= &I2CD1,
 	.timeout		= TIME_MS2I (500),
 	.magicString	= EEPROM_MAP_STRING,
-	.dirtyHook		= peripheralsReconfigure
+	.dirtyHook		= NULL
 };
 
 /// @brief Configuration for the BMS's virtual EEPROM.
 static const virtualEepromConfig_t VIRTUAL_EEPROM_CONFIG =
 {
-	.count		= 3,
+	.count		= 5,
 	.entries	=
 	{
 		{
-			.eeprom	= (eeprom_t*) &physicalEeprom,
-			.addr	= 0x0000,
-			.size	= 0x1000
+			.eeprom	= &configEeprom,
+			.addr	= VIRTUAL_CONFIG_ADDR,
+			.size	= VIRTUAL_CONFIG_SIZE
 		},
 		{
 			.eeprom	= &readonlyWriteonlyEeprom,
-			.addr	= 0x1000,
-			.size	= 0x1000
+			.addr	= VIRTUAL_READONLY_WRITEONLY_ADDR,
+			.size	= VIRTUAL_READONLY_WRITEONLY_SIZE
+		},
+		{
+			.eeprom	= &overlayEeprom,
+			.addr	= VIRTUAL_OVERLAY_ADDR,
+			.size	= VIRTUAL_OVERLAY_SIZE
+		},
+		{
+			.eeprom	= &captureEeprom,
+			.addr	= VIRTUAL_CAPTURE_ADDR,
+			.size	= VIRTUAL_CAPTURE_SIZE
+		},
+		{
+			.eeprom	= &journalEeprom,
+			.addr	= VIRTUAL_JOURNAL_ADDR,
+			.size	= VIRTUAL_JOURNAL_SIZE
 		},
 		//{
 		//	.eeprom	= (eeprom_t*) &sasDriver,
@@ -127,88 +246,504 @@ static linearSensorConfig_t glvBatteryConfig =
 	.valueMax	= 0
 };
 
+// Global Data ----------------------------------------------------------------------------------------------------------------
+
+/// @brief Bitmask of the groups awaiting re-configuration, see @c eepromMapGroup_t .
+static uint16_t dirtyGroups = 0;
+
+/// @brief The thread responsible for re-configuring dirty groups.
+static thread_t* reconfigureThread;
+
+/// @brief The health monitor of each sensor, see @c peripheralsHealthChannel_t .
+static sensorHealth_t sensorHealth [PERIPHERALS_HEALTH_COUNT];
+
+_Static_assert (sizeof (eepromMap_t) <= PERIPHERALS_PROFILE_SIZE - sizeof (uint32_t), "EEPROM map exceeds the profile size.");
+_Static_assert (PERIPHERALS_PROFILE_COUNT * PERIPHERALS_PROFILE_SIZE <= 0x1000, "Profiles exceed the EEPROM size.");
+_Static_assert (sizeof (physicalEepromMap->healthRateLimits) / sizeof (uint16_t) == PERIPHERALS_HEALTH_COUNT,
+	"Health rate limits don't match the health channels.");
+_Static_assert (VIRTUAL_CONFIG_ADDR + VIRTUAL_CONFIG_SIZE <= VIRTUAL_READONLY_WRITEONLY_ADDR,
+	"Virtual EEPROM config region overlaps the read-only / write-only region.");
+_Static_assert (VIRTUAL_READONLY_WRITEONLY_ADDR + VIRTUAL_READONLY_WRITEONLY_SIZE <= VIRTUAL_OVERLAY_ADDR,
+	"Virtual EEPROM read-only / write-only region overlaps the overlay region.");
+_Static_assert (VIRTUAL_OVERLAY_ADDR + VIRTUAL_OVERLAY_SIZE <= VIRTUAL_CAPTURE_ADDR,
+	"Virtual EEPROM overlay region overlaps the capture region.");
+_Static_assert (VIRTUAL_CAPTURE_ADDR + VIRTUAL_CAPTURE_SIZE <= VIRTUAL_JOURNAL_ADDR,
+	"Virtual EEPROM capture region overlaps the journal region.");
+_Static_assert (VIRTUAL_JOURNAL_ADDR + VIRTUAL_JOURNAL_SIZE <= 0x10000,
+	"Virtual EEPROM journal region exceeds the address space.");
+
+// Function Prototypes --------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Write handler of the @c configEeprom . Writes to the physical EEPROM (via the write-back cache), then schedules the
+ * re-configuration of any affected groups.
+ */
+static bool configEepromWrite (void* object, uint16_t addr, const void* data, uint16_t dataCount);
+
+/**
+ * @brief Read handler of the @c configEeprom . Reads from the physical EEPROM's RAM mirror.
+ */
+static bool configEepromRead (void* object, uint16_t addr, void* data, uint16_t dataCount);
+
+/**
+ * @brief Write handler of the @c overlayEeprom . Writes to the RAM copy of the active profile only, then schedules the
+ * re-configuration of any affected groups.
+ */
+static bool overlayEepromWrite (void* object, uint16_t addr, const void* data, uint16_t dataCount);
+
+/**
+ * @brief Read handler of the @c overlayEeprom . Reads from the RAM copy of the active profile.
+ */
+static bool overlayEepromRead (void* object, uint16_t addr, void* data, uint16_t dataCount);
+
+/**
+ * @brief Schedules groups of EEPROM map fields for re-configuration by the background thread.
+ * @param groups Bitmask of the groups to re-configure, see @c eepromMapGroup_t .
+ */
+static void scheduleReconfigure (uint16_t groups);
+
+/**
+ * @brief Calculates the CRC of a profile's slot, excluding the CRC itself.
+ */
+static uint32_t calculateProfileCrc (uint8_t index);
+
+/**
+ * @brief Callback for the ADC's analog watchdog. Should a pedal sensor be out of its plausible range, the sensor is
+ * invalidated and the torque thread is signalled to request 0 torque immediately.
+ */
+static void adcWatchdogCallback (void* object, analogSensor_t* sensor, uint16_t sample, uint16_t sampleVdd);
+
+/**
+ * @brief Updates the health monitor of a sensor with its latest sample. Failed sensors have no sample, so are ignored.
+ */
+static void updateHealth (peripheralsHealthChannel_t channel, analogSensorState_t state, uint16_t sample);
+
+// Thread Entrypoint ----------------------------------------------------------------------------------------------------------
+
+static THD_WORKING_AREA (reconfigureThreadWa, 512);
+THD_FUNCTION (peripheralsReconfigureThread, arg)
+{
+	(void) arg;
+	chRegSetThreadName ("reconfigure");
+
+	while (true)
+	{
+		chEvtWaitAny (ALL_EVENTS);
+
+		// Take all pending groups at once, such that a burst of writes only re-configures each group once.
+		chSysLock ();
+		uint16_t groups = dirtyGroups;
+		dirtyGroups = 0;
+		chSysUnlock ();
+
+		peripheralsReconfigure (groups);
+	}
+}
+
 // Functions ------------------------------------------------------------------------------------------------------------------
 
-bool peripheralsInit ()
+bool peripheralsInit (tprio_t reconfigurePriority)
 {
+	// Sensor health monitor initialization.
+	for (uint8_t index = 0; index < PERIPHERALS_HEALTH_COUNT; ++index)
+		sensorHealthInit (&sensorHealth [index]);
+
 	// I2C 1 driver initialization.
-	if (i2cStart (&I2CD1, &I2C1_CONFIG) != MSG_OK)
+	if (!i2cSupervisorInit (&i2c1Supervisor, &I2C1_SUPERVISOR_CONFIG))
 		return false;
 
 	// I2C 2 driver initalization.
-	if (i2cStart (&I2CD2, &I2C2_CONFIG) != MSG_OK)
+	if (!i2cSupervisorInit (&i2c2Supervisor, &I2C2_SUPERVISOR_CONFIG))
 		return false;
 
-	// ADC 1 driver initialization.
-	if (!stmAdcInit (&adc, &ADC_CONFIG))
+	// ADC 1 stream initialization.
+	if (!adcStreamInit (&adc, &ADC_CONFIG))
 		return false;
 
-	// Physical EEPROM initialization (only exit early if a failure occurred).
-	if (!mc24lc32Init (&physicalEeprom, &PHYSICAL_EEPROM_CONFIG) && physicalEeprom.state == MC24LC32_STATE_FAILED)
+	// Physical EEPROM initialization. Only the EEPROM map is loaded immediately, the remainder of the device is loaded in the
+	// background, at the same priority as re-configuration (only exit early if a failure occurred).
+	if (!eepromCacheInit (&physicalEeprom, &PHYSICAL_EEPROM_CONFIG, &i2c1Supervisor, sizeof (eepromMap_t),
+		reconfigurePriority))
 		return false;
 
+	// Profile 0 is active upon startup.
+	memcpy (&activeEepromMap, physicalEeprom.cache, sizeof (eepromMap_t));
+
+	// Configuration EEPROM initialization.
+	eepromInit (&configEeprom, configEepromWrite, configEepromRead);
+
+	// Calibration overlay initialization.
+	eepromInit (&overlayEeprom, overlayEepromWrite, overlayEepromRead);
+
 	// Read-only / Write-only EEPROM initialization.
 	eepromInit (&readonlyWriteonlyEeprom, eepromWriteonlyWrite, eepromReadonlyRead);
 
+	// Capture buffer initialization.
+	captureInit ();
+
 	// Virtual memory initialization.
 	virtualEepromInit (&virtualEeprom, &VIRTUAL_EEPROM_CONFIG);
 
 	// Re-configurable peripherals are not considered fatal.
-	peripheralsReconfigure (NULL);
+	peripheralsReconfigure (EEPROM_MAP_GROUP_ALL);
+
+	// Any further changes are re-configured in the background.
+	reconfigureThread = chThdCreateStatic (&reconfigureThreadWa, sizeof (reconfigureThreadWa), reconfigurePriority,
+		peripheralsReconfigureThread, NULL);
+
 	return true;
 }
 
-void peripheralsReconfigure (void* caller)
+void peripheralsReconfigure (uint16_t groups)
 {
-	(void) caller;
-
 	// Pedals initialization
-	pedalsInit (&pedals, &physicalEepromMap->pedalConfig);
+	if (groups & EEPROM_MAP_GROUP_PEDALS)
+	{
+		pedalsInit (&pedals, &physicalEepromMap->pedalConfig);
+	}
 
 	// SAS initialization
-	// am4096 Config, so commented out //sasDriverConfig.addr = physicalEepromMap->sasAddr & 0x7F;
-	sasInit (&sas, &physicalEepromMap->sasConfig);
-	as5600Init (&sasADC, &sasADCConfig);
-	//am4096Init (&sasDriver, &sasDriverConfig);
+	if (groups & EEPROM_MAP_GROUP_SAS)
+	{
+		// am4096 Config, so commented out //sasDriverConfig.addr = physicalEepromMap->sasAddr & 0x7F;
+		sasInit (&sas, &physicalEepromMap->sasConfig);
+		as5600Init (&sasADC, &sasADCConfig);
+		steeringEstimatorReconfigure (&physicalEepromMap->steeringEstimatorConfig);
+		//am4096Init (&sasDriver, &sasDriverConfig);
+	}
 
 	// Torque thread configuration
-	torqueThreadSetDrivingTorqueLimit (physicalEepromMap->drivingTorqueLimit);
-	torqueThreadSetRegenTorqueLimit (physicalEepromMap->regenTorqueLimit);
-	torqueThreadSelectAlgorithm (physicalEepromMap->torqueAlgoritmIndex);
-	torqueThreadSetPowerLimit (physicalEepromMap->powerLimit);
-	torqueThreadSetPowerLimitPid
-	(
-		physicalEepromMap->powerLimitPidKp,
-		physicalEepromMap->powerLimitPidKi,
-		physicalEepromMap->powerLimitPidKd,
-		physicalEepromMap->powerLimitPidA
-	);
+	if (groups & EEPROM_MAP_GROUP_TORQUE)
+	{
+		torqueThreadSetDrivingTorqueLimit (physicalEepromMap->drivingTorqueLimit);
+		torqueThreadSetThrottleMap (&physicalEepromMap->throttleMapConfig);
+		torqueThreadSetRegenTorqueLimit (physicalEepromMap->regenTorqueLimit);
+		torqueThreadSelectAlgorithm (physicalEepromMap->torqueAlgoritmIndex);
+		torqueThreadSetPowerLimit (physicalEepromMap->powerLimit);
+		torqueThreadSetPowerLimitPid
+		(
+			physicalEepromMap->powerLimitPidKp,
+			physicalEepromMap->powerLimitPidKi,
+			physicalEepromMap->powerLimitPidKd,
+			physicalEepromMap->powerLimitPidA
+		);
+	}
+
+	// Telemetry configuration
+	if (groups & EEPROM_MAP_GROUP_TELEMETRY)
+		telemetryReconfigure (&physicalEepromMap->telemetryConfig);
+
+	// Capture configuration
+	if (groups & EEPROM_MAP_GROUP_CAPTURE)
+		captureReconfigure (&physicalEepromMap->captureConfig);
+
+	// AMK estimator configuration
+	if (groups & EEPROM_MAP_GROUP_AMK_ESTIMATOR)
+		amkEstimatorReconfigure (&physicalEepromMap->amkEstimatorConfig);
+
+	// Filter initialization. The filters are updated by the torque thread, so are re-initialized atomically. Each filter's
+	// group delay is calculated here, see the read-only region.
+	if (groups & EEPROM_MAP_GROUP_FILTERS)
+	{
+		chSysLock ();
+		sampleFilterInit (&apps1Filter, &physicalEepromMap->apps1Filter);
+		sampleFilterInit (&apps2Filter, &physicalEepromMap->apps2Filter);
+		sampleFilterInit (&bseFFilter, &physicalEepromMap->bseFFilter);
+		sampleFilterInit (&bseRFilter, &physicalEepromMap->bseRFilter);
+		sampleFilterInit (&glvBatteryFilter, &physicalEepromMap->glvBatteryFilter);
+		chSysUnlock ();
+	}
 
 	// GLV battery initialization
-	uint16_t glvSample11v5 = physicalEepromMap->glvBattery11v5;
-	uint16_t glvSample14v4 = physicalEepromMap->glvBattery14v4;
-	glvBatteryConfig.valueMin = lerp2d (0, glvSample11v5, 11.5f, glvSample14v4, 14.4f);
-	glvBatteryConfig.valueMax = lerp2d (4095, glvSample11v5, 11.5f, glvSample14v4, 14.4f);
-	linearSensorInit (&glvBattery, &glvBatteryConfig);
+	if (groups & EEPROM_MAP_GROUP_GLV_BATTERY)
+	{
+		uint16_t glvSample11v5 = physicalEepromMap->glvBattery11v5;
+		uint16_t glvSample14v4 = physicalEepromMap->glvBattery14v4;
+		glvBatteryConfig.valueMin = lerp2d (0, glvSample11v5, 11.5f, glvSample14v4, 14.4f);
+		glvBatteryConfig.valueMax = lerp2d (4095, glvSample11v5, 11.5f, glvSample14v4, 14.4f);
+		linearSensorInit (&glvBattery, &glvBatteryConfig);
+	}
+
+	// ADC analog watchdog initialization. The window applies to every channel of the ADC, so is the pedals' plausible range,
+	// widened to contain the GLV battery's expected range (the stream widens it for the VREFINT channel).
+	if (groups & (EEPROM_MAP_GROUP_PEDALS | EEPROM_MAP_GROUP_GLV_BATTERY))
+	{
+		uint16_t watchdogLow;
+		uint16_t watchdogHigh;
+		if (pedalsGetWatchdogWindow (&pedals, &watchdogLow, &watchdogHigh))
+		{
+			// Without a valid calibration, the GLV battery's range is unknown, so may be anywhere.
+			float glvLow = 0.0f;
+			float glvHigh = 4095.0f;
+			uint16_t glvSample11v5 = physicalEepromMap->glvBattery11v5;
+			uint16_t glvSample14v4 = physicalEepromMap->glvBattery14v4;
+			if (glvSample11v5 < glvSample14v4)
+			{
+				glvLow = lerp2d (GLV_BATTERY_VOLTAGE_MIN, 11.5f, glvSample11v5, 14.4f, glvSample14v4);
+				glvHigh = lerp2d (GLV_BATTERY_VOLTAGE_MAX, 11.5f, glvSample11v5, 14.4f, glvSample14v4);
+			}
+
+			if (glvLow < watchdogLow)
+				watchdogLow = glvLow < 0.0f ? 0 : (uint16_t) glvLow;
+			if (glvHigh > watchdogHigh)
+				watchdogHigh = glvHigh > 4095.0f ? 4095 : (uint16_t) glvHigh;
+
+			adcStreamEnableWatchdog (&adc, watchdogLow, watchdogHigh, adcWatchdogCallback, &pedals);
+		}
+		else
+			adcStreamDisableWatchdog (&adc);
+	}
 }
 
 void peripheralsSample (systime_t timePrevious, systime_t timeCurrent)
 {
-	// Sample the pedal inputs and GLV battery.
-	stmAdcSample (&adc);
+	// Sample the pedal inputs and GLV battery, this doesn't wait for a conversion.
+	adcStreamSample (&adc);
 	pedalsUpdate (&pedals, timePrevious, timeCurrent);
 
-	if (physicalEepromMap->sasEnabled)
+	// If the SAS is enabled, sample the sensor. The driver doesn't recover from a stuck bus, so the bus is checked (and if
+	// necessary, recovered) first.
+	bool sasSampled = physicalEepromMap->sasEnabled && i2cSupervisorCheck (&i2c2Supervisor);
+
+	// The sample is timestamped at the midpoint of the transaction.
+	systime_t sasSampleTime = chVTGetSystemTimeX ();
+
+	if (sasSampled)
 	{
-		// If the SAS is enabled, sample the sensor.
 		as5600Sample (&sasADC);
 		//am4096Sample (&sasDriver);
 
+		sasSampleTime = chTimeAddX (sasSampleTime, chTimeDiffX (sasSampleTime, chVTGetSystemTimeX ()) / 2);
 	}
 	else
 	{
-		// Otherwise, invalidate the sensor.
+		// Otherwise (or if the bus couldn't be recovered), invalidate the sensor.
 		sas.value = 0;
 		sas.state = ANALOG_SENSOR_SAMPLE_INVALID;
 	}
+
+	// Estimate the steering rate and compensate for the sensor's latency.
+	steeringEstimatorUpdate (sasSampleTime, timeCurrent, sas.value, sas.state == ANALOG_SENSOR_VALID);
+
+	// Update the health monitors. The SAS is only monitored while it is being sampled.
+	updateHealth (PERIPHERALS_HEALTH_APPS_1, pedals.apps1.state, pedals.apps1.sample);
+	updateHealth (PERIPHERALS_HEALTH_APPS_2, pedals.apps2.state, pedals.apps2.sample);
+	updateHealth (PERIPHERALS_HEALTH_BSE_F, pedals.bseF.state, pedals.bseF.sample);
+	updateHealth (PERIPHERALS_HEALTH_BSE_R, pedals.bseR.state, pedals.bseR.sample);
+	updateHealth (PERIPHERALS_HEALTH_GLV_BATTERY, glvBattery.state, glvBattery.sample);
+	if (sasSampled)
+		updateHealth (PERIPHERALS_HEALTH_SAS, sas.state, sas.sample);
+}
+
+void peripheralsTakeHealthStats (peripheralsHealthChannel_t channel, sensorHealthStats_t* stats)
+{
+	// The monitors are updated by the torque thread, so are read (and reset) atomically.
+	chSysLock ();
+	sensorHealthTakeStats (&sensorHealth [channel], stats);
+	chSysUnlock ();
+}
+
+bool peripheralsCheckVirtualRange (uint16_t addr, uint16_t size)
+{
+	// Note the end of the range is calculated in 32 bits, such that it can't wrap around the 16-bit address space.
+	for (uint16_t index = 0; index < VIRTUAL_EEPROM_CONFIG.count; ++index)
+	{
+		uint16_t entryAddr = VIRTUAL_EEPROM_CONFIG.entries [index].addr;
+		uint32_t entryEnd = (uint32_t) entryAddr + VIRTUAL_EEPROM_CONFIG.entries [index].size;
+		if (addr >= entryAddr && (uint32_t) addr + size <= entryEnd)
+			return true;
+	}
+
+	return false;
+}
+
+bool configEepromWrite (void* object, uint16_t addr, const void* data, uint16_t dataCount)
+{
+	(void) object;
+
+	// All writes, including those to the magic string, are coalesced by the write-back cache. The cache re-validates the
+	// magic string itself, such that no write bypasses it (and races its write-back).
+	if (!eepromWrite (&eepromCache, addr, data, dataCount))
+		return false;
+
+	// Only writes to the active profile affect the configuration.
+	uint16_t profileBase = activeProfile * PERIPHERALS_PROFILE_SIZE;
+	uint16_t start = addr > profileBase ? addr : profileBase;
+	uint16_t end = addr + dataCount < profileBase + sizeof (eepromMap_t) ? addr + dataCount : profileBase + sizeof (eepromMap_t);
+	if (start >= end)
+		return true;
+
+	chSysLock ();
+	memcpy ((uint8_t*) &activeEepromMap + (start - profileBase), physicalEeprom.cache + start, end - start);
+	chSysUnlock ();
+
+	scheduleReconfigure (eepromMapGetGroups (start - profileBase, end - start));
+	return true;
+}
+
+bool configEepromRead (void* object, uint16_t addr, void* data, uint16_t dataCount)
+{
+	(void) object;
+	return eepromRead (&eepromCache, addr, data, dataCount);
+}
+
+bool peripheralsSelectProfile (uint8_t index)
+{
+	if (index >= PERIPHERALS_PROFILE_COUNT)
+	{
+		profileRejected = true;
+		return false;
+	}
+
+	// Profile 0 is validated by the magic string, the others by their CRC.
+	if (index != 0)
+	{
+		uint32_t crc;
+		eepromRead (&eepromCache, (index + 1) * PERIPHERALS_PROFILE_SIZE - sizeof (crc), &crc, sizeof (crc));
+		if (crc != calculateProfileCrc (index))
+		{
+			profileRejected = true;
+			return false;
+		}
+	}
+
+	chSysLock ();
+	memcpy (&activeEepromMap, physicalEeprom.cache + index * PERIPHERALS_PROFILE_SIZE, sizeof (eepromMap_t));
+	activeProfile = index;
+	overlayDirty = false;
+	chSysUnlock ();
+
+	profileRejected = false;
+	scheduleReconfigure (EEPROM_MAP_GROUP_ALL);
+	return true;
+}
+
+bool peripheralsSealProfile (uint8_t index)
+{
+	if (index >= PERIPHERALS_PROFILE_COUNT)
+		return false;
+
+	uint32_t crc = calculateProfileCrc (index);
+	return eepromWrite (&eepromCache, (index + 1) * PERIPHERALS_PROFILE_SIZE - sizeof (crc), &crc, sizeof (crc));
+}
+
+bool peripheralsCommitOverlay (void)
+{
+	// Clear the flag prior to snapshotting, such that any overlay write made during the commit re-marks the overlay.
+	chSysLock ();
+	overlayDirty = false;
+	chSysUnlock ();
+
+	// Write the map a page at a time, skipping the magic string. Each page is snapshotted under lock into a small buffer, as
+	// this may be called from threads whose stacks can't hold a copy of the whole map. The write-back cache reduces this to
+	// only the pages that differ. Profiles other than 0 must be re-sealed, as their CRC is now out-of-date.
+	uint16_t base = activeProfile * PERIPHERALS_PROFILE_SIZE;
+	uint16_t offset = sizeof (activeEepromMap.pad0);
+	while (offset < sizeof (eepromMap_t))
+	{
+		uint16_t count = EEPROM_CACHE_PAGE_SIZE - (base + offset) % EEPROM_CACHE_PAGE_SIZE;
+		if (count > sizeof (eepromMap_t) - offset)
+			count = sizeof (eepromMap_t) - offset;
+
+		uint8_t chunk [EEPROM_CACHE_PAGE_SIZE];
+		chSysLock ();
+		memcpy (chunk, (uint8_t*) &activeEepromMap + offset, count);
+		chSysUnlock ();
+
+		if (!eepromWrite (&eepromCache, base + offset, chunk, count))
+		{
+			overlayDirty = true;
+			return false;
+		}
+
+		offset += count;
+	}
+
+	if (activeProfile != 0 && !peripheralsSealProfile (activeProfile))
+	{
+		overlayDirty = true;
+		return false;
+	}
+
+	eepromCacheFlush ();
+	return true;
+}
+
+void peripheralsRevertOverlay (void)
+{
+	chSysLock ();
+	memcpy (&activeEepromMap, physicalEeprom.cache + activeProfile * PERIPHERALS_PROFILE_SIZE, sizeof (eepromMap_t));
+	overlayDirty = false;
+	chSysUnlock ();
+
+	scheduleReconfigure (EEPROM_MAP_GROUP_ALL);
+}
+
+bool overlayEepromWrite (void* object, uint16_t addr, const void* data, uint16_t dataCount)
+{
+	(void) object;
+
+	// The magic string cannot be overlaid.
+	if (addr < sizeof (activeEepromMap.pad0) || addr + dataCount > sizeof (eepromMap_t))
+		return false;
+
+	chSysLock ();
+	memcpy ((uint8_t*) &activeEepromMap + addr, data, dataCount);
+	overlayDirty = true;
+	chSysUnlock ();
+
+	scheduleReconfigure (eepromMapGetGroups (addr, dataCount));
+	return true;
+}
+
+bool overlayEepromRead (void* object, uint16_t addr, void* data, uint16_t dataCount)
+{
+	(void) object;
+
+	if (addr + dataCount > sizeof (eepromMap_t))
+		return false;
+
+	chSysLock ();
+	memcpy (data, (uint8_t*) &activeEepromMap + addr, dataCount);
+	chSysUnlock ();
+
+	return true;
+}
+
+void scheduleReconfigure (uint16_t groups)
+{
+	if (groups == 0)
+		return;
+
+	chSysLock ();
+	dirtyGroups |= groups;
+	chEvtSignalI (reconfigureThread, EVENT_MASK (0));
+	chSchRescheduleS ();
+	chSysUnlock ();
+}
+
+uint32_t calculateProfileCrc (uint8_t index)
+{
+	eepromCacheWaitLoad ();
+	return crc32Calculate (physicalEeprom.cache + index * PERIPHERALS_PROFILE_SIZE, PERIPHERALS_PROFILE_SIZE - sizeof (uint32_t));
+}
+
+void adcWatchdogCallback (void* object, analogSensor_t* sensor, uint16_t sample, uint16_t sampleVdd)
+{
+	// Only the pedals are monitored. The window contains the expected range of every other channel, so a trip by one of them
+	// (ex. the GLV battery outside of its expected range) is ignored.
+	if (pedalsWatchdogLocked ((pedals_t*) object, sensor, sample, sampleVdd))
+		torqueThreadSignalFaultI ();
+}
+
+void updateHealth (peripheralsHealthChannel_t channel, analogSensorState_t state, uint16_t sample)
+{
+	if (state == ANALOG_SENSOR_FAILED)
+		return;
+
+	// Samples that are out of the sensor's range invalidate it, a sensor with an invalid configuration has no range.
+	bool inRange = state != ANALOG_SENSOR_SAMPLE_INVALID;
+
+	// The rate limits are read directly from the EEPROM map, as they don't require re-configuration.
+	sensorHealthUpdate (&sensorHealth [channel], sample, inRange, physicalEepromMap->healthRateLimits [channel]);
 }
\ No newline at end of file
@@ -7,30 +7,78 @@
 // Date Created: 2024.09.29
 //
 // Description: Global objects representing the on-board hardware of the VCU.
+//
+//   The physical EEPROM stores multiple complete configuration profiles (for instance, one per event). The active profile is
+//   copied into RAM ( @c activeEepromMap ), such that switching profiles is instant and doesn't require any EEPROM writes.
+//   Writes to the active profile's slot are applied to both the EEPROM and the RAM copy.
+//
+//   For live tuning, the RAM copy is also exposed directly as a calibration overlay. Writes to the overlay take effect
+//   immediately, but are not written to the EEPROM until committed. Reverting the overlay reloads the profile from the EEPROM.
 
 // Includes -------------------------------------------------------------------------------------------------------------------
 
 // Includes
 #include "peripherals/adc/analog_linear.h"
-#include "peripherals/adc/stm_adc.h"
+#include "controls/sensor_health.h"
 
 #include "peripherals/i2c/am4096.h"
 #include "peripherals/i2c/as5600.h"
 #include "peripherals/i2c/mc24lc32.h"
 
+#include "peripherals/adc_stream.h"
 #include "peripherals/eeprom_map.h"
+#include "peripherals/i2c_supervisor.h"
 #include "peripherals/pedals.h"
 
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The number of configuration profiles stored in the physical EEPROM.
+#define PERIPHERALS_PROFILE_COUNT 4
+
+/// @brief The size of each configuration profile's slot in the physical EEPROM, in bytes. Profile N occupies the address range
+/// [N * size, (N + 1) * size). The last 4 bytes of each slot contain the CRC-32 of the remainder of the slot.
+#define PERIPHERALS_PROFILE_SIZE 0x0400
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The sensors monitored by the sensor health monitor, see @c peripheralsTakeHealthStats .
+typedef enum
+{
+	PERIPHERALS_HEALTH_APPS_1		= 0,
+	PERIPHERALS_HEALTH_APPS_2		= 1,
+	PERIPHERALS_HEALTH_BSE_F		= 2,
+	PERIPHERALS_HEALTH_BSE_R		= 3,
+	PERIPHERALS_HEALTH_GLV_BATTERY	= 4,
+	PERIPHERALS_HEALTH_SAS			= 5,
+	PERIPHERALS_HEALTH_COUNT		= 6
+} peripheralsHealthChannel_t;
+
 // Global Peripherals ---------------------------------------------------------------------------------------------------------
 
 /// @brief ADC responsible for sampling all on-board analog inputs ( @c pedals & @c glvBattery ).
-extern stmAdc_t adc;
+extern adcStream_t adc;
+
+/// @brief Supervisors of the I2C1 (EEPROM) and I2C2 (steering-angle sensor) buses.
+extern i2cSupervisor_t i2c1Supervisor;
+extern i2cSupervisor_t i2c2Supervisor;
 
 /// @brief The VCU's physical (on-board) EEPROM. This is responsible for storing all non-volatile variables.
 extern mc24lc32_t physicalEeprom;
 
-/// @brief Structure mapping the EEPROM's contents to C datatypes.
-static eepromMap_t* const physicalEepromMap = (eepromMap_t*) physicalEeprom.cache;
+/// @brief RAM copy of the active configuration profile, see @c peripheralsSelectProfile .
+extern eepromMap_t activeEepromMap;
+
+/// @brief Structure mapping the active configuration profile to C datatypes.
+static eepromMap_t* const physicalEepromMap = &activeEepromMap;
+
+/// @brief The index of the active configuration profile.
+extern uint8_t activeProfile;
+
+/// @brief Indicates the active profile has been modified via the calibration overlay, without being committed.
+extern bool overlayDirty;
+
+/// @brief Indicates the most recent call to @c peripheralsSelectProfile was rejected.
+extern bool profileRejected;
 
 /// @brief The VCU's virtual memory map. This aggregates all externally accessible memory into a single map for CAN-bus access.
 extern virtualEeprom_t virtualEeprom;
@@ -41,6 +89,13 @@ extern linearSensor_t glvBattery;
 /// @brief Analog sensors measuring the requests of the throttle and brake pedals.
 extern pedals_t pedals;
 
+/// @brief Filters of the APPS-1, APPS-2, BSE-F, BSE-R & GLV battery samples, applied prior to their sensors.
+extern sampleFilter_t apps1Filter;
+extern sampleFilter_t apps2Filter;
+extern sampleFilter_t bseFFilter;
+extern sampleFilter_t bseRFilter;
+extern sampleFilter_t glvBatteryFilter;
+
 /// @brief ADC measuring the steering-angle sensor.
 //extern am4096_t sasDriver;
 
@@ -54,15 +109,44 @@ extern sas_t sas;
 
 /**
  * @brief Initializes the VCU's peripherals.
+ * @param reconfigurePriority The priority to start the re-configuration thread at. Writes to the EEPROM map only schedule the
+ * affected peripherals for re-configuration, which this thread then performs. This should be lower than any time-critical
+ * threads, as re-configuration may involve I2C transactions.
  * @return False if a fatal peripheral failed to initialize, true otherwise.
  */
-bool peripheralsInit (void);
+bool peripheralsInit (tprio_t reconfigurePriority);
 
 /**
  * @brief Re-initializes the VCU's peripherals after a change has been made to the on-board EEPROM.
- * @param caller Ignored. Used to make function signature compatible with EEPROM dirty hook.
+ * @param groups Bitmask of the groups of EEPROM map fields to re-configure, see @c eepromMapGroup_t .
+ */
+void peripheralsReconfigure (uint16_t groups);
+
+/**
+ * @brief Switches the active configuration profile. This only affects the RAM copy of the configuration, the physical EEPROM
+ * is not written. Profile 0 is validated by the EEPROM's magic string, all others by their CRC.
+ * @param index The index of the profile to select.
+ * @return True if successful, false if the profile is invalid (the active profile is left unchanged).
  */
-void peripheralsReconfigure (void* caller);
+bool peripheralsSelectProfile (uint8_t index);
+
+/**
+ * @brief Calculates and stores the CRC of a configuration profile, marking its current contents as valid.
+ * @param index The index of the profile to seal.
+ * @return True if successful, false otherwise.
+ */
+bool peripheralsSealProfile (uint8_t index);
+
+/**
+ * @brief Commits the calibration overlay, writing the RAM copy of the active profile to its slot in the physical EEPROM.
+ * @return True if successful, false otherwise.
+ */
+bool peripheralsCommitOverlay (void);
+
+/**
+ * @brief Reverts the calibration overlay, discarding any uncommitted changes to the active profile.
+ */
+void peripheralsRevertOverlay (void);
 
 /**
  * @brief Samples all of the peripheral sensors. Must be done to update the values of the @c glvBattery , @c pedals , & @c sas
@@ -72,4 +156,22 @@ void peripheralsReconfigure (void* caller);
  */
 void peripheralsSample (systime_t timePrevious, systime_t timeCurrent);
 
+/**
+ * @brief Gets the health statistics of a sensor's samples since the last call for the sensor, see
+ * @c controls/sensor_health.h . The statistics are of the sensor's raw (filtered) samples, updated upon every call to
+ * @c peripheralsSample .
+ * @param channel The sensor to get the statistics of.
+ * @param stats Written to contain the statistics.
+ */
+void peripheralsTakeHealthStats (peripheralsHealthChannel_t channel, sensorHealthStats_t* stats);
+
+/**
+ * @brief Checks whether a range of addresses lies within a single region of @c virtualEeprom . Ranges spanning multiple
+ * regions, or any of the gaps between them, are rejected.
+ * @param addr The first address of the range.
+ * @param size The size of the range, in bytes.
+ * @return True if the range is valid, false otherwise.
+ */
+bool peripheralsCheckVirtualRange (uint16_t addr, uint16_t size);
+
 #endif // PERIPHERALS_H
\ No newline at end of file
@@ -0,0 +1,346 @@
+// Header
+#include "adc_stream.h"
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The frequency of the trigger timer's counter, in Hz.
+#define TIMER_FREQUENCY 1000000
+
+/// @brief The sampling time of every channel. At an ADC clock of 21 MHz, this is ~7.4 us per conversion.
+#define SAMPLE_TIME ADC_SAMPLE_144
+
+/// @brief The sampling time of VREFINT, which requires at least 10 us. At an ADC clock of 21 MHz, this is ~23 us.
+#define SAMPLE_TIME_VREFINT ADC_SAMPLE_480
+
+/// @brief The address of the VREFINT factory calibration, measured at a VDDA of 3.3 V. See the STM32F405 datasheet.
+#define VREFINT_CAL_ADDR ((const uint16_t*) 0x1FFF7A2A)
+
+/// @brief The range of plausible VREFINT calibrations (1.18 V to 1.24 V at a VDDA of 3.3 V).
+#define VREFINT_CAL_MIN 1464
+#define VREFINT_CAL_MAX 1539
+
+/// @brief The typical VREFINT calibration (1.21 V at a VDDA of 3.3 V), used should the factory calibration be implausible.
+#define VREFINT_CAL_TYPICAL 1501
+
+/// @brief The control bits of the analog watchdog, see the ADC_CR1 register. With AWDSGL clear, every channel is checked.
+#define WATCHDOG_CR1 (ADC_CR1_AWDEN | ADC_CR1_AWDIE)
+
+/// @brief The sample of the sensors' supply at its nominal voltage.
+#define SAMPLE_VDD 4095
+
+/// @brief The range of supply samples the analog watchdog window is widened to contain, as a fraction of @c SAMPLE_VDD . For
+/// the VREFINT channel, this is the range of VDDA (relative to its nominal voltage) instead.
+#define WATCHDOG_VDD_MIN_NUMERATOR		9
+#define WATCHDOG_VDD_MAX_NUMERATOR		11
+#define WATCHDOG_VDD_DENOMINATOR		10
+
+// Global Data ----------------------------------------------------------------------------------------------------------------
+
+/// @brief The active stream, see the note on the driver's callbacks.
+static adcStream_t* activeStream = NULL;
+
+// Function Prototypes --------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Callback for the completion of either half of the buffer.
+ */
+static void halfCallback (ADCDriver* adc);
+
+/**
+ * @brief Callback for a conversion error or analog watchdog trip. The driver stops the conversion upon either, so this
+ * restarts it.
+ */
+static void errorCallback (ADCDriver* adc, adcerror_t error);
+
+/**
+ * @brief Averages the samples of a half of the buffer.
+ * @param stream The stream to read from.
+ * @param half The half to read.
+ * @param samples Written to contain the sample of each channel.
+ */
+static void averageHalf (adcStream_t* stream, uint8_t half, uint16_t* samples);
+
+/**
+ * @brief Arms the analog watchdog. Must be called from a locked context.
+ */
+static void armWatchdogLocked (adcStream_t* stream);
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+bool adcStreamInit (adcStream_t* stream, const adcStreamConfig_t* config)
+{
+	stream->config = config;
+	stream->halfCount = 0;
+	stream->half = 0;
+	stream->halfValid = false;
+	stream->halfCountPrevious = 0;
+	stream->errorCount = 0;
+	stream->watchdogCount = 0;
+	stream->watchdogEnabled = false;
+	stream->watchdogCallback = NULL;
+	stream->watchdogObject = NULL;
+	stream->sampleVdd = SAMPLE_VDD;
+
+	if (config->channelCount == 0 || config->channelCount > ADC_STREAM_CHANNEL_COUNT_MAX || config->depth == 0 ||
+		config->depth > ADC_STREAM_DEPTH_MAX || config->frequency == 0 || config->frequency > TIMER_FREQUENCY ||
+		config->supplyIndex >= config->channelCount || config->vrefintIndex >= config->channelCount)
+		return false;
+
+	if (config->vrefintIndex >= 0)
+	{
+		// VREFINT must be connected to the ADC prior to being sampled.
+		adcSTM32EnableTSVREFE ();
+
+		stream->vrefintCal = *VREFINT_CAL_ADDR;
+		if (stream->vrefintCal < VREFINT_CAL_MIN || stream->vrefintCal > VREFINT_CAL_MAX)
+			stream->vrefintCal = VREFINT_CAL_TYPICAL;
+	}
+
+	// Build the conversion group. Each sequence converts every channel once, started by the rising edge of the timer's TRGO.
+	stream->group = (ADCConversionGroup)
+	{
+		.circular		= true,
+		.num_channels	= config->channelCount,
+		.end_cb			= halfCallback,
+		.error_cb		= errorCallback,
+		.cr1			= 0,
+		.cr2			= ADC_CR2_EXTEN_RISING | config->extsel,
+		.smpr1			= 0,
+		.smpr2			= 0,
+		.htr			= 0,
+		.ltr			= 0,
+		.sqr1			= 0,
+		.sqr2			= 0,
+		.sqr3			= 0
+	};
+
+	for (uint8_t index = 0; index < config->channelCount; ++index)
+	{
+		const adcStreamChannel_t* channel = &config->channels [index];
+		if (channel->oversampling == 0 || channel->oversampling > config->depth)
+			return false;
+
+		// Sampling time, see the ADC_SMPR1 & ADC_SMPR2 registers.
+		uint32_t sampleTime = channel->channel == ADC_CHANNEL_VREFINT ? SAMPLE_TIME_VREFINT : SAMPLE_TIME;
+		if (channel->channel < 10)
+			stream->group.smpr2 |= sampleTime << (3 * channel->channel);
+		else
+			stream->group.smpr1 |= sampleTime << (3 * (channel->channel - 10));
+
+		// Sequence position, see the ADC_SQR2 & ADC_SQR3 registers.
+		if (index < 6)
+			stream->group.sqr3 |= (uint32_t) channel->channel << (5 * index);
+		else
+			stream->group.sqr2 |= (uint32_t) channel->channel << (5 * (index - 6));
+	}
+
+	activeStream = stream;
+
+	// Start the conversions, these don't begin until the timer is started.
+	adcStart (config->driver, NULL);
+	adcStartConversion (config->driver, &stream->group, stream->buffer, 2 * config->depth);
+
+	// The timer's update event drives its TRGO output.
+	stream->timerConfig = (GPTConfig)
+	{
+		.frequency	= TIMER_FREQUENCY,
+		.callback	= NULL,
+		.cr2		= TIM_CR2_MMS_1,
+		.dier		= 0
+	};
+	gptStart (config->timer, &stream->timerConfig);
+	gptStartContinuous (config->timer, TIMER_FREQUENCY / config->frequency);
+
+	return true;
+}
+
+void adcStreamSample (adcStream_t* stream)
+{
+	const adcStreamConfig_t* config = stream->config;
+
+	// Re-arm the watchdog, should it have tripped since the previous sample.
+	chSysLock ();
+	if (stream->watchdogEnabled)
+		armWatchdogLocked (stream);
+	chSysUnlock ();
+
+	uint16_t samples [ADC_STREAM_CHANNEL_COUNT_MAX];
+	uint32_t halfCount;
+	while (true)
+	{
+		chSysLock ();
+		halfCount = stream->halfCount;
+		uint8_t half = stream->half;
+		bool halfValid = stream->halfValid;
+		chSysUnlock ();
+
+		if (halfCount == stream->halfCountPrevious)
+		{
+			// The stream has stalled, invalidate the sensors rather than passing them stale samples.
+			for (uint8_t index = 0; index < config->channelCount; ++index)
+				if (config->channels [index].sensor != NULL)
+					config->channels [index].sensor->state = ANALOG_SENSOR_SAMPLE_INVALID;
+			return;
+		}
+
+		if (!halfValid)
+		{
+			// The half is being overwritten by a restarted conversion, so leave the sensors with their previous samples.
+			stream->halfCountPrevious = halfCount;
+			return;
+		}
+
+		averageHalf (stream, half, samples);
+
+		// If another half completed, or the conversion restarted, while reading, the DMA may have started overwriting this
+		// one, so read again.
+		chSysLock ();
+		bool overwritten = stream->halfCount != halfCount || !stream->halfValid;
+		chSysUnlock ();
+		if (!overwritten)
+			break;
+	}
+	stream->halfCountPrevious = halfCount;
+
+	// Determine the sample of the sensors' supply, see the description.
+	uint16_t sampleVdd = SAMPLE_VDD;
+	if (config->supplyIndex >= 0)
+		sampleVdd = samples [config->supplyIndex];
+	else if (config->vrefintIndex >= 0)
+		sampleVdd = (uint32_t) SAMPLE_VDD * samples [config->vrefintIndex] / stream->vrefintCal;
+	stream->sampleVdd = sampleVdd;
+
+	for (uint8_t index = 0; index < config->channelCount; ++index)
+	{
+		stream->samples [index] = samples [index];
+
+		const adcStreamChannel_t* channel = &config->channels [index];
+		if (channel->sensor == NULL)
+			continue;
+
+		uint16_t sample = samples [index];
+		if (channel->filter != NULL)
+			sample = sampleFilterUpdate (channel->filter, sample);
+
+		channel->sensor->callback (channel->sensor, sample, sampleVdd);
+	}
+}
+
+void adcStreamEnableWatchdog (adcStream_t* stream, uint16_t low, uint16_t high, adcStreamWatchdog_t* callback, void* object)
+{
+	const adcStreamConfig_t* config = stream->config;
+	ADC_TypeDef* adc = config->driver->adc;
+
+	// The window applies to every channel of the sequence, so must contain the expected range of the channels without a
+	// sensor. Otherwise these would trip the watchdog upon every sequence.
+	if (config->supplyIndex >= 0)
+	{
+		uint16_t supplyLow = (uint32_t) SAMPLE_VDD * WATCHDOG_VDD_MIN_NUMERATOR / WATCHDOG_VDD_DENOMINATOR;
+		if (low > supplyLow)
+			low = supplyLow;
+		high = SAMPLE_VDD;
+	}
+
+	if (config->vrefintIndex >= 0)
+	{
+		// VREFINT is fixed, so its sample is inversely proportional to VDDA.
+		uint16_t vrefintLow = (uint32_t) stream->vrefintCal * WATCHDOG_VDD_DENOMINATOR / WATCHDOG_VDD_MAX_NUMERATOR;
+		uint16_t vrefintHigh = (uint32_t) stream->vrefintCal * WATCHDOG_VDD_DENOMINATOR / WATCHDOG_VDD_MIN_NUMERATOR;
+		if (low > vrefintLow)
+			low = vrefintLow;
+		if (high < vrefintHigh)
+			high = vrefintHigh;
+	}
+
+	chSysLock ();
+
+	stream->watchdogCallback = callback;
+	stream->watchdogObject = object;
+	stream->watchdogEnabled = true;
+
+	// The group's copy of the registers applies upon a restart, the peripheral's applies immediately.
+	stream->group.htr = high;
+	stream->group.ltr = low;
+	adc->HTR = high;
+	adc->LTR = low;
+	armWatchdogLocked (stream);
+
+	chSysUnlock ();
+}
+
+void adcStreamDisableWatchdog (adcStream_t* stream)
+{
+	chSysLock ();
+
+	stream->watchdogEnabled = false;
+	stream->group.cr1 &= ~WATCHDOG_CR1;
+	stream->config->driver->adc->CR1 &= ~WATCHDOG_CR1;
+
+	chSysUnlock ();
+}
+
+void halfCallback (ADCDriver* adc)
+{
+	// The buffer is complete upon the second half being filled.
+	activeStream->half = adcIsBufferComplete (adc) ? 1 : 0;
+	activeStream->halfValid = true;
+	++activeStream->halfCount;
+}
+
+void errorCallback (ADCDriver* adc, adcerror_t error)
+{
+	adcStream_t* stream = activeStream;
+
+	chSysLockFromISR ();
+
+	if (error == ADC_ERR_AWD)
+	{
+		++stream->watchdogCount;
+
+		// Disarm the watchdog until the next sample, otherwise a persistent fault would trip it upon every sequence.
+		stream->group.cr1 &= ~WATCHDOG_CR1;
+
+		// The driver has stopped the DMA, so its position indicates the conversion that tripped the watchdog (the last one
+		// transferred).
+		size_t count = 2 * stream->config->depth * stream->config->channelCount;
+		size_t index = (2 * count - dmaStreamGetTransactionSize (adc->dmastp) - 1) % count;
+		analogSensor_t* sensor = stream->config->channels [index % stream->config->channelCount].sensor;
+
+		if (stream->watchdogCallback != NULL && sensor != NULL)
+			stream->watchdogCallback (stream->watchdogObject, sensor, stream->buffer [index], stream->sampleVdd);
+	}
+	else
+		++stream->errorCount;
+
+	// The restarted conversion fills the first half, so that half can't be sampled until the next half completes. The second
+	// half is left intact, as it isn't written until the first completes.
+	if (stream->half == 0)
+		stream->halfValid = false;
+
+	adcStartConversionI (adc, &stream->group, stream->buffer, 2 * stream->config->depth);
+
+	chSysUnlockFromISR ();
+}
+
+void averageHalf (adcStream_t* stream, uint8_t half, uint16_t* samples)
+{
+	const adcStreamConfig_t* config = stream->config;
+	const adcsample_t* buffer = stream->buffer + half * config->depth * config->channelCount;
+
+	for (uint8_t index = 0; index < config->channelCount; ++index)
+	{
+		// Average the most recent conversions of the channel.
+		uint8_t oversampling = config->channels [index].oversampling;
+		uint32_t sum = 0;
+		for (uint8_t sequence = config->depth - oversampling; sequence < config->depth; ++sequence)
+			sum += buffer [sequence * config->channelCount + index];
+
+		samples [index] = (sum + oversampling / 2) / oversampling;
+	}
+}
+
+void armWatchdogLocked (adcStream_t* stream)
+{
+	stream->group.cr1 |= WATCHDOG_CR1;
+	stream->config->driver->adc->CR1 |= WATCHDOG_CR1;
+}
\ No newline at end of file
@@ -0,0 +1,174 @@
+#ifndef ADC_STREAM_H
+#define ADC_STREAM_H
+
+// STM32 Continuous ADC Acquisition -------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.19
+//
+// Description: Continuous, timer-triggered acquisition of a set of ADC channels. Rather than starting a conversion and waiting
+//   for it to complete (as the stm_adc driver does), a timer triggers a conversion of every channel at a fixed rate. The DMA
+//   writes the samples into a circular buffer split into two halves: while one half is being filled, the other holds the most
+//   recently completed set of sequences. Sampling therefore never waits for a conversion, it only reads the completed half.
+//
+//   The STM32F405's ADC has no hardware oversampling, so oversampling is done in software: each half holds multiple sequences,
+//   and each channel's sample is the average of its most recent N conversions in the half (N being configurable per channel).
+//   Averaging N conversions reduces uncorrelated noise by a factor of sqrt (N), without adding latency to the reader.
+//
+//   Each sample is passed to its sensor along with the sample the sensors' supply would read (sampleVdd), allowing the sensor
+//   to correct ratiometrically for deviations of the supply. This is determined by (in order of preference):
+//   - A channel measuring the supply directly (through the same divider as the sensors).
+//   - A channel measuring VREFINT. The sensors' supply is assumed to be regulated independently of the ADC's reference
+//     (VDDA), such that its sample is full-scale at the nominal VDDA (3.3 V). Any deviation of VDDA scales every sample
+//     equally, which is measured by the deviation of the VREFINT sample from its factory calibration.
+//   - Neither, in which case the supply is assumed to be full-scale.
+//   Channels measuring the supply or VREFINT have no sensor.
+//
+//   The ADC's analog watchdog can be armed to check every conversion against a window, interrupting upon any conversion
+//   outside of it. This detects a fault (for instance, a broken wire) within a single conversion, rather than upon the next
+//   sample. The ADC has only one watchdog, the window of which applies to every channel of the sequence, so the watchdog's
+//   callback must check the sample against the channel's own limits. For the same reason, the window must contain the
+//   expected range of every channel, otherwise a channel that is operating normally would trip it upon every sequence (each
+//   trip restarting the conversion). The window is widened to contain the expected range of the supply and VREFINT channels
+//   (a VDDA within 10% of nominal), that of any sensor channels is the caller's responsibility. The watchdog is disarmed upon
+//   tripping, and re-armed upon the next sample, limiting the rate of interrupts should a fault persist. Each trip (or
+//   conversion error) restarts the DMA from the start of the buffer, overwriting the first half. Should that be the most
+//   recently completed half, it is marked invalid until the next half completes, and isn't sampled.
+//
+//   Only a single stream per ADC is supported, as the driver's callbacks don't provide a user pointer.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "controls/sample_filter.h"
+#include "peripherals/interface/analog_sensor.h"
+
+// ChibiOS
+#include "hal.h"
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The maximum number of channels in a stream.
+#define ADC_STREAM_CHANNEL_COUNT_MAX 8
+
+/// @brief The maximum number of sequences in each half of the buffer (the maximum oversampling ratio).
+#define ADC_STREAM_DEPTH_MAX 16
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Callback for a conversion outside of the analog watchdog's window. Called from the ADC's ISR, in a locked context.
+ * @param object The object the watchdog was armed with.
+ * @param sensor The sensor of the channel that was out of the window.
+ * @param sample The sample that was out of the window.
+ * @param sampleVdd The most recent sample of the sensors' supply, see @c adcStream_t .
+ */
+typedef void (adcStreamWatchdog_t) (void* object, analogSensor_t* sensor, uint16_t sample, uint16_t sampleVdd);
+
+typedef struct
+{
+	/// @brief The ADC channel to convert, see @c ADC_CHANNEL_IN0 and similar.
+	uint8_t channel;
+	/// @brief The sensor to pass the channel's samples to, @c NULL for none.
+	analogSensor_t* sensor;
+	/// @brief The number of conversions to average, 1 (no oversampling) through the depth of the stream.
+	uint8_t oversampling;
+	/// @brief The filter to pass the channel's (oversampled) samples through before the sensor, @c NULL for none.
+	sampleFilter_t* filter;
+} adcStreamChannel_t;
+
+typedef struct
+{
+	/// @brief The ADC driver to use.
+	ADCDriver* driver;
+	/// @brief The timer triggering each sequence of conversions. The timer's TRGO output must be connected to @c extsel .
+	GPTDriver* timer;
+	/// @brief The ADC's external trigger selection corresponding to @c timer , see the EXTSEL field of the ADC_CR2 register.
+	uint32_t extsel;
+	/// @brief The rate at which sequences are converted, in Hz.
+	uint32_t frequency;
+	/// @brief The number of sequences in each half of the buffer. Each half completes every @c depth / @c frequency seconds.
+	uint8_t depth;
+	/// @brief The channels to convert.
+	adcStreamChannel_t channels [ADC_STREAM_CHANNEL_COUNT_MAX];
+	/// @brief The number of elements in @c channels .
+	uint8_t channelCount;
+	/// @brief The index of the channel measuring the sensors' supply, -1 if not measured.
+	int8_t supplyIndex;
+	/// @brief The index of the channel measuring VREFINT ( @c ADC_CHANNEL_VREFINT ), -1 if not measured.
+	int8_t vrefintIndex;
+} adcStreamConfig_t;
+
+typedef struct
+{
+	const adcStreamConfig_t* config;
+	/// @brief The driver's conversion group, derived from the configuration.
+	ADCConversionGroup group;
+	/// @brief The DMA buffer, two halves of @c depth sequences each.
+	adcsample_t buffer [2 * ADC_STREAM_DEPTH_MAX * ADC_STREAM_CHANNEL_COUNT_MAX];
+	/// @brief The configuration of the trigger timer.
+	GPTConfig timerConfig;
+	/// @brief The number of halves completed.
+	uint32_t halfCount;
+	/// @brief The most recently completed half, 0 or 1.
+	uint8_t half;
+	/// @brief Indicates whether @c half is intact, false if a restart of the conversion has started overwriting it.
+	bool halfValid;
+	/// @brief The value of @c halfCount upon the previous sample.
+	uint32_t halfCountPrevious;
+	/// @brief The number of conversion errors (overruns, DMA failures) that have occurred.
+	uint16_t errorCount;
+	/// @brief The number of times the analog watchdog has tripped.
+	uint16_t watchdogCount;
+	/// @brief Indicates whether the analog watchdog is enabled (though it may be disarmed until the next sample).
+	bool watchdogEnabled;
+	/// @brief The callback of the analog watchdog.
+	adcStreamWatchdog_t* watchdogCallback;
+	/// @brief The object to pass to @c watchdogCallback .
+	void* watchdogObject;
+	/// @brief The most recent (oversampled, unfiltered) sample of each channel.
+	uint16_t samples [ADC_STREAM_CHANNEL_COUNT_MAX];
+	/// @brief The most recent sample of the sensors' supply, see the description.
+	uint16_t sampleVdd;
+	/// @brief The sample of VREFINT at the nominal VDDA, from the factory calibration.
+	uint16_t vrefintCal;
+} adcStream_t;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Initializes the stream, starting the ADC & trigger timer.
+ * @param stream The stream to initialize.
+ * @param config The configuration to use. Must remain in scope.
+ * @return False if the configuration is invalid or a driver failed to start, true otherwise.
+ */
+bool adcStreamInit (adcStream_t* stream, const adcStreamConfig_t* config);
+
+/**
+ * @brief Samples the most recently completed half of the buffer, passing the sample of each channel to its sensor. This never
+ * waits for a conversion. If no half has completed since the previous call, the sensors are marked as invalid, as the stream
+ * has stalled. If the most recently completed half has been invalidated by a restart, the sensors are left unchanged, as the
+ * next half completes within @c depth / @c frequency seconds. If enabled, the analog watchdog is re-armed.
+ * @param stream The stream to sample.
+ */
+void adcStreamSample (adcStream_t* stream);
+
+/**
+ * @brief Enables the analog watchdog, arming it immediately.
+ * @param stream The stream to enable the watchdog of.
+ * @param low The lowest sample inside the window. Must be no greater than the expected range of every sensor channel. This is
+ * lowered to contain the expected range of the supply and VREFINT channels.
+ * @param high The highest sample inside the window. Must be no less than the expected range of every sensor channel. This is
+ * raised to contain the expected range of the supply and VREFINT channels.
+ * @param callback The callback to invoke upon a sample outside of the window.
+ * @param object The object to pass to @c callback .
+ */
+void adcStreamEnableWatchdog (adcStream_t* stream, uint16_t low, uint16_t high, adcStreamWatchdog_t* callback, void* object);
+
+/**
+ * @brief Disables the analog watchdog.
+ * @param stream The stream to disable the watchdog of.
+ */
+void adcStreamDisableWatchdog (adcStream_t* stream);
+
+#endif // ADC_STREAM_H
\ No newline at end of file
@@ -0,0 +1,356 @@
+// Header
+#include "eeprom_cache.h"
+
+// C Standard Library
+#include <string.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The size of the MC24LC32, in bytes.
+#define EEPROM_SIZE (EEPROM_CACHE_PAGE_COUNT * EEPROM_CACHE_PAGE_SIZE)
+
+/// @brief Event signalled upon every write.
+#define WRITE_EVENT EVENT_MASK (0)
+
+/// @brief Event signalled upon a flush request.
+#define FLUSH_EVENT EVENT_MASK (1)
+
+/// @brief The interval at which to poll for the completion of a write cycle.
+#define WRITE_POLL_PERIOD TIME_MS2I (1)
+
+/// @brief The maximum number of times to poll for the completion of a write cycle. The datasheet's maximum write time is 5 ms.
+#define WRITE_POLL_COUNT 10
+
+// Global Data ----------------------------------------------------------------------------------------------------------------
+
+eeprom_t eepromCache;
+
+uint16_t eepromCacheDirtyCount = 0;
+
+event_source_t eepromCacheEventSource;
+
+/// @brief The EEPROM being cached.
+static mc24lc32_t* cachedEeprom;
+
+/// @brief Bitmask of the dirty pages, bit N of word M corresponding to page 32M + N.
+static uint32_t dirtyPages [EEPROM_CACHE_PAGE_COUNT / 32];
+
+/// @brief The configuration of the EEPROM being cached.
+static const mc24lc32Config_t* cachedConfig;
+
+/// @brief The supervisor of the EEPROM's bus.
+static i2cSupervisor_t* busSupervisor;
+
+/// @brief The size of the region loaded during initialization.
+static uint16_t bootSize;
+
+/// @brief Indicates the background load of the EEPROM is complete.
+static bool loaded = false;
+
+/// @brief Indicates the background load of the EEPROM failed. The RAM mirror outside of the boot region is invalid, so no
+/// writes are accepted (a page write-back would overwrite the device with zeros).
+static bool loadFailed = false;
+
+/// @brief Mutex protecting the RAM mirror, @c dirtyPages , @c loaded , & @c loadFailed .
+static mutex_t cacheMutex;
+
+/// @brief Condition signalled upon @c loaded being set.
+static condition_variable_t loadedCondition;
+
+/// @brief The flush thread.
+static thread_t* flushThread;
+
+// Function Prototypes --------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Writes to the RAM mirror, marking the affected pages as dirty.
+ */
+static bool cacheWrite (void* object, uint16_t addr, const void* data, uint16_t dataCount);
+
+/**
+ * @brief Reads from the RAM mirror.
+ */
+static bool cacheRead (void* object, uint16_t addr, void* data, uint16_t dataCount);
+
+/**
+ * @brief Writes all dirty pages back to the EEPROM. Stops early if a write fails, leaving the remaining pages dirty.
+ */
+static void flushPages (void);
+
+/**
+ * @brief Writes a single page to the EEPROM and waits for the write cycle to complete.
+ * @param page The index of the page to write.
+ * @param data The contents of the page.
+ * @return True if successful, false otherwise.
+ */
+static bool writePage (uint16_t page, const uint8_t* data);
+
+/**
+ * @brief Blocks until the background load is complete. Must be called with @c cacheMutex locked.
+ */
+static void waitLoadLocked (void);
+
+/**
+ * @brief Validates the magic string of the RAM mirror, updating the EEPROM's state accordingly. Broadcasts
+ * @c eepromCacheEventSource if the state changed.
+ */
+static void validateMagic (void);
+
+// Thread Entrypoint ----------------------------------------------------------------------------------------------------------
+
+static THD_WORKING_AREA (eepromCacheThreadWa, 512);
+THD_FUNCTION (eepromCacheThread, arg)
+{
+	(void) arg;
+	chRegSetThreadName ("eeprom_cache");
+
+	// Initialize the EEPROM driver, loading the remainder of the device. This re-reads the boot region, but as no writes are
+	// accepted until this completes, its contents are unchanged. The driver doesn't recover from a stuck bus, so if the load
+	// fails due to one, it is retried once the bus is recovered.
+	mc24lc32State_t statePrevious = cachedEeprom->state;
+	uint16_t recoveryCount = busSupervisor->recoveryCount;
+	mc24lc32Init (cachedEeprom, cachedConfig);
+	if (cachedEeprom->state == MC24LC32_STATE_FAILED && i2cSupervisorCheck (busSupervisor) &&
+		busSupervisor->recoveryCount != recoveryCount)
+		mc24lc32Init (cachedEeprom, cachedConfig);
+
+	chMtxLock (&cacheMutex);
+	loaded = true;
+	loadFailed = cachedEeprom->state == MC24LC32_STATE_FAILED;
+	chCondBroadcast (&loadedCondition);
+	chMtxUnlock (&cacheMutex);
+
+	if (cachedEeprom->state != statePrevious)
+		chEvtBroadcast (&eepromCacheEventSource);
+
+	while (true)
+	{
+		// Wait for the first write. If pages were left dirty by a failed flush, retry after the quiet period.
+		eventmask_t events = chEvtWaitAnyTimeout (ALL_EVENTS, eepromCacheDirtyCount == 0 ? TIME_INFINITE :
+			EEPROM_CACHE_QUIET_PERIOD);
+
+		// Wait for the writes to stop, unless a flush was requested. A continuous stream of writes is only deferred for so
+		// long, such that it can't postpone the write-back indefinitely.
+		systime_t timeStart = chVTGetSystemTimeX ();
+		while (events != 0 && (events & FLUSH_EVENT) == 0)
+		{
+			sysinterval_t elapsed = chVTTimeElapsedSinceX (timeStart);
+			if (elapsed >= EEPROM_CACHE_DEFERRAL_MAX)
+				break;
+
+			sysinterval_t timeout = EEPROM_CACHE_DEFERRAL_MAX - elapsed;
+			if (timeout > EEPROM_CACHE_QUIET_PERIOD)
+				timeout = EEPROM_CACHE_QUIET_PERIOD;
+
+			events = chEvtWaitAnyTimeout (ALL_EVENTS, timeout);
+		}
+
+		// Nothing can be written back if the load failed. Writes are rejected, so this is only a precaution.
+		if (!loadFailed)
+			flushPages ();
+	}
+}
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+bool eepromCacheInit (mc24lc32_t* eeprom, const mc24lc32Config_t* config, i2cSupervisor_t* supervisor, uint16_t size,
+	tprio_t priority)
+{
+	cachedEeprom = eeprom;
+	cachedConfig = config;
+	busSupervisor = supervisor;
+	bootSize = size;
+	chMtxObjectInit (&cacheMutex);
+	chCondObjectInit (&loadedCondition);
+	chEvtObjectInit (&eepromCacheEventSource);
+	eepromInit (&eepromCache, cacheWrite, cacheRead);
+
+	// Load the boot region as a single sequential read, starting from word address 0.
+	uint8_t tx [2] = { 0x00, 0x00 };
+	msg_t result = i2cSupervisorTransmit (supervisor, config->addr, tx, sizeof (tx), eeprom->cache, bootSize, config->timeout);
+
+	if (result != MSG_OK)
+	{
+		eeprom->state = MC24LC32_STATE_FAILED;
+		return false;
+	}
+
+	// Validate the magic string. This is repeated by the driver once loaded.
+	validateMagic ();
+
+	flushThread = chThdCreateStatic (&eepromCacheThreadWa, sizeof (eepromCacheThreadWa), priority, eepromCacheThread, NULL);
+	return true;
+}
+
+void eepromCacheWaitLoad (void)
+{
+	chMtxLock (&cacheMutex);
+	waitLoadLocked ();
+	chMtxUnlock (&cacheMutex);
+}
+
+void eepromCacheFlush (void)
+{
+	chEvtSignal (flushThread, FLUSH_EVENT);
+}
+
+bool cacheWrite (void* object, uint16_t addr, const void* data, uint16_t dataCount)
+{
+	(void) object;
+
+	if (dataCount == 0 || addr + dataCount > EEPROM_SIZE)
+		return false;
+
+	chMtxLock (&cacheMutex);
+	waitLoadLocked ();
+
+	if (loadFailed)
+	{
+		chMtxUnlock (&cacheMutex);
+		return false;
+	}
+
+	// Writes to the magic string (including its terminator) re-validate it.
+	bool magicWritten = addr <= strlen (cachedConfig->magicString);
+
+	// Split the write at page boundaries, only marking pages whose contents actually change.
+	const uint8_t* source = data;
+	uint16_t end = addr + dataCount;
+	while (addr < end)
+	{
+		uint16_t page = addr / EEPROM_CACHE_PAGE_SIZE;
+		uint16_t count = (page + 1) * EEPROM_CACHE_PAGE_SIZE - addr;
+		if (count > end - addr)
+			count = end - addr;
+
+		uint32_t mask = 1 << (page % 32);
+		if (memcmp (cachedEeprom->cache + addr, source, count) != 0)
+		{
+			memcpy (cachedEeprom->cache + addr, source, count);
+			if ((dirtyPages [page / 32] & mask) == 0)
+			{
+				dirtyPages [page / 32] |= mask;
+				++eepromCacheDirtyCount;
+			}
+		}
+
+		addr += count;
+		source += count;
+	}
+
+	if (magicWritten)
+		validateMagic ();
+
+	chMtxUnlock (&cacheMutex);
+
+	chEvtSignal (flushThread, WRITE_EVENT);
+	return true;
+}
+
+bool cacheRead (void* object, uint16_t addr, void* data, uint16_t dataCount)
+{
+	(void) object;
+
+	if (addr + dataCount > EEPROM_SIZE)
+		return false;
+
+	chMtxLock (&cacheMutex);
+	if (addr + dataCount > bootSize)
+	{
+		// Outside of the boot region, the mirror is only valid once loaded.
+		waitLoadLocked ();
+		if (loadFailed)
+		{
+			chMtxUnlock (&cacheMutex);
+			return false;
+		}
+	}
+	memcpy (data, cachedEeprom->cache + addr, dataCount);
+	chMtxUnlock (&cacheMutex);
+
+	return true;
+}
+
+void flushPages (void)
+{
+	for (uint16_t page = 0; page < EEPROM_CACHE_PAGE_COUNT; ++page)
+	{
+		uint32_t mask = 1 << (page % 32);
+
+		// Snapshot the page, clearing its dirty bit. Any write made during the write cycle re-marks it.
+		uint8_t data [EEPROM_CACHE_PAGE_SIZE];
+		chMtxLock (&cacheMutex);
+		bool dirty = (dirtyPages [page / 32] & mask) != 0;
+		if (dirty)
+		{
+			memcpy (data, cachedEeprom->cache + page * EEPROM_CACHE_PAGE_SIZE, EEPROM_CACHE_PAGE_SIZE);
+			dirtyPages [page / 32] &= ~mask;
+			--eepromCacheDirtyCount;
+		}
+		chMtxUnlock (&cacheMutex);
+
+		if (!dirty)
+			continue;
+
+		if (!writePage (page, data))
+		{
+			// Re-mark the page, unless it was already re-marked by a write.
+			chMtxLock (&cacheMutex);
+			if ((dirtyPages [page / 32] & mask) == 0)
+			{
+				dirtyPages [page / 32] |= mask;
+				++eepromCacheDirtyCount;
+			}
+			chMtxUnlock (&cacheMutex);
+			return;
+		}
+	}
+}
+
+bool writePage (uint16_t page, const uint8_t* data)
+{
+	const mc24lc32Config_t* config = cachedEeprom->config;
+	uint16_t addr = page * EEPROM_CACHE_PAGE_SIZE;
+
+	// Word address (big endian), followed by the page's data.
+	uint8_t tx [2 + EEPROM_CACHE_PAGE_SIZE] = { addr >> 8, addr & 0xFF };
+	memcpy (tx + 2, data, EEPROM_CACHE_PAGE_SIZE);
+
+	msg_t result = i2cSupervisorTransmit (busSupervisor, config->addr, tx, sizeof (tx), NULL, 0, config->timeout);
+
+	if (result != MSG_OK)
+		return false;
+
+	// Acknowledge polling: the device doesn't acknowledge its address until the write cycle is complete. Other transactions
+	// may use the bus in between polls.
+	for (uint8_t index = 0; index < WRITE_POLL_COUNT; ++index)
+	{
+		chThdSleep (WRITE_POLL_PERIOD);
+
+		result = i2cSupervisorTransmit (busSupervisor, config->addr, tx, 2, NULL, 0, config->timeout);
+
+		if (result == MSG_OK)
+			return true;
+	}
+
+	return false;
+}
+
+void waitLoadLocked (void)
+{
+	while (!loaded)
+		chCondWait (&loadedCondition);
+}
+
+void validateMagic (void)
+{
+	mc24lc32State_t state = MC24LC32_STATE_INVALID;
+	if (strncmp ((const char*) cachedEeprom->cache, cachedConfig->magicString, bootSize) == 0)
+		state = MC24LC32_STATE_READY;
+
+	if (cachedEeprom->state == state)
+		return;
+
+	cachedEeprom->state = state;
+	chEvtBroadcast (&eepromCacheEventSource);
+}
\ No newline at end of file
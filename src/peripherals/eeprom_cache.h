@@ -0,0 +1,92 @@
+#ifndef EEPROM_CACHE_H
+#define EEPROM_CACHE_H
+
+// MC24LC32 Write-Back Cache --------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.19
+//
+// Description: Write-back layer over the MC24LC32's RAM mirror. Configuration edits over CAN arrive as many small writes,
+//   each of which would otherwise cost a full page write cycle (~5 ms) of I2C bus time and wear. Instead, writes only update
+//   the RAM mirror (taking effect immediately) and mark the pages they touch as dirty. Once no writes have been made for a
+//   quiet period, or when a flush is requested, a background thread writes each dirty page back in a single page-write
+//   transaction. Any number of writes to the same page therefore cost one transaction, and writes that don't change a
+//   page's contents cost none. A continuous stream of writes only defers the write-back up to a maximum period.
+//
+//   All writes must be made through the cache, including those to the magic string. Writes touching the magic string
+//   re-validate it, updating the EEPROM's state.
+//
+//   Any change in the EEPROM's state (the background load failing, or the magic string being written) is signalled by the
+//   @c eepromCacheEventSource , such that consumers needn't poll the state.
+//
+//   Completion of a write cycle is detected via acknowledge polling (see section 7.0 of the 24LC32A datasheet), rather than
+//   waiting the worst-case write time.
+//
+//   To shorten the boot time, the EEPROM is loaded in two stages. Only the region needed to configure the vehicle (the EEPROM
+//   map) is read during initialization, as a single sequential read. The MC24LC32 driver is then initialized in the
+//   background, loading the remainder of the device. Any access outside of the boot region blocks until the background load
+//   is complete. Should the background load fail, all writes, and any reads outside of the boot region, are rejected.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "peripherals/i2c/mc24lc32.h"
+#include "peripherals/i2c_supervisor.h"
+
+// ChibiOS
+#include "ch.h"
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The page size of the MC24LC32, in bytes. Page writes cannot cross a page boundary.
+#define EEPROM_CACHE_PAGE_SIZE 32
+
+/// @brief The number of pages in the MC24LC32.
+#define EEPROM_CACHE_PAGE_COUNT (4096 / EEPROM_CACHE_PAGE_SIZE)
+
+/// @brief The amount of time without writes after which the dirty pages are flushed.
+#define EEPROM_CACHE_QUIET_PERIOD TIME_MS2I (100)
+
+/// @brief The maximum amount of time the dirty pages are deferred for, regardless of further writes.
+#define EEPROM_CACHE_DEFERRAL_MAX TIME_MS2I (1000)
+
+// Global Data ----------------------------------------------------------------------------------------------------------------
+
+/// @brief EEPROM interface to the write-back cache. Reads & writes are in the same address space as the MC24LC32.
+extern eeprom_t eepromCache;
+
+/// @brief The number of pages awaiting write-back.
+extern uint16_t eepromCacheDirtyCount;
+
+/// @brief Event source broadcast upon the state of the cached EEPROM changing.
+extern event_source_t eepromCacheEventSource;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Initializes the write-back cache, loading the boot region of the EEPROM, then starts the flush thread. The thread
+ * initializes the EEPROM driver prior to accepting any writes.
+ * @param eeprom The EEPROM to cache. Initialized by the flush thread.
+ * @param config The configuration of the EEPROM. Must remain in scope.
+ * @param supervisor The supervisor of the EEPROM's bus, used for all transactions made by the cache.
+ * @param bootSize The size of the boot region, in bytes. This region, starting at address 0, is loaded immediately.
+ * @param priority The priority to start the flush thread at.
+ * @return False if the boot region could not be read, true otherwise. Note the magic string not matching is not considered a
+ * failure, this is indicated by the EEPROM's state.
+ */
+bool eepromCacheInit (mc24lc32_t* eeprom, const mc24lc32Config_t* config, i2cSupervisor_t* supervisor, uint16_t bootSize,
+	tprio_t priority);
+
+/**
+ * @brief Blocks until the background load of the EEPROM is complete. Must be called prior to directly accessing the
+ * EEPROM's RAM mirror outside of the boot region.
+ */
+void eepromCacheWaitLoad (void);
+
+/**
+ * @brief Requests all dirty pages be flushed immediately, rather than after the quiet period. This does not block, completion
+ * is indicated by @c eepromCacheDirtyCount reaching 0.
+ */
+void eepromCacheFlush (void);
+
+#endif // EEPROM_CACHE_H
\ No newline at end of file
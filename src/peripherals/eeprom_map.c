@@ -3,55 +3,100 @@
 
 // Includes
 #include "can.h"
+#include "capture.h"
+#include "counters.h"
+#include "journal.h"
+#include "controls/amk_estimator.h"
+#include "controls/steering_estimator.h"
+#include "can/can_rx.h"
 #include "peripherals.h"
+#include "peripherals/eeprom_cache.h"
 #include "torque_thread.h"
 
 // C Standard Library
+#include <stddef.h>
 #include <string.h>
 
 // Global Data ----------------------------------------------------------------------------------------------------------------
 
-#define READONLY_COUNT (sizeof (READONLY_ADDRS) / sizeof (READONLY_ADDRS [0]))
-static const uint16_t READONLY_ADDRS [] =
+/// @brief Entry of the read-only layout table.
+typedef struct
 {
-	0x0000,
-	0x0002,
-	0x0004,
-	0x0006,
-	0x0008,
-	0x000A,
-	0x000C,
-	0x0010,
-	0x0014,
-	0x0018
-};
+	uint16_t addr;
+	uint16_t size;
+	const void* data;
+} readonlyEntry_t;
+
+#define READONLY_ENTRY(entryAddr, variable) { .addr = entryAddr, .size = sizeof (variable), .data = &(variable) }
 
-static const void* READONLY_DATA [READONLY_COUNT] =
+/**
+ * @brief Layout of the read-only region. Entries must be sorted by address and must not overlap. Any gaps between entries
+ * read as 0.
+ */
+#define READONLY_COUNT (sizeof (READONLY_ENTRIES) / sizeof (READONLY_ENTRIES [0]))
+static const readonlyEntry_t READONLY_ENTRIES [] =
 {
-	&pedals.apps1.sample,
-	&pedals.apps2.sample,
-	&pedals.bseF.sample,
-	&pedals.bseR.sample,
-	&sas.sample,
-	&glvBattery.sample,
-	&torqueRequest.torqueRl,
-	&torqueRequest.torqueRr,
-	&torqueRequest.torqueFl,
-	&torqueRequest.torqueFr
+	READONLY_ENTRY (0x0000, pedals.apps1.sample),
+	READONLY_ENTRY (0x0002, pedals.apps2.sample),
+	READONLY_ENTRY (0x0004, pedals.bseF.sample),
+	READONLY_ENTRY (0x0006, pedals.bseR.sample),
+	READONLY_ENTRY (0x0008, sas.sample),
+	READONLY_ENTRY (0x000A, glvBattery.sample),
+	READONLY_ENTRY (0x000C, torqueRequest.torqueRl),
+	READONLY_ENTRY (0x0010, torqueRequest.torqueRr),
+	READONLY_ENTRY (0x0014, torqueRequest.torqueFl),
+	READONLY_ENTRY (0x0018, torqueRequest.torqueFr),
+	READONLY_ENTRY (0x001C, captureState),
+	READONLY_ENTRY (0x0020, canRxLatency.max),
+	READONLY_ENTRY (0x0024, canRxLatency.average),
+	READONLY_ENTRY (0x0028, amkEstimatesConfident),
+	READONLY_ENTRY (0x002C, eepromCacheDirtyCount),
+	READONLY_ENTRY (0x0030, overlayDirty),
+	READONLY_ENTRY (0x0050, journalSequence),
+	READONLY_ENTRY (0x0054, journalDropCount),
+	READONLY_ENTRY (0x0056, adc.errorCount),
+	READONLY_ENTRY (0x0058, adc.watchdogCount),
+	READONLY_ENTRY (0x005C, apps1Filter.groupDelay),
+	READONLY_ENTRY (0x0060, apps2Filter.groupDelay),
+	READONLY_ENTRY (0x0064, bseFFilter.groupDelay),
+	READONLY_ENTRY (0x0068, bseRFilter.groupDelay),
+	READONLY_ENTRY (0x006C, glvBatteryFilter.groupDelay),
+	READONLY_ENTRY (0x0070, adc.sampleVdd),
+	READONLY_ENTRY (0x0074, steeringEstimate.angle),
+	READONLY_ENTRY (0x0078, steeringEstimate.rate),
+	READONLY_ENTRY (0x007C, steeringEstimate.anglePredicted),
+	READONLY_ENTRY (0x0080, i2c1Supervisor.recoveryCount),
+	READONLY_ENTRY (0x0082, i2c1Supervisor.failureCount),
+	READONLY_ENTRY (0x0084, i2c2Supervisor.recoveryCount),
+	READONLY_ENTRY (0x0086, i2c2Supervisor.failureCount),
+	READONLY_ENTRY (0x0088, counters)
 };
 
-static const uint16_t READONLY_SIZES [READONLY_COUNT] =
+/// @brief Gets the range of the EEPROM map spanning from the first field to the last field (inclusive).
+#define FIELD_RANGE(first, last) \
+	.addr = offsetof (eepromMap_t, first), \
+	.size = offsetof (eepromMap_t, last) + sizeof (((eepromMap_t*) NULL)->last) - offsetof (eepromMap_t, first)
+
+typedef struct
+{
+	uint16_t addr;
+	uint16_t size;
+	eepromMapGroup_t group;
+} groupRange_t;
+
+#define GROUP_RANGE_COUNT (sizeof (GROUP_RANGES) / sizeof (GROUP_RANGES [0]))
+static const groupRange_t GROUP_RANGES [] =
 {
-	sizeof (pedals.apps1.sample),
-	sizeof (pedals.apps2.sample),
-	sizeof (pedals.bseF.sample),
-	sizeof (pedals.bseR.sample),
-	sizeof (sas.sample),
-	sizeof (glvBattery.sample),
-	sizeof (torqueRequest.torqueRl),
-	sizeof (torqueRequest.torqueRr),
-	sizeof (torqueRequest.torqueFl),
-	sizeof (torqueRequest.torqueFr)
+	{ FIELD_RANGE (pedalConfig, pedalConfig),				.group = EEPROM_MAP_GROUP_PEDALS },
+	{ FIELD_RANGE (drivingTorqueLimit, powerLimitPidA),		.group = EEPROM_MAP_GROUP_TORQUE },
+	{ FIELD_RANGE (glvBattery11v5, glvBattery14v4),			.group = EEPROM_MAP_GROUP_GLV_BATTERY },
+	{ FIELD_RANGE (steeringEstimatorConfig, sasConfig),		.group = EEPROM_MAP_GROUP_SAS },
+	{ FIELD_RANGE (sasAddr, sasAddr),						.group = EEPROM_MAP_GROUP_SAS },
+	{ FIELD_RANGE (telemetryConfig, telemetryConfig),		.group = EEPROM_MAP_GROUP_TELEMETRY },
+	{ FIELD_RANGE (captureConfig, captureConfig),			.group = EEPROM_MAP_GROUP_CAPTURE },
+	{ FIELD_RANGE (amkEstimatorConfig, amkEstimatorConfig),	.group = EEPROM_MAP_GROUP_AMK_ESTIMATOR },
+	{ FIELD_RANGE (apps1Filter, glvBatteryFilter),			.group = EEPROM_MAP_GROUP_FILTERS },
+	{ FIELD_RANGE (throttleMapConfig, throttleMapConfig),	.group = EEPROM_MAP_GROUP_TORQUE }
 };
 
 // Functions ------------------------------------------------------------------------------------------------------------------
@@ -60,26 +105,45 @@ bool eepromReadonlyRead (void* object, uint16_t addr, void* data, uint16_t dataC
 {
 	(void) object;
 
-	for (uint16_t index = 0; index < READONLY_COUNT; ++index)
+	uint32_t end = (uint32_t) addr + dataCount;
+
+	// Binary search for the first entry ending after the start of the range.
+	uint16_t lower = 0;
+	uint16_t upper = READONLY_COUNT;
+	while (lower < upper)
 	{
-		if (addr != READONLY_ADDRS [index])
-			continue;
+		uint16_t middle = (lower + upper) / 2;
+		if (READONLY_ENTRIES [middle].addr + READONLY_ENTRIES [middle].size <= addr)
+			lower = middle + 1;
+		else
+			upper = middle;
+	}
 
-		if (dataCount != READONLY_SIZES [index])
-			return false;
+	// Reject ranges not containing any variables.
+	if (lower == READONLY_COUNT || READONLY_ENTRIES [lower].addr >= end)
+		return false;
 
-		memcpy (data, READONLY_DATA [index], dataCount);
-		return true;
+	memset (data, 0, dataCount);
+
+	// Copy the overlapping part of every entry in the range. This is done atomically, such that the values form a consistent
+	// snapshot.
+	chSysLock ();
+	for (uint16_t index = lower; index < READONLY_COUNT && READONLY_ENTRIES [index].addr < end; ++index)
+	{
+		const readonlyEntry_t* entry = &READONLY_ENTRIES [index];
+
+		uint16_t start = entry->addr > addr ? entry->addr : addr;
+		uint32_t stop = (uint32_t) entry->addr + entry->size < end ? (uint32_t) entry->addr + entry->size : end;
+		memcpy ((uint8_t*) data + (start - addr), (const uint8_t*) entry->data + (start - entry->addr), stop - start);
 	}
+	chSysUnlock ();
 
-	return false;
+	return true;
 }
 
 bool eepromWriteonlyWrite (void* object, uint16_t addr, const void* data, uint16_t dataCount)
 {
 	(void) object;
-	(void) data;
-	(void) dataCount;
 
 	switch (addr)
 	{
@@ -88,7 +152,53 @@ bool eepromWriteonlyWrite (void* object, uint16_t addr, const void* data, uint16
 			for (uint8_t i = 0; i < 10; ++i)
 				amkSendErrorResetRequest (amks + index, TIME_MS2I (100));
 		return true;
+
+	case 0x0002: // CAPTURE_ARM
+		captureArm ();
+		return true;
+
+	case 0x0004: // CAPTURE_TRIGGER
+		captureTrigger ();
+		return true;
+
+	case 0x0006: // EEPROM_FLUSH
+		eepromCacheFlush ();
+		return true;
+
+	case 0x0008: // PROFILE_SELECT
+		if (dataCount < 1)
+			return false;
+		return peripheralsSelectProfile (((const uint8_t*) data) [0]);
+
+	case 0x000A: // PROFILE_SEAL
+		if (dataCount < 1)
+			return false;
+		return peripheralsSealProfile (((const uint8_t*) data) [0]);
+
+	case 0x000C: // OVERLAY_COMMIT
+		return peripheralsCommitOverlay ();
+
+	case 0x000E: // OVERLAY_REVERT
+		peripheralsRevertOverlay ();
+		return true;
+
+	case 0x0010: // JOURNAL_PAGE_SELECT
+		if (dataCount < 1)
+			return false;
+		return journalSelectPage (((const uint8_t*) data) [0]);
 	}
 
 	return false;
+}
+
+uint16_t eepromMapGetGroups (uint16_t addr, uint16_t dataCount)
+{
+	uint16_t groups = 0;
+	for (uint16_t index = 0; index < GROUP_RANGE_COUNT; ++index)
+	{
+		const groupRange_t* range = &GROUP_RANGES [index];
+		if (addr < range->addr + range->size && addr + dataCount > range->addr)
+			groups |= range->group;
+	}
+	return groups;
 }
\ No newline at end of file
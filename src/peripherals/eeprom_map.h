@@ -7,22 +7,43 @@
 // Date Created: 2024.10.22
 //
 // Description: Structing mapping the data of an EEPROM data to variables.
+//   The physical EEPROM stores one copy of this map per configuration profile, see @c PERIPHERALS_PROFILE_SIZE .
 
 // Includes -------------------------------------------------------------------------------------------------------------------
 
 // Includes
 #include "peripherals/pedals.h"
 #include "peripherals/steering_angle.h"
+#include "can/telemetry.h"
+#include "capture.h"
+#include "controls/amk_estimator.h"
+#include "controls/sample_filter.h"
+#include "controls/steering_estimator.h"
+#include "controls/throttle_map.h"
 #include "controls/tv_const_bias.h"
 #include "controls/tv_linear_bias.h"
 
 // Constants ------------------------------------------------------------------------------------------------------------------
 
 /// @brief The magic string of the EEPROM. Update this value every time the memory map changes to force manual re-programming.
-#define EEPROM_MAP_STRING "VCU_2025_08_22"
+#define EEPROM_MAP_STRING "VCU_2026_10_19H"
 
 // Datatypes ------------------------------------------------------------------------------------------------------------------
 
+/// @brief Groups of EEPROM map fields that are re-configured together. Used as a bitmask.
+typedef enum
+{
+	EEPROM_MAP_GROUP_PEDALS			= 1 << 0,
+	EEPROM_MAP_GROUP_SAS			= 1 << 1,
+	EEPROM_MAP_GROUP_TORQUE			= 1 << 2,
+	EEPROM_MAP_GROUP_GLV_BATTERY	= 1 << 3,
+	EEPROM_MAP_GROUP_TELEMETRY		= 1 << 4,
+	EEPROM_MAP_GROUP_CAPTURE		= 1 << 5,
+	EEPROM_MAP_GROUP_AMK_ESTIMATOR	= 1 << 6,
+	EEPROM_MAP_GROUP_FILTERS		= 1 << 7,
+	EEPROM_MAP_GROUP_ALL			= (1 << 8) - 1
+} eepromMapGroup_t;
+
 typedef struct
 {
 	uint8_t pad0 [16];					// 0x0000
@@ -42,7 +63,7 @@ typedef struct
 	uint16_t glvBattery11v5;			// 0x0050
 	uint16_t glvBattery14v4;			// 0x0052
 
-	uint8_t pad1 [12];
+	steeringEstimatorConfig_t steeringEstimatorConfig;	// 0x0054
 
 	sasConfig_t sasConfig;				// 0x0060
 
@@ -66,10 +87,46 @@ typedef struct
 
 	bool sasEnabled;					// 0x00F8
 	uint8_t sasAddr;					// 0x00F9
+
+	uint8_t pad3 [6];					// 0x00FA
+
+	telemetryConfig_t telemetryConfig;	// 0x0100
+
+	captureConfig_t captureConfig;		// 0x0120
+
+	amkEstimatorConfig_t amkEstimatorConfig;	// 0x0128
+
+	uint8_t pad4 [6];					// 0x012A
+
+	sampleFilterConfig_t apps1Filter;	// 0x0130
+	sampleFilterConfig_t apps2Filter;	// 0x0158
+	sampleFilterConfig_t bseFFilter;	// 0x0180
+	sampleFilterConfig_t bseRFilter;	// 0x01A8
+	sampleFilterConfig_t glvBatteryFilter;	// 0x01D0
+
+	throttleMapConfig_t throttleMapConfig;	// 0x01F8
+
+	/// @brief The maximum difference between consecutive samples (10 ms apart) of each sensor monitored by the health monitor,
+	/// see @c peripheralsHealthChannel_t . 0 disables the rate-of-change check.
+	uint16_t healthRateLimits [6];		// 0x023C
 } eepromMap_t;
 
 // Functions ------------------------------------------------------------------------------------------------------------------
 
+/**
+ * @brief Gets the groups of fields that overlap a range of the EEPROM map. Fields that are read directly (rather than being
+ * copied into a peripheral's configuration) don't belong to any group, as they don't require re-configuration.
+ * @param addr The address of the range.
+ * @param dataCount The size of the range, in bytes.
+ * @return A bitmask of the overlapping groups, see @c eepromMapGroup_t .
+ */
+uint16_t eepromMapGetGroups (uint16_t addr, uint16_t dataCount);
+
+/**
+ * @brief Read handler of the read-only region. Any address range may be read, allowing a snapshot of multiple variables to be
+ * fetched in a single transfer. Gaps between variables read as 0.
+ * @return False if the range does not contain any variables, true otherwise.
+ */
 bool eepromReadonlyRead (void* object, uint16_t addr, void* data, uint16_t dataCount);
 
 bool eepromWriteonlyWrite (void* object, uint16_t addr, const void* data, uint16_t dataCount);
@@ -0,0 +1,212 @@
+// Header
+#include "i2c_supervisor.h"
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The half-period of the recovery clock, in microseconds (100 kHz, which every slave supports).
+#define CLOCK_HALF_PERIOD_US 5
+
+/// @brief The maximum number of clocks to generate. A slave mid-transmission releases SDA within 9 clocks (8 data bits and
+/// the acknowledge bit).
+#define CLOCK_COUNT_MAX 9
+
+/// @brief The maximum amount of time a slave may stretch a clock during recovery, in microseconds.
+#define CLOCK_STRETCH_MAX_US 50
+
+/// @brief The maximum amount of time to wait for an idle bus, in microseconds. This accommodates a STOP condition that is
+/// still in progress when the previous transaction completes.
+#define IDLE_TIMEOUT_US 20
+
+/// @brief The mode of the lines during recovery.
+#define GPIO_MODE (PAL_MODE_OUTPUT_OPENDRAIN | PAL_STM32_PUPDR_PULLUP)
+
+/// @brief Errors indicating a stuck bus. Note a NACK is not included, as that is expected from an absent or busy slave.
+#define STUCK_ERRORS (I2C_BUS_ERROR | I2C_ARBITRATION_LOST | I2C_TIMEOUT)
+
+// Function Prototypes --------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Checks whether the bus is stuck. Must be called with the bus acquired.
+ */
+static bool isStuck (i2cSupervisor_t* supervisor);
+
+/**
+ * @brief Waits for a line to be released, for up to @c timeoutUs microseconds. The line can be read regardless of its mode.
+ * @return True if the line is high, false otherwise.
+ */
+static bool waitHigh (ioline_t line, uint32_t timeoutUs);
+
+/**
+ * @brief Waits for both lines to be released, for up to @c IDLE_TIMEOUT_US microseconds each.
+ * @return True if both lines are high, false otherwise.
+ */
+static bool waitIdle (const i2cSupervisorConfig_t* config);
+
+/**
+ * @brief Performs the bus-clear sequence and restarts the driver. Must be called with the bus acquired.
+ * @param stop Indicates whether the driver is started, in which case it is stopped and restarted. False if the driver has
+ * yet to be started.
+ * @return True if the bus was released, false otherwise.
+ */
+static bool recover (i2cSupervisor_t* supervisor, bool stop);
+
+/**
+ * @brief Generates the bus-clear sequence on the lines, which must be in GPIO mode.
+ * @return True if the bus was released, false otherwise.
+ */
+static bool clearBus (const i2cSupervisorConfig_t* config);
+
+/**
+ * @brief Busy-waits for a number of microseconds.
+ */
+static inline void delayUs (uint32_t us);
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+bool i2cSupervisorInit (i2cSupervisor_t* supervisor, const i2cSupervisorConfig_t* config)
+{
+	supervisor->config = config;
+	supervisor->recoveryCount = 0;
+	supervisor->failureCount = 0;
+
+	// If the MCU was reset mid-transaction, a slave may still be holding the bus. The driver isn't started yet, so no other
+	// thread can be using it.
+	if (!waitIdle (config))
+		recover (supervisor, false);
+
+	return i2cStart (config->driver, config->config) == MSG_OK;
+}
+
+msg_t i2cSupervisorTransmit (i2cSupervisor_t* supervisor, i2caddr_t addr, const uint8_t* tx, size_t txCount, uint8_t* rx,
+	size_t rxCount, sysinterval_t timeout)
+{
+	I2CDriver* driver = supervisor->config->driver;
+
+	i2cAcquireBus (driver);
+
+	msg_t result = MSG_RESET;
+	for (uint8_t attempt = 0; attempt < 2; ++attempt)
+	{
+		// Don't start a transaction on a stuck bus, it would only time out. Give up if the bus can't be released.
+		if (isStuck (supervisor) && !recover (supervisor, true))
+			break;
+
+		result = i2cMasterTransmitTimeout (driver, addr, tx, txCount, rx, rxCount, timeout);
+
+		// Only retry if the failure is one recovery can fix. The bus is recovered prior to the retry.
+		if (result == MSG_OK || !isStuck (supervisor))
+			break;
+	}
+
+	i2cReleaseBus (driver);
+	return result;
+}
+
+bool i2cSupervisorCheck (i2cSupervisor_t* supervisor)
+{
+	i2cAcquireBus (supervisor->config->driver);
+	bool result = !isStuck (supervisor) || recover (supervisor, true);
+	i2cReleaseBus (supervisor->config->driver);
+	return result;
+}
+
+bool isStuck (i2cSupervisor_t* supervisor)
+{
+	const i2cSupervisorConfig_t* config = supervisor->config;
+
+	// A timeout locks the driver, requiring a restart regardless of the lines' states.
+	if (config->driver->state == I2C_LOCKED)
+		return true;
+
+	if ((i2cGetErrors (config->driver) & STUCK_ERRORS) != 0)
+		return true;
+
+	return !waitIdle (config);
+}
+
+bool waitHigh (ioline_t line, uint32_t timeoutUs)
+{
+	for (uint32_t elapsed = 0; elapsed < timeoutUs; ++elapsed)
+	{
+		if (palReadLine (line) == PAL_HIGH)
+			return true;
+		delayUs (1);
+	}
+
+	return palReadLine (line) == PAL_HIGH;
+}
+
+bool waitIdle (const i2cSupervisorConfig_t* config)
+{
+	return waitHigh (config->sclLine, IDLE_TIMEOUT_US) && waitHigh (config->sdaLine, IDLE_TIMEOUT_US);
+}
+
+bool recover (i2cSupervisor_t* supervisor, bool stop)
+{
+	const i2cSupervisorConfig_t* config = supervisor->config;
+	++supervisor->recoveryCount;
+
+	// Stop the peripheral, resetting it. Note this is valid in the locked state.
+	if (stop)
+		i2cStop (config->driver);
+
+	// Take over the lines, both released.
+	palSetLine (config->sclLine);
+	palSetLine (config->sdaLine);
+	palSetLineMode (config->sclLine, GPIO_MODE);
+	palSetLineMode (config->sdaLine, GPIO_MODE);
+
+	bool result = clearBus (config);
+
+	// Return the lines to the peripheral.
+	palSetLineMode (config->sclLine, config->alternateMode);
+	palSetLineMode (config->sdaLine, config->alternateMode);
+
+	if (stop && i2cStart (config->driver, config->config) != MSG_OK)
+		result = false;
+
+	// Discard the errors of the failed transaction, such that they aren't mistaken for a new failure.
+	config->driver->errors = I2C_NO_ERROR;
+
+	if (!result)
+		++supervisor->failureCount;
+
+	return result;
+}
+
+bool clearBus (const i2cSupervisorConfig_t* config)
+{
+	// Clock SCL until the slave releases SDA. Each clock waits for any clock stretching, but only for a bounded amount of
+	// time.
+	for (uint8_t clock = 0; clock < CLOCK_COUNT_MAX && palReadLine (config->sdaLine) == PAL_LOW; ++clock)
+	{
+		palClearLine (config->sclLine);
+		delayUs (CLOCK_HALF_PERIOD_US);
+		palSetLine (config->sclLine);
+		delayUs (CLOCK_HALF_PERIOD_US);
+
+		// If SCL is held low beyond any reasonable clock stretching, no amount of clocking will help.
+		if (!waitHigh (config->sclLine, CLOCK_STRETCH_MAX_US))
+			return false;
+	}
+
+	if (palReadLine (config->sdaLine) == PAL_LOW)
+		return false;
+
+	// STOP condition: SDA rising while SCL is high. SDA is pulled low while SCL is low, such that this isn't a START.
+	palClearLine (config->sclLine);
+	delayUs (CLOCK_HALF_PERIOD_US);
+	palClearLine (config->sdaLine);
+	delayUs (CLOCK_HALF_PERIOD_US);
+	palSetLine (config->sclLine);
+	delayUs (CLOCK_HALF_PERIOD_US);
+	palSetLine (config->sdaLine);
+	delayUs (CLOCK_HALF_PERIOD_US);
+
+	return waitIdle (config);
+}
+
+void delayUs (uint32_t us)
+{
+	osalSysPolledDelayX (OSAL_US2RTC (STM32_HCLK, us));
+}
\ No newline at end of file
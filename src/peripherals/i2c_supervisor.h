@@ -0,0 +1,93 @@
+#ifndef I2C_SUPERVISOR_H
+#define I2C_SUPERVISOR_H
+
+// I2C Bus Supervisor ---------------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.19
+//
+// Description: Detects and recovers from a stuck I2C bus. If the master is reset (or a glitch occurs on SCL) while a slave is
+//   transmitting, the slave may hold SDA low indefinitely, waiting for clocks that never come. The peripheral then cannot
+//   generate a START condition, so every transaction times out. After a timeout, the HAL also locks the driver, so all
+//   subsequent transactions fail until the peripheral is restarted.
+//
+//   The bus is considered stuck if the driver is locked, the previous transaction failed with a bus error, arbitration loss or
+//   timeout, or either line is held low while the bus is idle. Recovery performs the bus-clear sequence (see the I2C-bus
+//   specification, UM10204):
+//   - The peripheral is stopped and both lines are taken over as open-drain GPIO.
+//   - SCL is clocked (at 100 kHz) until the slave releases SDA, up to 9 clocks. A slave may stretch each clock, but only for
+//     a bounded amount of time.
+//   - A STOP condition is generated, resetting the state machine of every slave.
+//   - The lines are returned to the peripheral and the peripheral is restarted.
+//
+//   Recovery takes at most ~0.6 ms, regardless of the slaves' behavior. Supervised transactions are retried once upon
+//   recovery, so the worst-case duration of a transaction is twice its timeout plus a recovery.
+//
+//   Each recovery is counted, as is each recovery that failed to release the bus. A steadily increasing count indicates a
+//   marginal harness or a misbehaving slave.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// ChibiOS
+#include "hal.h"
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef struct
+{
+	/// @brief The driver of the bus.
+	I2CDriver* driver;
+	/// @brief The configuration to (re)start the driver with.
+	const I2CConfig* config;
+	/// @brief The bus's clock line.
+	ioline_t sclLine;
+	/// @brief The bus's data line.
+	ioline_t sdaLine;
+	/// @brief The mode of the lines when used by the peripheral.
+	iomode_t alternateMode;
+} i2cSupervisorConfig_t;
+
+typedef struct
+{
+	const i2cSupervisorConfig_t* config;
+	/// @brief The number of recoveries performed.
+	uint16_t recoveryCount;
+	/// @brief The number of recoveries that failed to release the bus.
+	uint16_t failureCount;
+} i2cSupervisor_t;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Initializes the supervisor, starting the driver. If the bus is stuck (for instance, the MCU was reset
+ * mid-transaction) it is recovered prior to starting the driver.
+ * @param supervisor The supervisor to initialize.
+ * @param config The configuration to use. Must remain in scope.
+ * @return True if successful, false if the driver failed to start.
+ */
+bool i2cSupervisorInit (i2cSupervisor_t* supervisor, const i2cSupervisorConfig_t* config);
+
+/**
+ * @brief Performs a transaction on the bus (see @c i2cMasterTransmitTimeout ), acquiring the bus for its duration. If the bus
+ * is stuck, either prior to or after the transaction, it is recovered and the transaction is retried once.
+ * @param supervisor The supervisor of the bus.
+ * @param addr The 7-bit address of the slave.
+ * @param tx The data to transmit.
+ * @param txCount The number of bytes to transmit.
+ * @param rx The buffer to receive into, may be NULL if @c rxCount is 0.
+ * @param rxCount The number of bytes to receive.
+ * @param timeout The timeout of each attempt.
+ * @return The result of the final attempt.
+ */
+msg_t i2cSupervisorTransmit (i2cSupervisor_t* supervisor, i2caddr_t addr, const uint8_t* tx, size_t txCount, uint8_t* rx,
+	size_t rxCount, sysinterval_t timeout);
+
+/**
+ * @brief Checks whether the bus is stuck, recovering it if so. Intended for drivers that access the bus directly, to be called
+ * prior to each of their transactions.
+ * @param supervisor The supervisor of the bus.
+ * @return True if the bus is usable, false if the bus is stuck and recovery failed.
+ */
+bool i2cSupervisorCheck (i2cSupervisor_t* supervisor);
+
+#endif // I2C_SUPERVISOR_H
\ No newline at end of file
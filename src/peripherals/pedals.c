@@ -12,16 +12,32 @@
 /// @brief The maximum acceptable delta of the BSE-F and BSE-R sensor values.
 #define BSE_DELTA_MAX 0.1f
 
+/// @brief The sample of the sensors' supply at its nominal voltage. The sensors' configurations are calibrated at this.
+#define SAMPLE_VDD_NOMINAL 4095
+
+/// @brief The range of the sensors' supply, relative to nominal, that can be corrected for. Beyond this, the supply is faulty.
+#define SAMPLE_VDD_MIN (SAMPLE_VDD_NOMINAL * 9 / 10)
+#define SAMPLE_VDD_MAX (SAMPLE_VDD_NOMINAL * 11 / 10)
+
 // Function Prototypes --------------------------------------------------------------------------------------------------------
 
 /**
  * @brief Updates the value of a pedal sensor based on a read sample.
  * @param object The pedal sensor to update (must be @c pedalSensor_t ).
  * @param sample The read sample.
- * @param sampleVdd TODO(Barach)
+ * @param sampleVdd The sample of the sensor's supply, used to correct the sample ratiometrically.
  */
 static void callback (void* object, uint16_t sample, uint16_t sampleVdd);
 
+/**
+ * @brief Corrects a sample ratiometrically for a deviation of the sensor's supply.
+ * @param sample The sample to correct.
+ * @param sampleVdd The sample of the sensor's supply.
+ * @param sampleCorrected Written to contain the corrected sample.
+ * @return True if successful, false if the supply is out of range (in which case the sample can't be corrected).
+ */
+static bool correctSample (uint16_t sample, uint16_t sampleVdd, uint16_t* sampleCorrected);
+
 // Functions ------------------------------------------------------------------------------------------------------------------
 
 bool pedalSensorInit (pedalSensor_t* sensor, pedalSensorConfig_t* config)
@@ -47,11 +63,21 @@ bool pedalSensorInit (pedalSensor_t* sensor, pedalSensorConfig_t* config)
 
 void callback (void* object, uint16_t sample, uint16_t sampleVdd)
 {
-	// TODO(Barach): How to mange?
-	(void) sampleVdd;
-
 	pedalSensor_t* sensor = (pedalSensor_t*) object;
 
+	// Correct the sample ratiometrically, such that a deviation of the supply isn't mistaken for pedal travel. If the supply
+	// is out of range, the sample can't be corrected.
+	if (!correctSample (sample, sampleVdd, &sample))
+	{
+		sensor->sample = sample;
+		if (sensor->state != ANALOG_SENSOR_CONFIG_INVALID)
+		{
+			sensor->state = ANALOG_SENSOR_SAMPLE_INVALID;
+			sensor->value = 0;
+		}
+		return;
+	}
+
 	// Store the sample.
 	sensor->sample = sample;
 
@@ -85,6 +111,10 @@ bool pedalsInit (pedals_t* pedals, pedalsConfig_t* config)
 	result &= pedalSensorInit (&pedals->apps2, &config->apps2Config);
 	result &= pedalSensorInit (&pedals->bseF, &config->bseFConfig);
 	result &= pedalSensorInit (&pedals->bseR, &config->bseRConfig);
+
+	pedals->watchdogTripped = false;
+	pedals->watchdogFault = false;
+
 	return result;
 }
 
@@ -112,8 +142,15 @@ void pedalsUpdate (pedals_t* pedals, systime_t timePrevious, systime_t timeCurre
 	else if (pedals->appsRequest < 0.05)
 		pedals->apps25_5Plausible = true;
 
+	// Consume any trips of the analog watchdog.
+	chSysLock ();
+	pedals->watchdogFault = pedals->watchdogTripped;
+	pedals->watchdogTripped = false;
+	chSysUnlock ();
+
 	// Instantaneous plausiblity check
 	pedals->plausibleInst =
+		!pedals->watchdogFault &&
 		pedals->apps1.state == ANALOG_SENSOR_VALID &&
 		pedals->apps2.state == ANALOG_SENSOR_VALID &&
 		pedals->bseF.state == ANALOG_SENSOR_VALID &&
@@ -135,4 +172,69 @@ void pedalsUpdate (pedals_t* pedals, systime_t timePrevious, systime_t timeCurre
 		if (chTimeIsInRangeX (pedals->plausibilityDeadline, timePrevious, timeCurrent))
 			pedals->plausible = false;
 	}
+}
+
+bool pedalsGetWatchdogWindow (pedals_t* pedals, uint16_t* low, uint16_t* high)
+{
+	pedalSensor_t* sensors [] = { &pedals->apps1, &pedals->apps2, &pedals->bseF, &pedals->bseR };
+
+	bool result = false;
+	for (uint8_t index = 0; index < sizeof (sensors) / sizeof (sensors [0]); ++index)
+	{
+		if (sensors [index]->state == ANALOG_SENSOR_CONFIG_INVALID)
+			continue;
+
+		// The window applies to the uncorrected samples, so must contain the plausible range at any supply that can be
+		// corrected for.
+		pedalSensorConfig_t* config = sensors [index]->config;
+		uint16_t sensorLow = (uint32_t) config->absoluteMin * SAMPLE_VDD_MIN / SAMPLE_VDD_NOMINAL;
+		uint32_t sensorHigh = (uint32_t) config->absoluteMax * SAMPLE_VDD_MAX / SAMPLE_VDD_NOMINAL;
+		if (sensorHigh > SAMPLE_VDD_NOMINAL)
+			sensorHigh = SAMPLE_VDD_NOMINAL;
+
+		if (!result || sensorLow < *low)
+			*low = sensorLow;
+		if (!result || sensorHigh > *high)
+			*high = sensorHigh;
+
+		result = true;
+	}
+
+	return result;
+}
+
+bool pedalsWatchdogLocked (pedals_t* pedals, analogSensor_t* sensor, uint16_t sample, uint16_t sampleVdd)
+{
+	pedalSensor_t* pedalSensor = (pedalSensor_t*) sensor;
+	if (pedalSensor != &pedals->apps1 && pedalSensor != &pedals->apps2 && pedalSensor != &pedals->bseF &&
+		pedalSensor != &pedals->bseR)
+		return false;
+
+	if (pedalSensor->state == ANALOG_SENSOR_CONFIG_INVALID)
+		return false;
+
+	// The window is shared by every sensor (and widened to any correctable supply), so the corrected sample may still be in
+	// this sensor's range. If the supply is out of range, the sample can't be corrected, so is invalid regardless.
+	if (correctSample (sample, sampleVdd, &sample) &&
+		sample >= pedalSensor->config->absoluteMin && sample <= pedalSensor->config->absoluteMax)
+		return false;
+
+	pedalSensor->sample = sample;
+	pedalSensor->state = ANALOG_SENSOR_SAMPLE_INVALID;
+	pedalSensor->value = 0;
+	pedals->watchdogTripped = true;
+	return true;
+}
+
+bool correctSample (uint16_t sample, uint16_t sampleVdd, uint16_t* sampleCorrected)
+{
+	if (sampleVdd < SAMPLE_VDD_MIN || sampleVdd > SAMPLE_VDD_MAX)
+	{
+		*sampleCorrected = sample;
+		return false;
+	}
+
+	uint32_t corrected = ((uint32_t) sample * SAMPLE_VDD_NOMINAL + sampleVdd / 2) / sampleVdd;
+	*sampleCorrected = corrected > UINT16_MAX ? UINT16_MAX : corrected;
+	return true;
 }
\ No newline at end of file
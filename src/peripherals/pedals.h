@@ -79,6 +79,12 @@ typedef struct
 	bool bse10PercentPlausible;
 	/// @brief Indicates the instantaneous APPS 25% / 5% plausibility.
 	bool apps25_5Plausible;
+	/// @brief Indicates the ADC's analog watchdog detected an out-of-range sample since the last update. Set from the ADC's
+	/// ISR.
+	bool watchdogTripped;
+	/// @brief Indicates the analog watchdog detected an out-of-range sample during the last period. No torque may be requested
+	/// while set.
+	bool watchdogFault;
 
 	/// @brief Indicates whether the request to accelerate is being made.
 	bool accelerating;
@@ -106,4 +112,27 @@ bool pedalsInit (pedals_t* pedals, pedalsConfig_t* config);
  */
 void pedalsUpdate (pedals_t* pedals, systime_t timePrevious, systime_t timeCurrent);
 
+/**
+ * @brief Calculates the window for the ADC's analog watchdog, that being the smallest window containing the plausible range of
+ * every sensor. The window applies to uncorrected samples, so each range is widened to that at any supply that can be
+ * corrected for. Sensors with an invalid configuration are ignored.
+ * @param pedals The pedals to calculate the window of.
+ * @param low Written to contain the lowest sample of the window.
+ * @param high Written to contain the highest sample of the window.
+ * @return True if successful, false if no sensor has a valid configuration.
+ */
+bool pedalsGetWatchdogWindow (pedals_t* pedals, uint16_t* low, uint16_t* high);
+
+/**
+ * @brief Handles a sample outside of the ADC's analog watchdog window. If the sample (corrected for the supply) is outside of
+ * its sensor's plausible range, the sensor is invalidated immediately, rather than upon the next update. Must be called from
+ * a locked context.
+ * @param pedals The pedals the sensor belongs to.
+ * @param sensor The sensor of the sample. Need not belong to the pedals, in which case the sample is ignored.
+ * @param sample The out-of-range (uncorrected) sample.
+ * @param sampleVdd The sample of the sensors' supply, used to correct the sample ratiometrically.
+ * @return True if the sensor was invalidated, false otherwise.
+ */
+bool pedalsWatchdogLocked (pedals_t* pedals, analogSensor_t* sensor, uint16_t sample, uint16_t sampleVdd);
+
 #endif // PEDALS_H
\ No newline at end of file
@@ -15,7 +15,7 @@
  * @note This function uses a @c void* for the object reference as to make the signature usable by callbacks.
  * @param object The sensor to update (must be a @c sas_t* ).
  * @param sample The read sample.
- * @param sampleVdd TODO(Barach)
+ * @param sampleVdd Unused, the sensor's sample is digital (absolute angle), so is independent of its supply.
  */
 static void callback (void* object, uint16_t sample, uint16_t sampleVdd);
 
@@ -41,7 +41,6 @@ bool sasInit (sas_t* sas, sasConfig_t* config)
 
 void callback (void* object, uint16_t sample, uint16_t sampleVdd)
 {
-	// TODO(Barach)
 	(void) sampleVdd;
 
 	sas_t* sas = (sas_t*) object;
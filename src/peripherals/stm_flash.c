@@ -0,0 +1,109 @@
+// Header
+#include "stm_flash.h"
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief Key sequence for unlocking the flash control register, see section 3.5.1 of the STM32F405 Reference Manual.
+#define FLASH_KEY_1 0x45670123
+#define FLASH_KEY_2 0xCDEF89AB
+
+/// @brief All error flags of the flash status register.
+#define FLASH_SR_ERRORS (FLASH_SR_PGSERR | FLASH_SR_PGPERR | FLASH_SR_PGAERR | FLASH_SR_WRPERR | FLASH_SR_OPERR)
+
+// Global Data ----------------------------------------------------------------------------------------------------------------
+
+/// @brief Mutex protecting the flash control register, as multiple threads may own storage sectors.
+static MUTEX_DECL (flashMutex);
+
+// Function Prototypes --------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Unlocks the flash control register, clearing any previous errors.
+ */
+static void unlock (void);
+
+/**
+ * @brief Locks the flash control register.
+ */
+static void lock (void);
+
+/**
+ * @brief Waits for the current operation to complete.
+ * @return True if the operation completed without error, false otherwise.
+ */
+static bool waitOperation (void);
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+bool stmFlashErase (uint8_t sector)
+{
+	chMtxLock (&flashMutex);
+	unlock ();
+
+	FLASH->CR = FLASH_CR_PSIZE_1 | FLASH_CR_SER | ((uint32_t) sector << FLASH_CR_SNB_Pos);
+	FLASH->CR |= FLASH_CR_STRT;
+	bool result = waitOperation ();
+	FLASH->CR = 0;
+
+	lock ();
+
+	// The data cache may contain the sector's old contents, reset it. The cache must be disabled to do so.
+	FLASH->ACR &= ~FLASH_ACR_DCEN;
+	FLASH->ACR |= FLASH_ACR_DCRST;
+	FLASH->ACR &= ~FLASH_ACR_DCRST;
+	FLASH->ACR |= FLASH_ACR_DCEN;
+
+	chMtxUnlock (&flashMutex);
+	return result;
+}
+
+bool stmFlashProgram (uint32_t* addr, const uint32_t* data, uint32_t count)
+{
+	chMtxLock (&flashMutex);
+	unlock ();
+
+	FLASH->CR = FLASH_CR_PSIZE_1 | FLASH_CR_PG;
+
+	bool result = true;
+	for (uint32_t index = 0; index < count; ++index)
+	{
+		addr [index] = data [index];
+		__DSB ();
+
+		if (!waitOperation ())
+		{
+			result = false;
+			break;
+		}
+	}
+
+	FLASH->CR = 0;
+	lock ();
+
+	chMtxUnlock (&flashMutex);
+	return result;
+}
+
+void unlock (void)
+{
+	while (FLASH->SR & FLASH_SR_BSY);
+
+	if (FLASH->CR & FLASH_CR_LOCK)
+	{
+		FLASH->KEYR = FLASH_KEY_1;
+		FLASH->KEYR = FLASH_KEY_2;
+	}
+
+	FLASH->SR = FLASH_SR_ERRORS | FLASH_SR_EOP;
+}
+
+void lock (void)
+{
+	FLASH->CR |= FLASH_CR_LOCK;
+}
+
+bool waitOperation (void)
+{
+	while (FLASH->SR & FLASH_SR_BSY);
+	return (FLASH->SR & FLASH_SR_ERRORS) == 0;
+}
\ No newline at end of file
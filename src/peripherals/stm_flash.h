@@ -0,0 +1,52 @@
+#ifndef STM_FLASH_H
+#define STM_FLASH_H
+
+// STM32F405 Internal Flash ---------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.19
+//
+// Description: Erasing & programming of the STM32F405's internal flash, see section 3 of the STM32F405 Reference Manual. The
+//   flash is programmed 32 bits at a time, which requires a supply voltage of 2.7 V to 3.6 V.
+//
+//   The STM32F405 has a single flash bank, so any read of the flash (including instruction fetches) stalls while an operation
+//   is in progress. Programming a word stalls for ~16 us, erasing a 128 KB sector stalls for 1 to 2 s.
+//
+//   The sectors used for storage must not overlap the firmware image. Sectors 8 through 11 (0x08080000 to 0x080FFFFF) are
+//   reserved for this purpose, the linker script (see @c config/STM32F405xG.ld ) limits the image to sectors 0 through 7.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// ChibiOS
+#include "hal.h"
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The base address of sector 8. Sectors 5 through 11 are 128 KB each.
+#define STM_FLASH_SECTOR_8_ADDR 0x08080000
+
+/// @brief The size of sectors 5 through 11, in bytes.
+#define STM_FLASH_SECTOR_SIZE 0x20000
+
+/// @brief Gets the base address of one of the 128 KB sectors (5 through 11).
+#define STM_FLASH_SECTOR_ADDR(sector) ((uint32_t*) (STM_FLASH_SECTOR_8_ADDR + ((sector) - 8) * STM_FLASH_SECTOR_SIZE))
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Erases a sector of the flash.
+ * @param sector The index of the sector to erase.
+ * @return True if successful, false otherwise.
+ */
+bool stmFlashErase (uint8_t sector);
+
+/**
+ * @brief Programs words of the flash. Programming can only clear bits.
+ * @param addr The address to program, must be word aligned.
+ * @param data The words to program.
+ * @param count The number of words to program.
+ * @return True if successful, false otherwise.
+ */
+bool stmFlashProgram (uint32_t* addr, const uint32_t* data, uint32_t count);
+
+#endif // STM_FLASH_H
\ No newline at end of file
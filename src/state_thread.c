@@ -3,8 +3,10 @@
 
 // Includes
 #include "can.h"
-#include "can/transmit.h"
+#include "can/can_rx.h"
+#include "journal.h"
 #include "peripherals.h"
+#include "peripherals/eeprom_cache.h"
 
 // ChibiOS
 #include "hal.h"
@@ -14,11 +16,25 @@
 
 // Constants ------------------------------------------------------------------------------------------------------------------
 
-#define STATE_CONTROL_PERIOD	TIME_MS2I (10)
-#define STATE_MESSAGE_PRESCALAR	10
+/// @brief The maximum time between evaluations. Bounds the latency of any condition that doesn't signal an event.
+#define STATE_CONTROL_PERIOD_MAX	TIME_MS2I (100)
 
-#define BUZZER_TIME_PERIOD		TIME_MS2I (2500)
-#define HV_INACTIVE_PERIOD		TIME_MS2I (100)
+/// @brief The period of aggregating the inverter and motor temperatures.
+#define TEMPERATURE_PERIOD			TIME_MS2I (100)
+
+#define BUZZER_TIME_PERIOD			TIME_MS2I (2500)
+#define HV_INACTIVE_PERIOD			TIME_MS2I (100)
+
+/// @brief Event indicating the BMS or an AMK inverter has received a message.
+#define STATE_THREAD_EVENT_CAN		EVENT_MASK (0)
+/// @brief Event indicating the RTD button has been pressed, see @c buttonCallback .
+#define STATE_THREAD_EVENT_BUTTON	EVENT_MASK (1)
+/// @brief Event indicating the state of the pedals has changed, see @c stateThreadSignalPedals .
+#define STATE_THREAD_EVENT_PEDALS	EVENT_MASK (2)
+/// @brief Event indicating the torque plausibility has changed, see @c stateThreadSetTorquePlausibility .
+#define STATE_THREAD_EVENT_TORQUE	EVENT_MASK (3)
+/// @brief Event indicating the state of the EEPROM has changed, see @c eepromCacheEventSource .
+#define STATE_THREAD_EVENT_EEPROM	EVENT_MASK (4)
 
 // Global Data ----------------------------------------------------------------------------------------------------------------
 
@@ -31,6 +47,21 @@ bool vcuFault					= false;
 float temperatureInverterMax;
 float temperatureMotorMax;
 
+/// @brief The state control thread.
+static thread_t* controlThread = NULL;
+
+// Function Prototypes --------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Callback for the falling edge of the RTD button (the button being pressed). Called from an ISR.
+ */
+static void buttonCallback (void* arg);
+
+/**
+ * @brief Updates @c temperatureInverterMax and @c temperatureMotorMax from the inverters.
+ */
+static void updateTemperatures (void);
+
 // Thread Entrypoint ----------------------------------------------------------------------------------------------------------
 
 static THD_WORKING_AREA (stateThreadWa, 512);
@@ -39,21 +70,54 @@ THD_FUNCTION (stateThread, arg)
 	(void) arg;
 	chRegSetThreadName ("state_control");
 
+	// Wake upon a message from any of the nodes the vehicle state depends on.
+	eventflags_t amksFlags = 0;
+	for (size_t index = 0; index < AMK_COUNT; ++index)
+		amksFlags |= canRxGetEventFlags ((canNode_t*) &amks [index]);
+	eventflags_t bmsFlags = canRxGetEventFlags ((canNode_t*) &bms);
+
+	event_listener_t canListener;
+	chEvtRegisterMaskWithFlags (&canRxEventSource, &canListener, STATE_THREAD_EVENT_CAN, amksFlags | bmsFlags);
+
+	// Wake upon the EEPROM failing or being invalidated.
+	event_listener_t eepromListener;
+	chEvtRegisterMask (&eepromCacheEventSource, &eepromListener, STATE_THREAD_EVENT_EEPROM);
+
 	systime_t timePrevious = chVTGetSystemTime ();
 	systime_t timeoutBuzzer = timePrevious;
 	systime_t timeoutHv = timePrevious;
+	systime_t timeoutTemperatures = timePrevious;
+	systime_t timeNext = timePrevious;
+	bool buzzerActive = false;
 
-	uint16_t messageCounter = 0;
+	// The state at the end of the previous evaluation, for journaling changes.
+	vehicleState_t vehicleStatePrevious = vehicleState;
+	amkInverterState_t amksStatePrevious = amksState;
+	bool pedalsPlausiblePrevious = true;
+
+	// Perform the first evaluation immediately.
+	eventmask_t events = ALL_EVENTS;
 
 	while (true)
 	{
 		systime_t timeCurrent = chVTGetSystemTime ();
+		eventflags_t canFlags = (events & STATE_THREAD_EVENT_CAN) ? chEvtGetAndClearFlags (&canListener) : 0;
+
+		amksState = amksGetState (amks, AMK_COUNT);
+
+		// The inverters broadcast far more often than their state changes. If only inverter messages were received, the
+		// aggregate state is unchanged and no deadline has been reached, there is nothing to evaluate.
+		if (events == STATE_THREAD_EVENT_CAN && (canFlags & bmsFlags) == 0 && amksState == amksStatePrevious &&
+			chTimeIsInRangeX (timeCurrent, timePrevious, timeNext))
+		{
+			events = chEvtWaitAnyTimeout (ALL_EVENTS, chTimeDiffX (timeCurrent, timeNext));
+			continue;
+		}
 
 		// If a failure occured previously, transition to LV and attempt to recover.
 		if (vehicleState == VEHICLE_STATE_FAILED)
 			vehicleState = VEHICLE_STATE_LOW_VOLTAGE;
 
-		amksState = amksGetState (amks, AMK_COUNT);
 		if (amksState == AMK_STATE_INVALID || physicalEeprom.state != MC24LC32_STATE_READY)
 			vehicleState = VEHICLE_STATE_FAILED;
 
@@ -75,6 +139,7 @@ THD_FUNCTION (stateThread, arg)
 			{
 				vehicleState = VEHICLE_STATE_READY_TO_DRIVE;
 				palSetLine (LINE_BUZZER);
+				buzzerActive = true;
 				timeoutBuzzer = chTimeAddX (timeCurrent, BUZZER_TIME_PERIOD);
 			}
 
@@ -105,20 +170,11 @@ THD_FUNCTION (stateThread, arg)
 			}
 		}
 
-		// Get cooling temps
-		temperatureInverterMax	= -FLT_MAX;
-		temperatureMotorMax		= -FLT_MAX;
-		for (size_t index = 0; index < AMK_COUNT; ++index)
+		// Get cooling temps. These change slowly, so are only aggregated periodically.
+		if (!chTimeIsInRangeX (timeCurrent, timePrevious, timeoutTemperatures))
 		{
-			canNodeLock ((canNode_t*) &amks [index]);
-
-			if (amks [index].temperatureInverter > temperatureInverterMax)
-				temperatureInverterMax = amks [index].temperatureInverter;
-
-			if (amks [index].temperatureMotor > temperatureMotorMax)
-				temperatureMotorMax = amks [index].temperatureMotor;
-
-			canNodeUnlock ((canNode_t*) &amks [index]);
+			updateTemperatures ();
+			timeoutTemperatures = chTimeAddX (timeCurrent, TEMPERATURE_PERIOD);
 		}
 
 		// TODO(Barach): Enable if temp > EEPROM config value
@@ -127,15 +183,10 @@ THD_FUNCTION (stateThread, arg)
 		palWriteLine (LINE_OUTPUT_2, coolingEnabled);
 
 		// Stop the RTD buzzer if it is past the deadline.
-		if (!chTimeIsInRangeX (timeCurrent, timePrevious, timeoutBuzzer))
-			palClearLine (LINE_BUZZER);
-
-		// Transmit the status message
-		++messageCounter;
-		if (messageCounter >= STATE_MESSAGE_PRESCALAR)
+		if (buzzerActive && !chTimeIsInRangeX (timeCurrent, timePrevious, timeoutBuzzer))
 		{
-			transmitStatusMessage (&CAND1, STATE_CONTROL_PERIOD);
-			messageCounter = 0;
+			palClearLine (LINE_BUZZER);
+			buzzerActive = false;
 		}
 
 		// VCU fault light
@@ -147,16 +198,37 @@ THD_FUNCTION (stateThread, arg)
 
 		palWriteLine (LINE_LED_FAULT, vcuFault);
 
+		// Journal any new faults.
+		if (vehicleState == VEHICLE_STATE_FAILED && vehicleStatePrevious != VEHICLE_STATE_FAILED)
+			journalAppend (JOURNAL_EVENT_VEHICLE_FAILED, (amksState == AMK_STATE_INVALID) |
+				(physicalEeprom.state != MC24LC32_STATE_READY) << 1);
+
+		if (amksState == AMK_STATE_ERROR && amksStatePrevious != AMK_STATE_ERROR)
+			journalAppend (JOURNAL_EVENT_AMK_ERROR, 0);
+
+		if (!pedals.plausible && pedalsPlausiblePrevious)
+			journalAppend (JOURNAL_EVENT_PEDALS_IMPLAUSIBLE, 0);
+
+		vehicleStatePrevious = vehicleState;
+		amksStatePrevious = amksState;
+		pedalsPlausiblePrevious = pedals.plausible;
+
 		// Brake light
 		palWriteLine (LINE_OUTPUT_1, pedals.braking);
 
-		// Broadcast the sensor input message and debug message
-		transmitSensorInputPercent (&CAND1, STATE_CONTROL_PERIOD);
+		// Sleep until the next event, or the nearest deadline. Note the HV deadline only needs to be woken for in RTD, as HV
+		// transitions to LV immediately upon the loss of precharge.
+		sysinterval_t timeout = STATE_CONTROL_PERIOD_MAX;
+		if (buzzerActive && chTimeDiffX (timeCurrent, timeoutBuzzer) < timeout)
+			timeout = chTimeDiffX (timeCurrent, timeoutBuzzer);
+		if (vehicleState == VEHICLE_STATE_READY_TO_DRIVE && chTimeDiffX (timeCurrent, timeoutHv) < timeout)
+			timeout = chTimeDiffX (timeCurrent, timeoutHv);
+		if (timeout == TIME_IMMEDIATE)
+			timeout = 1;
 
-		// Sleep until the next loop
 		timePrevious = timeCurrent;
-		systime_t timeNext = chTimeAddX (timeCurrent, STATE_CONTROL_PERIOD);
-		chThdSleepUntilWindowed (timeCurrent, timeNext);
+		timeNext = chTimeAddX (timeCurrent, timeout);
+		events = chEvtWaitAnyTimeout (ALL_EVENTS, timeout);
 	}
 }
 
@@ -164,8 +236,12 @@ THD_FUNCTION (stateThread, arg)
 
 void stateThreadStart (tprio_t priority)
 {
-	// Start the torque control thread
-	chThdCreateStatic (&stateThreadWa, sizeof (stateThreadWa), priority, stateThread, NULL);
+	// Start the state control thread
+	controlThread = chThdCreateStatic (&stateThreadWa, sizeof (stateThreadWa), priority, stateThread, NULL);
+
+	// The button is active-low, so pressing it is a falling edge. Releasing it doesn't affect the vehicle state.
+	palEnableLineEvent (LINE_BUTTON_1_IN, PAL_EVENT_MODE_FALLING_EDGE);
+	palSetLineCallback (LINE_BUTTON_1_IN, buttonCallback, NULL);
 }
 
 void stateThreadSetTorquePlausibility (bool plausible, bool derating)
@@ -174,6 +250,60 @@ void stateThreadSetTorquePlausibility (bool plausible, bool derating)
 	if (!plausible)
 		palSetLine (LINE_LED_FAULT);
 
+	bool plausiblePrevious = torquePlausible;
 	torquePlausible = plausible;
 	torqueDerating = derating;
+
+	// Re-evaluate the fault indicator upon a change.
+	if (plausible != plausiblePrevious && controlThread != NULL)
+		chEvtSignal (controlThread, STATE_THREAD_EVENT_TORQUE);
+
+	// Journal the loss of plausibility.
+	if (!plausible && plausiblePrevious)
+		journalAppend (JOURNAL_EVENT_TORQUE_IMPLAUSIBLE, 0);
+}
+
+void stateThreadSignalPedals (void)
+{
+	// The state of the pedals at the previous call.
+	static bool braking = false;
+	static bool accelerating = false;
+	static bool plausible = true;
+
+	if (pedals.braking == braking && pedals.accelerating == accelerating && pedals.plausible == plausible)
+		return;
+
+	braking = pedals.braking;
+	accelerating = pedals.accelerating;
+	plausible = pedals.plausible;
+
+	if (controlThread != NULL)
+		chEvtSignal (controlThread, STATE_THREAD_EVENT_PEDALS);
+}
+
+void buttonCallback (void* arg)
+{
+	(void) arg;
+
+	chSysLockFromISR ();
+	chEvtSignalI (controlThread, STATE_THREAD_EVENT_BUTTON);
+	chSysUnlockFromISR ();
+}
+
+void updateTemperatures (void)
+{
+	temperatureInverterMax	= -FLT_MAX;
+	temperatureMotorMax		= -FLT_MAX;
+	for (size_t index = 0; index < AMK_COUNT; ++index)
+	{
+		canNodeLock ((canNode_t*) &amks [index]);
+
+		if (amks [index].temperatureInverter > temperatureInverterMax)
+			temperatureInverterMax = amks [index].temperatureInverter;
+
+		if (amks [index].temperatureMotor > temperatureMotorMax)
+			temperatureMotorMax = amks [index].temperatureMotor;
+
+		canNodeUnlock ((canNode_t*) &amks [index]);
+	}
 }
\ No newline at end of file
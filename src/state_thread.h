@@ -9,8 +9,18 @@
 // Description: Thread managing the global state of the VCU. This is responsible for implementing the vehicle state, fault
 //   conditions, and indicators.
 //
-// TODO(Barach):
-// - This has the same period as the torque thread, does it really need to be this fast?
+//   Rather than polling, the thread sleeps until something the vehicle state depends on changes:
+//   - A message from the BMS (precharge) or an AMK inverter (inverter state) is received.
+//   - The RTD button is pressed, signalled by its EXTI interrupt.
+//   - The state of the pedals (braking, accelerating or plausibility) changes, signalled by the torque thread.
+//   - The torque plausibility changes, signalled by the torque thread.
+//   - The BMS or an AMK inverter times out (or recovers), signalled by the CAN RX dispatcher.
+//   - The state of the EEPROM changes (it fails, or its magic string is invalidated), signalled by the EEPROM cache.
+//   - The RTD buzzer's deadline or the HV deadline is reached.
+//   Transitions therefore happen as soon as their cause is observed, rather than up to a period later. As the inverters
+//   broadcast far more often than their state changes, their messages only cause an evaluation if their aggregate state
+//   changed. Any condition that doesn't signal an event is caught by evaluating at least every 100 ms, and the temperatures
+//   (which change slowly) are aggregated at the same period.
 
 // Includes -------------------------------------------------------------------------------------------------------------------
 
@@ -62,13 +72,23 @@ extern float temperatureMotorMax;
 
 // Functions ------------------------------------------------------------------------------------------------------------------
 
+/**
+ * @brief Starts the state control thread.
+ * @param priority The priority to start the thread at.
+ */
 void stateThreadStart (tprio_t priority);
 
 /**
  * @brief Sets the torque plausibility / derating value of the vehicle.
- * @param plausible The value to write to @c torqueDerating .
+ * @param plausible The value to write to @c torquePlausible .
  * @param derating The value to write to @c torqueDerating .
  */
 void stateThreadSetTorquePlausibility (bool plausible, bool derating);
 
+/**
+ * @brief Notifies the state thread that the pedals have been sampled. The thread is only woken if the braking, accelerating or
+ * plausibility state of the pedals has changed since the previous call.
+ */
+void stateThreadSignalPedals (void);
+
 #endif // STATE_THREAD_H
\ No newline at end of file
@@ -3,7 +3,10 @@
 
 // Includes
 #include "can.h"
+#include "capture.h"
+#include "controls/amk_estimator.h"
 #include "controls/pid_controller.h"
+#include "controls/throttle_map.h"
 #include "controls/torque_vectoring.h"
 #include "controls/tv_const_bias.h"
 #include "controls/tv_linear_bias.h"
@@ -22,6 +25,9 @@
 
 #define CUMULATIVE_TORQUE_TOLERANCE 0.05f
 
+/// @brief Event signalled to the torque thread upon a pedal fault, see @c torqueThreadSignalFaultI .
+#define TORQUE_THREAD_EVENT_FAULT EVENT_MASK (0)
+
 // Global Data ----------------------------------------------------------------------------------------------------------------
 
 /// @brief The last calculated torque request.
@@ -36,6 +42,16 @@ float regenTorqueLimit = 0.0f;
 /// @brief The index of the selected torque-vectoring algorithm.
 static uint8_t algoritmIndex = 0;
 
+/// @brief The maps of the throttle request to the fraction of the driving torque limit. Double-buffered, such that a map is
+/// built in place while the other is in use. Both are zero (requesting no torque) until configured.
+static throttleMap_t throttleMaps [2];
+
+/// @brief The map in use by the torque thread, an element of @c throttleMaps .
+static const throttleMap_t* throttleMap = &throttleMaps [0];
+
+/// @brief The torque control thread.
+static thread_t* controlThread = NULL;
+
 static const tvConstBiasConfig_t STF_L_CONFIG =
 {
 	.drivingFrontRearBias	= 1,
@@ -139,10 +155,10 @@ bool requestApplyPowerLimit (tvOutput_t* request, float deltaTime);
  * @brief Applies regen limiting to a torque amount. De-rating is applied when the motor speed is below a certain value,
  * as negative torque can cause the motors to spin in reverse.
  * @param torque The torque to limit.
- * @param amk The inverter the torque is to be requested of.
+ * @param estimate The feedback estimate of the inverter the torque is to be requested of.
  * @return True if the torque was de-rated, false otherwise.
  */
-bool torqueApplyRegenLimit (float* torque, amkInverter_t* amk);
+bool torqueApplyRegenLimit (float* torque, const amkEstimate_t* estimate);
 
 /**
  * @brief Checks the validity of a torque request.
@@ -152,6 +168,21 @@ bool torqueApplyRegenLimit (float* torque, amkInverter_t* amk);
  */
 bool requestValidate (tvOutput_t* request, tvInput_t* input);
 
+/**
+ * @brief Sends a 0 torque request to each inverter. The torque limits are kept, as lowering them in motion will trigger a
+ * fault.
+ * @param resetRequest Whether to request the inverters reset their errors.
+ */
+void requestSendZero (bool resetRequest);
+
+/**
+ * @brief Records the current control signals into the capture buffer, see @c capture.h for more details.
+ * @param timeCurrent The time of the current control cycle.
+ * @param plausible The plausibility of the torque request.
+ * @param derating Whether the torque request is being de-rated.
+ */
+void requestCapture (systime_t timeCurrent, bool plausible, bool derating);
+
 // Thread Entrypoint ----------------------------------------------------------------------------------------------------------
 
 static THD_WORKING_AREA (torqueThreadWa, 512);
@@ -162,18 +193,39 @@ THD_FUNCTION (torqueThread, arg)
 
 	bool button3Held = false;
 	bool button5Held = false;
+	tvOutput_t torqueCommanded = { .valid = false };
 	systime_t timeCurrent = chVTGetSystemTimeX ();
 	while (true)
 	{
-		// Sleep until next loop.
+		// Sleep until next loop. Should a pedal fault occur in the meantime, a 0 torque request is sent immediately, rather
+		// than waiting for the next loop.
 		systime_t timePrevious = timeCurrent;
 		systime_t timeNext = chTimeAddX (timeCurrent, TORQUE_THREAD_PERIOD);
-		chThdSleepUntilWindowed (timeCurrent, timeNext);
+		while (true)
+		{
+			systime_t timeNow = chVTGetSystemTimeX ();
+			if (!chTimeIsInRangeX (timeNow, timeCurrent, timeNext))
+				break;
+
+			if (chEvtWaitAnyTimeout (TORQUE_THREAD_EVENT_FAULT, chTimeDiffX (timeNow, timeNext)) == 0)
+				break;
+
+			if (vehicleState == VEHICLE_STATE_READY_TO_DRIVE)
+				requestSendZero (false);
+
+			torqueCommanded = (tvOutput_t) { .valid = false };
+		}
 		timeCurrent = chVTGetSystemTimeX ();
 
 		// Sample the sensor inputs.
 		peripheralsSample (timePrevious, timeCurrent);
 
+		// Wake the state thread if the pedals have changed state.
+		stateThreadSignalPedals ();
+
+		// Estimate the inverter feedback, accounting for any lost frames.
+		amkEstimatorUpdate (timeCurrent, &torqueCommanded);
+
 		// Calculate the torque request and apply power limiting.
 		bool resetRequest = false;
 		tvInput_t input = requestCalculateInput (TORQUE_THREAD_PERIOD_S, &button3Held, &button5Held, &resetRequest);
@@ -187,25 +239,26 @@ THD_FUNCTION (torqueThread, arg)
 			if (plausible)
 			{
 				// Torque request message.
-				derating &= torqueApplyRegenLimit (&torqueRequest.torqueRl, &amkRl);
+				derating &= torqueApplyRegenLimit (&torqueRequest.torqueRl, &amkEstimateRl);
 				amkSendTorqueRequest (&amkRl, torqueRequest.torqueRl, AMK_DRIVING_TORQUE_MAX, -AMK_REGENERATIVE_TORQUE_MAX, resetRequest, TORQUE_THREAD_CAN_MESSAGE_TIMEOUT);
 
-				derating &= torqueApplyRegenLimit (&torqueRequest.torqueRr, &amkRr);
+				derating &= torqueApplyRegenLimit (&torqueRequest.torqueRr, &amkEstimateRr);
 				amkSendTorqueRequest (&amkRr, torqueRequest.torqueRr, AMK_DRIVING_TORQUE_MAX, -AMK_REGENERATIVE_TORQUE_MAX, resetRequest, TORQUE_THREAD_CAN_MESSAGE_TIMEOUT);
 
-				derating &= torqueApplyRegenLimit (&torqueRequest.torqueFl, &amkFl);
+				derating &= torqueApplyRegenLimit (&torqueRequest.torqueFl, &amkEstimateFl);
 				amkSendTorqueRequest (&amkFl, torqueRequest.torqueFl, AMK_DRIVING_TORQUE_MAX, -AMK_REGENERATIVE_TORQUE_MAX, resetRequest, TORQUE_THREAD_CAN_MESSAGE_TIMEOUT);
 
-				derating &= torqueApplyRegenLimit (&torqueRequest.torqueFr, &amkFr);
+				derating &= torqueApplyRegenLimit (&torqueRequest.torqueFr, &amkEstimateFr);
 				amkSendTorqueRequest (&amkFr, torqueRequest.torqueFr, AMK_DRIVING_TORQUE_MAX, -AMK_REGENERATIVE_TORQUE_MAX, resetRequest, TORQUE_THREAD_CAN_MESSAGE_TIMEOUT);
+
+				torqueCommanded = torqueRequest;
 			}
 			else
 			{
-				// Send 0 torque request message (keep torque limits, as lowering them in motion will trigger a fault).
-				amkSendTorqueRequest (&amkRl, 0, AMK_DRIVING_TORQUE_MAX, -AMK_REGENERATIVE_TORQUE_MAX, resetRequest, TORQUE_THREAD_CAN_MESSAGE_TIMEOUT);
-				amkSendTorqueRequest (&amkRr, 0, AMK_DRIVING_TORQUE_MAX, -AMK_REGENERATIVE_TORQUE_MAX, resetRequest, TORQUE_THREAD_CAN_MESSAGE_TIMEOUT);
-				amkSendTorqueRequest (&amkFl, 0, AMK_DRIVING_TORQUE_MAX, -AMK_REGENERATIVE_TORQUE_MAX, resetRequest, TORQUE_THREAD_CAN_MESSAGE_TIMEOUT);
-				amkSendTorqueRequest (&amkFr, 0, AMK_DRIVING_TORQUE_MAX, -AMK_REGENERATIVE_TORQUE_MAX, resetRequest, TORQUE_THREAD_CAN_MESSAGE_TIMEOUT);
+				// Send 0 torque request message.
+				requestSendZero (resetRequest);
+
+				torqueCommanded = (tvOutput_t) { .valid = false };
 			}
 		}
 		else
@@ -215,10 +268,15 @@ THD_FUNCTION (torqueThread, arg)
 			amkSendEnergizationRequest (&amkRr, false, resetRequest, TORQUE_THREAD_CAN_MESSAGE_TIMEOUT);
 			amkSendEnergizationRequest (&amkFl, false, resetRequest, TORQUE_THREAD_CAN_MESSAGE_TIMEOUT);
 			amkSendEnergizationRequest (&amkFr, false, resetRequest, TORQUE_THREAD_CAN_MESSAGE_TIMEOUT);
+
+			torqueCommanded = (tvOutput_t) { .valid = false };
 		}
 
 		// Nofify the state thread of the current plausibility.
 		stateThreadSetTorquePlausibility (plausible, derating);
+
+		// Record the control signals, if a capture is in progress.
+		requestCapture (timeCurrent, plausible, derating);
 	}
 }
 
@@ -227,7 +285,13 @@ THD_FUNCTION (torqueThread, arg)
 void torqueThreadStart (tprio_t priority)
 {
 	// Start the torque control thread
-	chThdCreateStatic (&torqueThreadWa, sizeof (torqueThreadWa), priority, torqueThread, NULL);
+	controlThread = chThdCreateStatic (&torqueThreadWa, sizeof (torqueThreadWa), priority, torqueThread, NULL);
+}
+
+void torqueThreadSignalFaultI (void)
+{
+	if (controlThread != NULL)
+		chEvtSignalI (controlThread, TORQUE_THREAD_EVENT_FAULT);
 }
 
 void torqueThreadSelectAlgorithm (uint8_t index)
@@ -254,6 +318,20 @@ void torqueThreadSetDrivingTorqueLimit (float torque)
 	drivingTorqueLimit = torque;
 }
 
+bool torqueThreadSetThrottleMap (const throttleMapConfig_t* config)
+{
+	// Build the map in the buffer not in use, then swap the buffers. The torque thread runs at a higher priority than any
+	// caller, so can't be preempted mid-evaluation by a subsequent rebuild.
+	throttleMap_t* map = throttleMap == &throttleMaps [0] ? &throttleMaps [1] : &throttleMaps [0];
+	bool result = throttleMapInit (map, config);
+
+	chSysLock ();
+	throttleMap = map;
+	chSysUnlock ();
+
+	return result;
+}
+
 void torqueThreadSetRegenTorqueLimit (float torque)
 {
 	if (torque > AMK_REGENERATIVE_TORQUE_MAX * AMK_COUNT)
@@ -324,7 +402,7 @@ tvInput_t requestCalculateInput (float deltaTime, bool* button3Held, bool* butto
 	tvInput_t input =
 	{
 		.deltaTime			= deltaTime,
-		.drivingTorqueLimit	= pedals.appsRequest * drivingTorqueLimit,
+		.drivingTorqueLimit	= throttleMapEvaluate (throttleMap, pedals.appsRequest) * drivingTorqueLimit,
 		.regenTorqueLimit	= regenRequest,
 	};
 	return input;
@@ -339,7 +417,7 @@ tvOutput_t requestCalculateOutput (tvInput_t* input)
 bool requestApplyPowerLimit (tvOutput_t* output, float deltaTime)
 {
 	// Calculate the cumulative power consumption of the inverters.
-	float cumulativePower = amksGetCumulativePower (amks, AMK_COUNT);
+	float cumulativePower = amkEstimatorGetCumulativePower ();
 
 	// Calculate the torque reduction ratio.
 	pidCalculate (&powerLimitPid, cumulativePower, deltaTime);
@@ -356,21 +434,21 @@ bool requestApplyPowerLimit (tvOutput_t* output, float deltaTime)
 	return (1.0f - torqueReductionRatio < FLT_EPSILON);
 }
 
-bool torqueApplyRegenLimit (float* torque, amkInverter_t* amk)
+bool torqueApplyRegenLimit (float* torque, const amkEstimate_t* estimate)
 {
 	// Negative torque means regen
 	if (*torque < 0)
 	{
 		// If the speed is below the end derating speed, clamp to 0.
-		if (amk->actualSpeed < physicalEepromMap->regenDeratingSpeedEnd)
+		if (estimate->speed < physicalEepromMap->regenDeratingSpeedEnd)
 		{
 			*torque = 0;
 			return true;
 		}
 		// If the speed is between the start and end derating speeds, lerp between them.
-		else if (amk->actualSpeed < physicalEepromMap->regenDeratingSpeedStart)
+		else if (estimate->speed < physicalEepromMap->regenDeratingSpeedStart)
 		{
-			*torque = lerp2d (amk->actualSpeed,
+			*torque = lerp2d (estimate->speed,
 				physicalEepromMap->regenDeratingSpeedEnd, 0,
 				physicalEepromMap->regenDeratingSpeedStart, *torque);
 			return true;
@@ -385,8 +463,9 @@ bool requestValidate (tvOutput_t* output, tvInput_t* input)
 	// Check the algorithm's output validity.
 	bool valid = output->valid;
 
-	// Check the pedal plausibility.
+	// Check the pedal plausibility. An analog watchdog fault bypasses the plausibility timeout.
 	valid &= pedals.plausible;
+	valid &= !pedals.watchdogFault;
 
 	// Calculate the cumulative driving and regen torques. These are calculated separately, as regen shouldn't allow more than
 	// the max driving torque to be requested, and vice versa.
@@ -418,4 +497,46 @@ bool requestValidate (tvOutput_t* output, tvInput_t* input)
 	valid &= regenTorque >= -input->regenTorqueLimit * (1 + CUMULATIVE_TORQUE_TOLERANCE);
 
 	return valid;
+}
+
+void requestSendZero (bool resetRequest)
+{
+	amkSendTorqueRequest (&amkRl, 0, AMK_DRIVING_TORQUE_MAX, -AMK_REGENERATIVE_TORQUE_MAX, resetRequest, TORQUE_THREAD_CAN_MESSAGE_TIMEOUT);
+	amkSendTorqueRequest (&amkRr, 0, AMK_DRIVING_TORQUE_MAX, -AMK_REGENERATIVE_TORQUE_MAX, resetRequest, TORQUE_THREAD_CAN_MESSAGE_TIMEOUT);
+	amkSendTorqueRequest (&amkFl, 0, AMK_DRIVING_TORQUE_MAX, -AMK_REGENERATIVE_TORQUE_MAX, resetRequest, TORQUE_THREAD_CAN_MESSAGE_TIMEOUT);
+	amkSendTorqueRequest (&amkFr, 0, AMK_DRIVING_TORQUE_MAX, -AMK_REGENERATIVE_TORQUE_MAX, resetRequest, TORQUE_THREAD_CAN_MESSAGE_TIMEOUT);
+}
+
+void requestCapture (systime_t timeCurrent, bool plausible, bool derating)
+{
+	if (captureState != CAPTURE_STATE_ARMED && captureState != CAPTURE_STATE_TRIGGERED)
+		return;
+
+	// Built in static memory, as the sample is too large for the thread's stack. Only this thread records samples.
+	static captureSample_t sample;
+	sample.time					= timeCurrent;
+	sample.apps1Sample			= pedals.apps1.sample;
+	sample.apps2Sample			= pedals.apps2.sample;
+	sample.bseFSample			= pedals.bseF.sample;
+	sample.bseRSample			= pedals.bseR.sample;
+	sample.sasSample			= sas.sample;
+	sample.vehicleState			= vehicleState;
+	sample.torquePlausible		= plausible;
+	sample.torqueDerating		= derating;
+	sample.pedalsPlausible		= pedals.plausible;
+	sample.feedbackConfident	= amkEstimatesConfident == (1 << AMK_COUNT) - 1;
+	sample.torqueRl				= torqueRequest.torqueRl;
+	sample.torqueRr				= torqueRequest.torqueRr;
+	sample.torqueFl				= torqueRequest.torqueFl;
+	sample.torqueFr				= torqueRequest.torqueFr;
+	sample.speedRl				= amkEstimateRl.speed;
+	sample.speedRr				= amkEstimateRr.speed;
+	sample.speedFl				= amkEstimateFl.speed;
+	sample.speedFr				= amkEstimateFr.speed;
+	sample.power				= amkEstimatorGetCumulativePower ();
+	sample.powerPidXp			= powerLimitPid.xp;
+	sample.powerPidXi			= powerLimitPid.xi;
+	sample.powerPidXd			= powerLimitPid.xd;
+
+	captureRecord (&sample);
 }
\ No newline at end of file
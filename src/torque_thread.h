@@ -13,6 +13,7 @@
 // Includes -------------------------------------------------------------------------------------------------------------------
 
 // Includes
+#include "controls/throttle_map.h"
 #include "controls/torque_vectoring.h"
 
 // ChibiOS
@@ -34,6 +35,12 @@ extern float regenTorqueLimit;
  */
 void torqueThreadStart (tprio_t priority);
 
+/**
+ * @brief Signals a pedal fault to the torque thread, which immediately sends a 0 torque request (if ready-to-drive). Safe to
+ * call from an ISR.
+ */
+void torqueThreadSignalFaultI (void);
+
 /**
  * @brief Selects a torque-vectoring algorithm to use.
  * @param index The index of the algorithm to use.
@@ -46,6 +53,14 @@ void torqueThreadSelectAlgorithm (uint8_t index);
  */
 void torqueThreadSetDrivingTorqueLimit (float torque);
 
+/**
+ * @brief Sets the map of the throttle request to the fraction of the driving torque limit. Must only be called from a single
+ * thread, of a lower priority than the torque thread.
+ * @param config The configuration of the map. Need not remain in scope.
+ * @return True if successful, false if the map is invalid (in which case the linear map is used).
+ */
+bool torqueThreadSetThrottleMap (const throttleMapConfig_t* config);
+
 // TODO(Barach): This is ignored.
 /**
  * @brief Sets the cumulative regenerative (negative) torque limit.
@@ -0,0 +1,207 @@
+// AMK Estimator Host Simulation ----------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.19
+//
+// Description: Runs the firmware's AMK feedback estimator (src/controls/amk_estimator.c) on the host, against a simulated
+//   inverter whose speed ramps at a constant rate under a constant torque. The inverter's actual-values frames arrive
+//   between control cycles, and a burst of consecutive frames is dropped part way through each run. For each run, the
+//   largest error of the speed & power over the burst is reported, both for the estimate and for the most recent measurement
+//   (the behaviour without an estimator), along with the number of control cycles in the burst the estimate was confident.
+//
+//   The estimator's translation unit is included directly, with the CAN interface it depends on (can.h, which requires the
+//   CAN drivers of the common library) replaced by the minimal stand-in below.
+//
+// Usage:
+//   gcc -O2 -I tools/host -I src -o amk_estimator_sim tools/amk_estimator/amk_estimator_sim.c -lm
+//   ./amk_estimator_sim [missed frame max]
+
+// CAN Interface Stand-In -----------------------------------------------------------------------------------------------------
+
+#define CAN_H
+
+// ChibiOS
+#include "ch.h"
+
+#define AMK_COUNT 4
+
+typedef enum
+{
+	CAN_SIGNAL_AMK_RL_ACTUAL_SPEED = 0,
+	CAN_SIGNAL_AMK_RR_ACTUAL_SPEED = 1,
+	CAN_SIGNAL_AMK_FL_ACTUAL_SPEED = 2,
+	CAN_SIGNAL_AMK_FR_ACTUAL_SPEED = 3
+} canSignal_t;
+
+typedef struct
+{
+	int unused;
+} canNode_t;
+
+typedef struct
+{
+	canNode_t node;
+	/// @brief The speed of the most recent frame, in RPM.
+	float actualSpeed;
+	/// @brief The power of the most recent frame, in Watts.
+	float actualPower;
+	/// @brief The arrival time of the most recent frame.
+	systime_t timestamp;
+	/// @brief Indicates whether any frame has been received.
+	bool received;
+} amkInverter_t;
+
+amkInverter_t amks [AMK_COUNT];
+
+static inline void canNodeLock (canNode_t* node) { (void) node; }
+static inline void canNodeUnlock (canNode_t* node) { (void) node; }
+
+static inline bool amkGetValidityLock (amkInverter_t* amk)
+{
+	return amk->received;
+}
+
+static inline float amksGetCumulativePower (amkInverter_t* amk, uint8_t count)
+{
+	(void) count;
+	return amk->actualPower;
+}
+
+static inline bool canGetSignalTimestamp (canSignal_t signal, systime_t* timestamp)
+{
+	*timestamp = amks [signal].timestamp;
+	return amks [signal].received;
+}
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "controls/amk_estimator.c"
+
+// C Standard Library
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The period of the control loop, in ticks.
+#define CYCLE_PERIOD TIME_MS2I (10)
+
+/// @brief The period of the actual-values frames, in ticks.
+#define FRAME_PERIOD TIME_MS2I (10)
+
+/// @brief The time each frame arrives at, relative to the start of a control cycle, in ticks.
+#define FRAME_OFFSET TIME_MS2I (4)
+
+/// @brief The time the first frame of the burst is dropped at, in ticks.
+#define BURST_START TIME_MS2I (1000)
+
+/// @brief The duration of each run, in ticks.
+#define DURATION TIME_MS2I (1500)
+
+/// @brief The speed at the start of each run, in RPM.
+#define SPEED_INITIAL 1000.0f
+
+/// @brief The torque commanded throughout each run, in Nm.
+#define TORQUE 20.0f
+
+// Global Data ----------------------------------------------------------------------------------------------------------------
+
+systime_t hostSystemTime = 0;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Simulates a single run, printing the results.
+ * @param rate The rate of change of speed, in RPM/s.
+ * @param dropCount The number of consecutive frames to drop.
+ * @param missedFrameMax The estimator's configured horizon.
+ */
+static void simulate (float rate, uint16_t dropCount, uint16_t missedFrameMax)
+{
+	memset (amks, 0, sizeof (amks));
+	memset (amkEstimates, 0, sizeof (amkEstimates));
+
+	amkEstimatorConfig_t estimatorConfig = { .missedFrameMax = missedFrameMax };
+	amkEstimatorReconfigure (&estimatorConfig);
+
+	tvOutput_t torqueCommanded = { .torqueRl = TORQUE };
+	amkInverter_t* amk = &amks [0];
+	amkEstimate_t* estimate = &amkEstimateRl;
+
+	float speedErrorMax = 0.0f;
+	float speedStaleErrorMax = 0.0f;
+	float powerErrorMax = 0.0f;
+	float powerStaleErrorMax = 0.0f;
+	unsigned burstCycles = 0;
+	unsigned confidentCycles = 0;
+
+	systime_t burstEnd = BURST_START + dropCount * FRAME_PERIOD;
+	systime_t frameNext = FRAME_OFFSET;
+	for (systime_t time = CYCLE_PERIOD; time < DURATION; time += CYCLE_PERIOD)
+	{
+		// Deliver (or drop) the frames that arrived since the previous cycle.
+		for (; frameNext <= time; frameNext += FRAME_PERIOD)
+		{
+			if (frameNext >= BURST_START && frameNext < burstEnd)
+				continue;
+
+			amk->actualSpeed = SPEED_INITIAL + rate * TIME_I2US (frameNext) / 1000000.0f;
+			amk->actualPower = TORQUE * amk->actualSpeed * RPM_TO_RAD_PER_S;
+			amk->timestamp = frameNext;
+			amk->received = true;
+		}
+
+		hostSystemTime = time;
+		amkEstimatorUpdate (time, &torqueCommanded);
+
+		// Only assess the cycles in which the measurement is stale.
+		if (time <= BURST_START || time >= burstEnd + FRAME_OFFSET)
+			continue;
+
+		float speed = SPEED_INITIAL + rate * TIME_I2US (time) / 1000000.0f;
+		float power = TORQUE * speed * RPM_TO_RAD_PER_S;
+
+		float speedError = fabsf (estimate->speed - speed);
+		float speedStaleError = fabsf (amk->actualSpeed - speed);
+		float powerError = fabsf (estimate->power - power);
+		float powerStaleError = fabsf (amk->actualPower - power);
+
+		if (speedError > speedErrorMax)
+			speedErrorMax = speedError;
+		if (speedStaleError > speedStaleErrorMax)
+			speedStaleErrorMax = speedStaleError;
+		if (powerError > powerErrorMax)
+			powerErrorMax = powerError;
+		if (powerStaleError > powerStaleErrorMax)
+			powerStaleErrorMax = powerStaleError;
+
+		++burstCycles;
+		if (estimate->confident)
+			++confidentCycles;
+	}
+
+	printf ("%7.0f | %5u | %9.3f %9.3f | %9.3f %9.3f | %3u / %3u\n", rate, dropCount, speedErrorMax, speedStaleErrorMax,
+		powerErrorMax, powerStaleErrorMax, confidentCycles, burstCycles);
+}
+
+// Entrypoint -----------------------------------------------------------------------------------------------------------------
+
+int main (int argc, char** argv)
+{
+	uint16_t missedFrameMax = argc > 1 ? strtoul (argv [1], NULL, 0) : 2;
+
+	printf ("Missed frame max %u, frame period %u ms, torque %.1f Nm.\n", missedFrameMax, TIME_I2MS (FRAME_PERIOD), TORQUE);
+	printf ("        |       | Speed error (RPM)   | Power error (W)     |\n");
+	printf ("  RPM/s | Drops |  Estimate     Stale |  Estimate     Stale | Confident\n");
+
+	const float rates [] = { 1000.0f, 5000.0f };
+	const uint16_t dropCounts [] = { 1, 2, 4 };
+	for (size_t rateIndex = 0; rateIndex < sizeof (rates) / sizeof (rates [0]); ++rateIndex)
+		for (size_t dropIndex = 0; dropIndex < sizeof (dropCounts) / sizeof (dropCounts [0]); ++dropIndex)
+			simulate (rates [rateIndex], dropCounts [dropIndex], missedFrameMax);
+
+	return 0;
+}
\ No newline at end of file
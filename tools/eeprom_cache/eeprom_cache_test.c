@@ -0,0 +1,278 @@
+// EEPROM Cache Host Test -----------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.19
+//
+// Description: Runs the firmware's MC24LC32 write-back cache (src/peripherals/eeprom_cache.c) on the host, against an
+//   emulated 24LC32 behind a stubbed I2C bus. The emulator models the device's page writes (wrapping at the page boundary)
+//   and its ~5 ms write cycle, during which it doesn't acknowledge its address. The following are checked, printing the
+//   number of I2C transactions of each:
+//   - Sequential writes: 100 4-byte writes (as a block transfer would make) are coalesced into one page write per page.
+//   - Repeated writes: Writing the same page many times costs a single page write.
+//   - Unchanged writes: Writes that don't change the mirror's contents cost no page writes.
+//   - Failed writes: A page whose write fails stays dirty, and is written by the next flush.
+//   - Magic string: Writing the magic string through the cache re-validates the EEPROM's state.
+//   After each flush, the device's contents are checked to match the RAM mirror. Returns non-zero if any check failed.
+//
+//   The cache's translation unit is included directly, with the I2C supervisor (which requires the HAL) replaced by the
+//   minimal stand-in below, and the MC24LC32 driver of the common library by tools/host/peripherals/i2c/mc24lc32.h. The
+//   flush thread isn't run, rather the background load and each flush are performed by the test.
+//
+// Usage:
+//   gcc -O2 -I tools/host -I src -o eeprom_cache_test tools/eeprom_cache/eeprom_cache_test.c
+//   ./eeprom_cache_test
+
+// Driver Stand-Ins -----------------------------------------------------------------------------------------------------------
+
+#define I2C_SUPERVISOR_H
+
+// Includes
+#include "peripherals/i2c/mc24lc32.h"
+
+typedef struct
+{
+	uint16_t recoveryCount;
+} i2cSupervisor_t;
+
+static msg_t i2cSupervisorTransmit (i2cSupervisor_t* supervisor, i2caddr_t addr, const uint8_t* tx, size_t txCount,
+	uint8_t* rx, size_t rxCount, sysinterval_t timeout);
+static bool i2cSupervisorCheck (i2cSupervisor_t* supervisor);
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "peripherals/eeprom_cache.c"
+
+// C Standard Library
+#include <stdio.h>
+#include <stdlib.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The duration of the device's write cycle.
+#define WRITE_CYCLE_TIME TIME_MS2I (5)
+
+/// @brief The size of the boot region, in bytes.
+#define BOOT_SIZE 256
+
+/// @brief The magic string of the EEPROM.
+#define MAGIC_STRING "HOST_TEST_1"
+
+// Global Data ----------------------------------------------------------------------------------------------------------------
+
+systime_t hostSystemTime = 0;
+
+/// @brief The contents of the emulated device.
+static uint8_t device [EEPROM_SIZE];
+
+/// @brief The time the device's current write cycle completes.
+static systime_t writeCycleEnd = 0;
+
+/// @brief Indicates the next page write should fail.
+static bool writeFail = false;
+
+/// @brief Statistics of the I2C transactions.
+static unsigned pageWriteCount = 0;
+static unsigned pollCount = 0;
+
+/// @brief The number of failed checks.
+static unsigned failureCount = 0;
+
+static const mc24lc32Config_t CONFIG =
+{
+	.addr			= 0x50,
+	.timeout		= TIME_MS2I (100),
+	.magicString	= MAGIC_STRING
+};
+
+static mc24lc32_t eeprom;
+
+static i2cSupervisor_t supervisor;
+
+// Driver Stand-Ins -----------------------------------------------------------------------------------------------------------
+
+void eepromInit (eeprom_t* eeprom, eepromWriteHandler_t* writeHandler, eepromReadHandler_t* readHandler)
+{
+	eeprom->writeHandler = writeHandler;
+	eeprom->readHandler = readHandler;
+}
+
+bool mc24lc32Init (mc24lc32_t* eeprom, const mc24lc32Config_t* config)
+{
+	(void) eeprom;
+	(void) config;
+	return false;
+}
+
+msg_t i2cSupervisorTransmit (i2cSupervisor_t* supervisor, i2caddr_t addr, const uint8_t* tx, size_t txCount, uint8_t* rx,
+	size_t rxCount, sysinterval_t timeout)
+{
+	(void) supervisor;
+	(void) addr;
+	(void) timeout;
+
+	// The device doesn't acknowledge its address during a write cycle.
+	if ((int32_t) (hostSystemTime - writeCycleEnd) < 0)
+	{
+		++pollCount;
+		return MSG_RESET;
+	}
+
+	uint16_t wordAddr = ((tx [0] << 8) | tx [1]) % EEPROM_SIZE;
+
+	if (rxCount != 0)
+	{
+		// Sequential read, wrapping at the end of the device.
+		for (size_t index = 0; index < rxCount; ++index)
+			rx [index] = device [(wordAddr + index) % EEPROM_SIZE];
+		return MSG_OK;
+	}
+
+	if (txCount == 2)
+	{
+		// Acknowledge poll, the device is ready.
+		++pollCount;
+		return MSG_OK;
+	}
+
+	// Page write, wrapping at the page boundary.
+	++pageWriteCount;
+	if (writeFail)
+	{
+		writeFail = false;
+		return MSG_RESET;
+	}
+
+	uint16_t pageBase = wordAddr - wordAddr % EEPROM_CACHE_PAGE_SIZE;
+	for (size_t index = 0; index < txCount - 2; ++index)
+		device [pageBase + (wordAddr + index) % EEPROM_CACHE_PAGE_SIZE] = tx [2 + index];
+
+	writeCycleEnd = hostSystemTime + WRITE_CYCLE_TIME;
+	return MSG_OK;
+}
+
+bool i2cSupervisorCheck (i2cSupervisor_t* supervisor)
+{
+	(void) supervisor;
+	return true;
+}
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Records the result of a check, printing it if it failed.
+ */
+static void check (bool condition, const char* name, const char* description)
+{
+	if (condition)
+		return;
+
+	printf ("FAIL: %s: %s\n", name, description);
+	++failureCount;
+}
+
+/**
+ * @brief Resets the transaction statistics.
+ */
+static void resetStats (void)
+{
+	pageWriteCount = 0;
+	pollCount = 0;
+}
+
+/**
+ * @brief Flushes the cache, checking every page was written and the device matches the mirror. Prints the statistics of the
+ * flush.
+ */
+static void flush (const char* name, unsigned writeCount)
+{
+	systime_t timeStart = hostSystemTime;
+	unsigned dirtyCount = eepromCacheDirtyCount;
+
+	flushPages ();
+
+	check (eepromCacheDirtyCount == 0, name, "Pages left dirty.");
+	check (memcmp (device, eeprom.cache, EEPROM_SIZE) == 0, name, "Device doesn't match the mirror.");
+
+	printf ("%-18s | %6u | %5u | %10u | %5u | %7lu ms\n", name, writeCount, dirtyCount, pageWriteCount, pollCount,
+		(unsigned long) TIME_I2MS (hostSystemTime - timeStart));
+}
+
+// Entrypoint -----------------------------------------------------------------------------------------------------------------
+
+int main (void)
+{
+	// Initial device contents, a valid magic string followed by noise.
+	srand (1);
+	for (size_t index = 0; index < EEPROM_SIZE; ++index)
+		device [index] = rand ();
+	memcpy (device, MAGIC_STRING, sizeof (MAGIC_STRING));
+
+	// Load the boot region, then the remainder of the device (normally done by the flush thread).
+	eeprom.config = &CONFIG;
+	check (eepromCacheInit (&eeprom, &CONFIG, &supervisor, BOOT_SIZE, NORMALPRIO), "Init", "Boot load failed.");
+	check (eeprom.state == MC24LC32_STATE_READY, "Init", "Magic string not validated.");
+	check (memcmp (device, eeprom.cache, BOOT_SIZE) == 0, "Init", "Boot region doesn't match the device.");
+	memcpy (eeprom.cache, device, EEPROM_SIZE);
+	loaded = true;
+
+	printf ("Name               | Writes | Dirty | Page Write | Polls | Flush Time\n");
+
+	// Sequential writes, starting on a page boundary.
+	resetStats ();
+	for (uint16_t index = 0; index < 100; ++index)
+	{
+		uint32_t value = 0xC0FFEE00 + index;
+		check (eepromCache.writeHandler (&eepromCache, 0x0100 + index * 4, &value, 4), "Sequential", "Write rejected.");
+	}
+	flush ("Sequential", 100);
+	check (pageWriteCount == 13, "Sequential", "Expected 13 page writes.");
+
+	// Repeated writes to a single page.
+	resetStats ();
+	for (uint16_t index = 0; index < 100; ++index)
+	{
+		uint8_t value = index;
+		check (eepromCache.writeHandler (&eepromCache, 0x0800 + index % 32, &value, 1), "Repeated", "Write rejected.");
+	}
+	flush ("Repeated", 100);
+	check (pageWriteCount == 1, "Repeated", "Expected 1 page write.");
+
+	// Writes of the current contents.
+	resetStats ();
+	for (uint16_t index = 0; index < 100; ++index)
+	{
+		uint32_t value = 0xC0FFEE00 + index;
+		check (eepromCache.writeHandler (&eepromCache, 0x0100 + index * 4, &value, 4), "Unchanged", "Write rejected.");
+	}
+	flush ("Unchanged", 100);
+	check (pageWriteCount == 0, "Unchanged", "Expected no page writes.");
+
+	// A failed page write, retried by the next flush.
+	resetStats ();
+	uint8_t data [64];
+	memset (data, 0x5A, sizeof (data));
+	check (eepromCache.writeHandler (&eepromCache, 0x0A00, data, sizeof (data)), "Failed", "Write rejected.");
+	writeFail = true;
+	flushPages ();
+	check (eepromCacheDirtyCount == 2, "Failed", "Failed page not left dirty.");
+	flush ("Failed (retry)", 1);
+	check (pageWriteCount == 3, "Failed", "Expected 3 page writes.");
+
+	// Invalidating, then restoring, the magic string.
+	resetStats ();
+	check (eepromCache.writeHandler (&eepromCache, 0x0000, "X", 1), "Magic", "Write rejected.");
+	check (eeprom.state == MC24LC32_STATE_INVALID, "Magic", "Invalidated magic string not detected.");
+	check (eepromCache.writeHandler (&eepromCache, 0x0000, MAGIC_STRING, 1), "Magic", "Write rejected.");
+	check (eeprom.state == MC24LC32_STATE_READY, "Magic", "Restored magic string not detected.");
+	flush ("Magic", 2);
+
+	if (failureCount != 0)
+	{
+		printf ("%u check(s) failed.\n", failureCount);
+		return 1;
+	}
+
+	printf ("All checks passed.\n");
+	return 0;
+}
\ No newline at end of file
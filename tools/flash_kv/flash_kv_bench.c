@@ -0,0 +1,280 @@
+// Flash Key-Value Store Host Benchmark ---------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.19
+//
+// Description: Runs the firmware's flash key-value store (src/flash_kv.c) against an emulated NOR flash on the host. The
+//   emulator enforces the semantics of the STM32F405's flash (programming can only clear bits, erasing sets every bit of a
+//   sector) and models its timing (~16 us per word programmed, ~1.5 s per 128 KB sector erased). Two runs are performed:
+//   - Benchmark: Repeatedly updates a set of keys, reporting the flash time per update, the number of updates per erase, and
+//     the host time to mount a full sector.
+//   - Power-loss: Repeatedly updates random keys, cutting the power at a random word. After each cut the store is re-mounted,
+//     and every key is checked to hold either its previous value or the value being written (never anything else).
+//
+// Usage:
+//   gcc -O2 -I src -o flash_kv_bench tools/flash_kv/flash_kv_bench.c src/flash_kv.c src/crc.c
+//   ./flash_kv_bench [update count] [power-loss iterations]
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "flash_kv.h"
+
+// C Standard Library
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+#define SECTOR_SIZE				0x20000
+#define SECTOR_WORDS			(SECTOR_SIZE / sizeof (uint32_t))
+#define PROGRAM_TIME_US			16.0
+#define ERASE_TIME_US			1500000.0
+
+/// @brief The number of keys updated by each run.
+#define KEY_COUNT				8
+
+/// @brief The size of the value of each key, in bytes.
+#define VALUE_SIZE				28
+
+// Flash Emulator -------------------------------------------------------------------------------------------------------------
+
+typedef struct
+{
+	uint32_t sectors [2][SECTOR_WORDS];
+	uint32_t eraseCounts [2];
+	uint64_t programCount;
+	double time;
+
+	/// @brief The number of words that can be programmed before the power is cut, negative for never.
+	int64_t powerBudget;
+	/// @brief Indicates the power has been cut, all operations fail until cleared.
+	bool powerLost;
+} flashEmulator_t;
+
+static bool emulatorErase (void* object, uint8_t sector)
+{
+	flashEmulator_t* flash = object;
+	if (flash->powerLost)
+		return false;
+
+	memset (flash->sectors [sector], 0xFF, SECTOR_SIZE);
+	++flash->eraseCounts [sector];
+	flash->time += ERASE_TIME_US;
+	return true;
+}
+
+static bool emulatorProgram (void* object, uint32_t* addr, const uint32_t* data, uint32_t count)
+{
+	flashEmulator_t* flash = object;
+
+	for (uint32_t index = 0; index < count; ++index)
+	{
+		if (flash->powerLost)
+			return false;
+
+		// Cut the power mid-word, leaving a random subset of the bits programmed.
+		if (flash->powerBudget == 0)
+		{
+			addr [index] &= data [index] | (uint32_t) rand ();
+			flash->powerLost = true;
+			return false;
+		}
+		if (flash->powerBudget > 0)
+			--flash->powerBudget;
+
+		// NOR flash can only clear bits.
+		if ((addr [index] & data [index]) != data [index])
+		{
+			fprintf (stderr, "Programming error: word at %p is 0x%08X, cannot program 0x%08X.\n", (void*) (addr + index),
+				addr [index], data [index]);
+			exit (-1);
+		}
+
+		addr [index] = data [index];
+		++flash->programCount;
+		flash->time += PROGRAM_TIME_US;
+	}
+
+	return true;
+}
+
+static void emulatorConfig (flashEmulator_t* flash, flashKvConfig_t* config)
+{
+	*config = (flashKvConfig_t)
+	{
+		.sectors	= { flash->sectors [0], flash->sectors [1] },
+		.sectorSize	= SECTOR_SIZE,
+		.erase		= emulatorErase,
+		.program	= emulatorProgram,
+		.object		= flash
+	};
+}
+
+// Benchmark ------------------------------------------------------------------------------------------------------------------
+
+static double hostTimeUs (void)
+{
+	struct timespec time;
+	clock_gettime (CLOCK_MONOTONIC, &time);
+	return time.tv_sec * 1e6 + time.tv_nsec / 1e3;
+}
+
+static int benchmark (uint32_t updateCount)
+{
+	static flashEmulator_t flash;
+	memset (&flash, 0xFF, sizeof (flash.sectors));
+	flash.powerBudget = -1;
+
+	flashKvConfig_t config;
+	emulatorConfig (&flash, &config);
+
+	flashKv_t kv;
+	if (!flashKvInit (&kv, &config))
+		return -1;
+
+	uint32_t compactions = 0;
+	double timeFlash = flash.time;
+	double timeHost = hostTimeUs ();
+	for (uint32_t update = 0; update < updateCount; ++update)
+	{
+		uint8_t value [VALUE_SIZE];
+		memset (value, update, sizeof (value));
+
+		if (!flashKvWrite (&kv, update % KEY_COUNT, value, sizeof (value)))
+		{
+			if (!flashKvCompact (&kv) || !flashKvWrite (&kv, update % KEY_COUNT, value, sizeof (value)))
+				return -1;
+			++compactions;
+		}
+	}
+	timeHost = hostTimeUs () - timeHost;
+	timeFlash = flash.time - timeFlash;
+
+	// Fill the active sector, then time the mount (worst-case scan).
+	uint8_t value [VALUE_SIZE] = { 0 };
+	while (flashKvWrite (&kv, 0, value, sizeof (value)));
+	double timeMount = hostTimeUs ();
+	if (!flashKvInit (&kv, &config))
+		return -1;
+	timeMount = hostTimeUs () - timeMount;
+
+	uint32_t recordsPerSector = (SECTOR_SIZE - 8) / (8 + (VALUE_SIZE + 3) / 4 * 4);
+	printf ("Benchmark (%u updates of %u keys, %u byte values):\n", updateCount, KEY_COUNT, VALUE_SIZE);
+	printf ("  Records per sector:          %u\n", recordsPerSector);
+	printf ("  Compactions:                 %u\n", compactions);
+	printf ("  Sector erases:               %u / %u\n", flash.eraseCounts [0], flash.eraseCounts [1]);
+	printf ("  Updates per erase:           %.0f\n", (double) updateCount / (flash.eraseCounts [0] + flash.eraseCounts [1]));
+	printf ("  Flash time per update:       %.1f us (amortized, including erases)\n", timeFlash / updateCount);
+	printf ("  Flash time per append:       %.1f us\n", PROGRAM_TIME_US * (2 + (VALUE_SIZE + 3) / 4));
+	printf ("  Host time per update:        %.3f us\n", timeHost / updateCount);
+	printf ("  Host time to mount a full sector: %.1f us\n", timeMount);
+	return 0;
+}
+
+// Power-Loss Test ------------------------------------------------------------------------------------------------------------
+
+static int powerLoss (uint32_t iterations)
+{
+	static flashEmulator_t flash;
+	memset (&flash, 0xFF, sizeof (flash.sectors));
+	flash.powerBudget = -1;
+
+	flashKvConfig_t config;
+	emulatorConfig (&flash, &config);
+
+	flashKv_t kv;
+	if (!flashKvInit (&kv, &config))
+		return -1;
+
+	// The last committed value of each key, and the value in flight (if any).
+	uint32_t committed [KEY_COUNT] = { 0 };
+	uint32_t pending [KEY_COUNT] = { 0 };
+	bool written [KEY_COUNT] = { false };
+
+	uint32_t failures = 0;
+	for (uint32_t iteration = 0; iteration < iterations; ++iteration)
+	{
+		// Run a random number of updates, cutting the power at a random word.
+		flash.powerBudget = rand () % 4096;
+		while (!flash.powerLost)
+		{
+			uint16_t key = rand () % KEY_COUNT;
+			uint32_t value = rand ();
+			pending [key] = value;
+
+			bool result = flashKvWrite (&kv, key, &value, sizeof (value));
+			if (!result && !flash.powerLost)
+				result = flashKvCompact (&kv) && flashKvWrite (&kv, key, &value, sizeof (value));
+
+			if (result)
+			{
+				committed [key] = value;
+				written [key] = true;
+			}
+
+			if (flash.powerLost)
+			{
+				// Every other key must hold its committed value.
+				for (uint16_t other = 0; other < KEY_COUNT; ++other)
+					if (other != key)
+						pending [other] = committed [other];
+				break;
+			}
+		}
+
+		// Restore the power and re-mount.
+		flash.powerLost = false;
+		flash.powerBudget = -1;
+		if (!flashKvInit (&kv, &config))
+			return -1;
+
+		for (uint16_t key = 0; key < KEY_COUNT; ++key)
+		{
+			uint32_t value;
+			bool present = flashKvRead (&kv, key, &value, sizeof (value));
+			if (!present && !written [key])
+				continue;
+
+			if (!present || (value != committed [key] && value != pending [key]))
+			{
+				++failures;
+				continue;
+			}
+
+			// The in-flight write may or may not have completed.
+			committed [key] = value;
+			written [key] = true;
+		}
+	}
+
+	printf ("Power-loss (%u iterations): %u failures, %u / %u sector erases\n", iterations, failures, flash.eraseCounts [0],
+		flash.eraseCounts [1]);
+	return failures == 0 ? 0 : -1;
+}
+
+// Entrypoint -----------------------------------------------------------------------------------------------------------------
+
+int main (int argc, char** argv)
+{
+	uint32_t updateCount = argc > 1 ? strtoul (argv [1], NULL, 0) : 100000;
+	uint32_t iterations = argc > 2 ? strtoul (argv [2], NULL, 0) : 2000;
+
+	srand (0);
+
+	if (benchmark (updateCount) != 0)
+	{
+		fprintf (stderr, "Benchmark failed.\n");
+		return -1;
+	}
+
+	if (powerLoss (iterations) != 0)
+	{
+		fprintf (stderr, "Power-loss test failed.\n");
+		return -1;
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+#ifndef CH_H
+#define CH_H
+
+// ChibiOS Host Stand-In ------------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.19
+//
+// Description: The subset of the ChibiOS RT API used by the firmware modules exercised by the host tools. Placing this
+//   directory on the include path ahead of src/ lets a module's translation unit be compiled on the host unmodified. The
+//   tools are single-threaded, so locks are no-ops, threads are never started, and waits return immediately. System time
+//   matches the firmware's configuration (a 10 kHz tick), but only advances as the tool dictates.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// C Standard Library
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+#define CH_CFG_ST_FREQUENCY 10000
+
+#define NORMALPRIO 128
+
+#define MSG_OK			((msg_t) 0)
+#define MSG_TIMEOUT		((msg_t) -1)
+#define MSG_RESET		((msg_t) -2)
+
+#define TIME_IMMEDIATE	((sysinterval_t) 0)
+#define TIME_INFINITE	((sysinterval_t) -1)
+
+#define TIME_MS2I(ms)	((sysinterval_t) ((ms) * (CH_CFG_ST_FREQUENCY / 1000)))
+#define TIME_US2I(us)	((sysinterval_t) ((us) / (1000000 / CH_CFG_ST_FREQUENCY)))
+#define TIME_I2MS(i)	((uint32_t) ((i) / (CH_CFG_ST_FREQUENCY / 1000)))
+#define TIME_I2US(i)	((uint32_t) ((i) * (1000000 / CH_CFG_ST_FREQUENCY)))
+
+#define EVENT_MASK(eid)	((eventmask_t) 1 << (eventmask_t) (eid))
+#define ALL_EVENTS		((eventmask_t) -1)
+
+#define THD_WORKING_AREA(name, size) uint64_t name [(size) / sizeof (uint64_t)]
+#define THD_FUNCTION(name, arg) void name (void* arg)
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef uint32_t systime_t;
+typedef uint32_t sysinterval_t;
+typedef uint32_t tprio_t;
+typedef int32_t msg_t;
+typedef uint32_t eventmask_t;
+
+typedef struct { int unused; } thread_t;
+typedef struct { int unused; } mutex_t;
+typedef struct { int unused; } condition_variable_t;
+typedef struct { int unused; } event_source_t;
+
+typedef void (tfunc_t) (void* arg);
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The current system time, advanced by the tool.
+extern systime_t hostSystemTime;
+
+static inline void chSysLock (void) {}
+static inline void chSysUnlock (void) {}
+
+static inline systime_t chVTGetSystemTimeX (void) { return hostSystemTime; }
+static inline sysinterval_t chTimeDiffX (systime_t start, systime_t end) { return end - start; }
+static inline sysinterval_t chVTTimeElapsedSinceX (systime_t start) { return hostSystemTime - start; }
+
+static inline void chMtxObjectInit (mutex_t* mutex) { (void) mutex; }
+static inline void chMtxLock (mutex_t* mutex) { (void) mutex; }
+static inline void chMtxUnlock (mutex_t* mutex) { (void) mutex; }
+
+static inline void chCondObjectInit (condition_variable_t* condition) { (void) condition; }
+static inline void chCondBroadcast (condition_variable_t* condition) { (void) condition; }
+static inline msg_t chCondWait (condition_variable_t* condition) { (void) condition; return MSG_OK; }
+
+static inline void chEvtObjectInit (event_source_t* source) { (void) source; }
+static inline void chEvtBroadcast (event_source_t* source) { (void) source; }
+static inline void chEvtSignal (thread_t* thread, eventmask_t events) { (void) thread; (void) events; }
+static inline eventmask_t chEvtWaitAnyTimeout (eventmask_t events, sysinterval_t timeout)
+{
+	(void) events;
+	(void) timeout;
+	return 0;
+}
+
+static inline void chRegSetThreadName (const char* name) { (void) name; }
+static inline void chThdSleep (sysinterval_t interval) { hostSystemTime += interval; }
+static inline thread_t* chThdCreateStatic (void* workingArea, size_t size, tprio_t priority, tfunc_t* function, void* arg)
+{
+	static thread_t thread;
+	(void) workingArea;
+	(void) size;
+	(void) priority;
+	(void) function;
+	(void) arg;
+	return &thread;
+}
+
+#endif // CH_H
\ No newline at end of file
@@ -0,0 +1,59 @@
+#ifndef MC24LC32_H
+#define MC24LC32_H
+
+// MC24LC32 Driver Host Stand-In ----------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.19
+//
+// Description: The subset of the common library's MC24LC32 driver (and the EEPROM interface it implements) used by the
+//   firmware modules exercised by the host tools. Only the datatypes are provided, any function used must be defined by the
+//   tool.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// ChibiOS
+#include "ch.h"
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef uint16_t i2caddr_t;
+
+typedef bool (eepromWriteHandler_t) (void* object, uint16_t addr, const void* data, uint16_t dataCount);
+typedef bool (eepromReadHandler_t) (void* object, uint16_t addr, void* data, uint16_t dataCount);
+
+typedef struct
+{
+	eepromWriteHandler_t* writeHandler;
+	eepromReadHandler_t* readHandler;
+} eeprom_t;
+
+typedef enum
+{
+	MC24LC32_STATE_FAILED	= 0,
+	MC24LC32_STATE_INVALID	= 1,
+	MC24LC32_STATE_READY	= 2
+} mc24lc32State_t;
+
+typedef struct
+{
+	i2caddr_t addr;
+	sysinterval_t timeout;
+	const char* magicString;
+} mc24lc32Config_t;
+
+typedef struct
+{
+	eeprom_t eeprom;
+	const mc24lc32Config_t* config;
+	mc24lc32State_t state;
+	uint8_t cache [4096];
+} mc24lc32_t;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+void eepromInit (eeprom_t* eeprom, eepromWriteHandler_t* writeHandler, eepromReadHandler_t* readHandler);
+
+bool mc24lc32Init (mc24lc32_t* eeprom, const mc24lc32Config_t* config);
+
+#endif // MC24LC32_H
\ No newline at end of file
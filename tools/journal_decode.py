@@ -0,0 +1,125 @@
+#!/usr/bin/env python3
+
+# VCU Fault & Event Journal Decoder -------------------------------------------------------------------------------------------
+#
+# Author: agent
+# Date Created: 2026.10.19
+#
+# Description: Decodes the VCU's fault & event journal (see src/journal.h). The input is a binary dump of the journal window
+#   of the virtual EEPROM (0x8000), for any number of pages. Pages may be concatenated into a single file, or given as separate
+#   files. Erased & corrupt entries are skipped, duplicates (the same entry read from multiple dumps) are merged, and the
+#   remaining entries are printed ordered by their sequence number.
+#
+# Usage:
+#   python3 tools/journal_decode.py page_00.bin page_01.bin ...
+#   python3 tools/journal_decode.py --csv journal.bin > journal.csv
+
+import argparse
+import struct
+import sys
+import zlib
+
+# Entry Layout -----------------------------------------------------------------------------------------------------------------
+
+# Must match journalEntry_t.
+ENTRY_FORMAT	= "<IIBBBBBB5HfI"
+ENTRY_SIZE		= struct.calcsize (ENTRY_FORMAT)
+CRC_OFFSET		= ENTRY_SIZE - 4
+
+EVENTS = {
+	0: "BOOT",
+	1: "VEHICLE_FAILED",
+	2: "TORQUE_IMPLAUSIBLE",
+	3: "PEDALS_IMPLAUSIBLE",
+	4: "AMK_ERROR"
+}
+
+VEHICLE_STATES = {
+	0: "FAILED",
+	1: "LOW_VOLTAGE",
+	2: "HIGH_VOLTAGE",
+	3: "READY_TO_DRIVE"
+}
+
+FLAGS = ("torquePlausible", "pedalsPlausible", "torqueDerating", "vcuFault")
+
+SAMPLES = ("apps1", "apps2", "bseF", "bseR", "glv")
+
+# Decoding ---------------------------------------------------------------------------------------------------------------------
+
+def decodeEntry (data):
+	if data == b"\xFF" * ENTRY_SIZE:
+		return None
+
+	if zlib.crc32 (data [:CRC_OFFSET]) != struct.unpack_from ("<I", data, CRC_OFFSET) [0]:
+		return None
+
+	fields = struct.unpack (ENTRY_FORMAT, data)
+	sequence, timestamp, event, detail, vehicleState, amksState, flags, pad0 = fields [:8]
+	samples = fields [8:13]
+	torqueRequest = fields [13]
+
+	entry = {
+		"sequence":		sequence,
+		"timestamp":	timestamp,
+		"event":		EVENTS.get (event, f"UNKNOWN_{event}"),
+		"detail":		detail,
+		"vehicleState":	VEHICLE_STATES.get (vehicleState, f"UNKNOWN_{vehicleState}"),
+		"amksState":	amksState,
+		"torqueRequest":	torqueRequest
+	}
+	for bit, name in enumerate (FLAGS):
+		entry [name] = bool (flags & (1 << bit))
+	for name, sample in zip (SAMPLES, samples):
+		entry [name] = sample
+
+	return entry
+
+def decodeFiles (paths):
+	entries = {}
+	corrupt = 0
+
+	for path in paths:
+		with open (path, "rb") as file:
+			data = file.read ()
+
+		for offset in range (0, len (data) - ENTRY_SIZE + 1, ENTRY_SIZE):
+			chunk = data [offset:offset + ENTRY_SIZE]
+			entry = decodeEntry (chunk)
+			if entry is None:
+				if chunk != b"\xFF" * ENTRY_SIZE:
+					corrupt += 1
+				continue
+
+			entries [entry ["sequence"]] = entry
+
+	return [entries [sequence] for sequence in sorted (entries)], corrupt
+
+# Entrypoint -------------------------------------------------------------------------------------------------------------------
+
+def main ():
+	parser = argparse.ArgumentParser (description = "Decodes dumps of the VCU's fault & event journal.")
+	parser.add_argument ("paths", nargs = "+", help = "Binary dumps of the journal window.")
+	parser.add_argument ("--csv", action = "store_true", help = "Print the entries as CSV rather than a table.")
+	args = parser.parse_args ()
+
+	entries, corrupt = decodeFiles (args.paths)
+
+	columns = ["sequence", "timestamp", "event", "detail", "vehicleState", "amksState", *FLAGS, *SAMPLES, "torqueRequest"]
+	if args.csv:
+		print (",".join (columns))
+		for entry in entries:
+			print (",".join (str (entry [column]) for column in columns))
+	else:
+		for entry in entries:
+			flags = " ".join (name for name in FLAGS if entry [name])
+			samples = " ".join (f"{name}={entry [name]}" for name in SAMPLES)
+			print (f"#{entry ['sequence']:<6} {entry ['timestamp'] / 1000.0:>10.3f} s  {entry ['event']:<20} "
+				f"detail=0x{entry ['detail']:02X}  {entry ['vehicleState']:<14} amks={entry ['amksState']}  "
+				f"torque={entry ['torqueRequest']:.1f} Nm  {samples}  [{flags}]")
+
+	print (f"{len (entries)} entries, {corrupt} corrupt.", file = sys.stderr)
+	return 0
+
+if __name__ == "__main__":
+	sys.exit (main ())
\ No newline at end of file
@@ -0,0 +1,231 @@
+// Sample Filter Host Benchmark -----------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.19
+//
+// Description: Runs the firmware's sample filters (src/controls/sample_filter.c) on the host, reporting for each filter type:
+//   - The cost per sample, in host nanoseconds. Host timings are only useful relative to one another; the Cortex-M4 is
+//     roughly 2 orders of magnitude slower, but the ranking of the filters is the same.
+//   - The group delay (in samples), as calculated by the filter upon initialization.
+//   - The noise reduction, that being the ratio of the standard deviation of the output to that of the input, for a constant
+//     sample with added gaussian noise.
+//   - The number of samples taken for the output to settle (within 1%) after a step of the input.
+//   - The largest output deviation caused by a single-sample spike of the input.
+//
+// Usage:
+//   gcc -O2 -I src -o sample_filter_bench tools/sample_filter/sample_filter_bench.c src/controls/sample_filter.c -lm
+//   ./sample_filter_bench [sample count]
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "controls/sample_filter.h"
+
+// C Standard Library
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The sample rate of the filters (the control loop's rate), in Hz.
+#define SAMPLE_RATE 100.0
+
+/// @brief The sample the input is centered on.
+#define SAMPLE_CENTER 2000
+
+/// @brief The standard deviation of the noise added to the input.
+#define NOISE_SIGMA 20.0
+
+/// @brief The size of the step & spike inputs.
+#define STEP_SIZE 1000
+
+/// @brief The number of samples in the step & spike responses.
+#define RESPONSE_LENGTH 200
+
+// Configurations -------------------------------------------------------------------------------------------------------------
+
+typedef struct
+{
+	const char* name;
+	sampleFilterConfig_t config;
+} benchConfig_t;
+
+/**
+ * @brief Calculates the coefficients of a 2nd-order Butterworth low-pass filter (bilinear transform).
+ */
+static sampleFilterConfig_t butterworth (double cutoff)
+{
+	double k = tan (M_PI * cutoff / SAMPLE_RATE);
+	double q = 1.0 / sqrt (2.0);
+	double norm = 1.0 / (1.0 + k / q + k * k);
+
+	sampleFilterConfig_t config = { .type = SAMPLE_FILTER_BIQUAD };
+	config.coefficients [0] = k * k * norm;
+	config.coefficients [1] = 2.0 * config.coefficients [0];
+	config.coefficients [2] = config.coefficients [0];
+	config.coefficients [3] = 2.0 * (k * k - 1.0) * norm;
+	config.coefficients [4] = (1.0 - k / q + k * k) * norm;
+	return config;
+}
+
+/**
+ * @brief Calculates the taps of a boxcar (moving average) FIR filter.
+ */
+static sampleFilterConfig_t boxcar (uint8_t length)
+{
+	sampleFilterConfig_t config = { .type = SAMPLE_FILTER_FIR, .length = length };
+	for (uint8_t index = 0; index < length; ++index)
+		config.taps [index] = 32768 / length;
+	return config;
+}
+
+/**
+ * @brief Calculates the taps of a Hann-windowed FIR filter.
+ */
+static sampleFilterConfig_t hann (uint8_t length)
+{
+	sampleFilterConfig_t config = { .type = SAMPLE_FILTER_FIR, .length = length };
+
+	double weights [SAMPLE_FILTER_TAP_COUNT_MAX];
+	double sum = 0.0;
+	for (uint8_t index = 0; index < length; ++index)
+	{
+		weights [index] = sin (M_PI * (index + 1) / (length + 1));
+		weights [index] *= weights [index];
+		sum += weights [index];
+	}
+
+	for (uint8_t index = 0; index < length; ++index)
+		config.taps [index] = (int16_t) lround (32767.0 * weights [index] / sum);
+
+	return config;
+}
+
+// Measurements ---------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Generates a normally distributed random number (Box-Muller).
+ */
+static double gaussian (void)
+{
+	double u = (rand () + 1.0) / (RAND_MAX + 2.0);
+	double v = (rand () + 1.0) / (RAND_MAX + 2.0);
+	return sqrt (-2.0 * log (u)) * cos (2.0 * M_PI * v);
+}
+
+static double measureCost (const sampleFilterConfig_t* config, const uint16_t* input, size_t count)
+{
+	sampleFilter_t filter;
+	sampleFilterInit (&filter, config);
+
+	volatile uint16_t sink = 0;
+	struct timespec start, end;
+	clock_gettime (CLOCK_MONOTONIC, &start);
+	for (size_t index = 0; index < count; ++index)
+		sink = sampleFilterUpdate (&filter, input [index]);
+	clock_gettime (CLOCK_MONOTONIC, &end);
+	(void) sink;
+
+	return ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) / count;
+}
+
+static double measureNoise (const sampleFilterConfig_t* config, const uint16_t* input, size_t count)
+{
+	sampleFilter_t filter;
+	sampleFilterInit (&filter, config);
+
+	double sum = 0.0;
+	double sumSquares = 0.0;
+	for (size_t index = 0; index < count; ++index)
+	{
+		double output = sampleFilterUpdate (&filter, input [index]);
+		sum += output;
+		sumSquares += output * output;
+	}
+
+	double mean = sum / count;
+	return sqrt (sumSquares / count - mean * mean) / NOISE_SIGMA;
+}
+
+static int measureSettling (const sampleFilterConfig_t* config)
+{
+	sampleFilter_t filter;
+	sampleFilterInit (&filter, config);
+
+	sampleFilterUpdate (&filter, SAMPLE_CENTER);
+
+	int settled = 0;
+	for (int index = 0; index < RESPONSE_LENGTH; ++index)
+	{
+		uint16_t output = sampleFilterUpdate (&filter, SAMPLE_CENTER + STEP_SIZE);
+		if (abs (output - (SAMPLE_CENTER + STEP_SIZE)) > STEP_SIZE / 100)
+			settled = index + 1;
+	}
+
+	return settled;
+}
+
+static int measureSpike (const sampleFilterConfig_t* config)
+{
+	sampleFilter_t filter;
+	sampleFilterInit (&filter, config);
+
+	int deviation = 0;
+	for (int index = 0; index < RESPONSE_LENGTH; ++index)
+	{
+		uint16_t output = sampleFilterUpdate (&filter, index == 10 ? SAMPLE_CENTER + STEP_SIZE : SAMPLE_CENTER);
+		if (abs (output - SAMPLE_CENTER) > deviation)
+			deviation = abs (output - SAMPLE_CENTER);
+	}
+
+	return deviation;
+}
+
+// Entrypoint -----------------------------------------------------------------------------------------------------------------
+
+int main (int argc, char** argv)
+{
+	size_t count = argc > 1 ? strtoul (argv [1], NULL, 0) : 10000000;
+
+	benchConfig_t configs [] =
+	{
+		{ "None",					{ .type = SAMPLE_FILTER_NONE } },
+		{ "Biquad (10 Hz)",			butterworth (10.0) },
+		{ "Biquad (20 Hz)",			butterworth (20.0) },
+		{ "Median (3)",				{ .type = SAMPLE_FILTER_MEDIAN, .length = 3 } },
+		{ "Median (5)",				{ .type = SAMPLE_FILTER_MEDIAN, .length = 5 } },
+		{ "Median (9)",				{ .type = SAMPLE_FILTER_MEDIAN, .length = 9 } },
+		{ "FIR boxcar (4)",			boxcar (4) },
+		{ "FIR Hann (8)",			hann (8) }
+	};
+
+	uint16_t* input = malloc (count * sizeof (uint16_t));
+	if (input == NULL)
+		return 1;
+
+	srand (1);
+	for (size_t index = 0; index < count; ++index)
+		input [index] = (uint16_t) lround (SAMPLE_CENTER + NOISE_SIGMA * gaussian ());
+
+	printf ("%-18s %12s %14s %14s %12s %12s\n", "Filter", "Cost (ns)", "Delay (samp)", "Noise (ratio)", "Settling",
+		"Spike");
+	for (size_t index = 0; index < sizeof (configs) / sizeof (configs [0]); ++index)
+	{
+		const sampleFilterConfig_t* config = &configs [index].config;
+
+		sampleFilter_t filter;
+		if (!sampleFilterInit (&filter, config))
+		{
+			printf ("%-18s invalid configuration\n", configs [index].name);
+			continue;
+		}
+
+		printf ("%-18s %12.2f %14.2f %14.3f %12d %12d\n", configs [index].name, measureCost (config, input, count),
+			filter.groupDelay, measureNoise (config, input, count), measureSettling (config), measureSpike (config));
+	}
+
+	free (input);
+	return 0;
+}
\ No newline at end of file
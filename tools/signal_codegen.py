@@ -0,0 +1,545 @@
+#!/usr/bin/env python3
+
+# VCU CAN Signal Code Generator -----------------------------------------------------------------------------------------------
+#
+# Author: agent
+# Date Created: 2026.10.19
+#
+# Description: Generates all code derived from the VCU's CAN signal specification (src/can/signals.json). This produces:
+#   - The firmware packing functions (src/can/signals.h). These are branch-free, with all scale factors folded into constants.
+#     Each message also gets a send-on-delta check, comparing each signal against its change threshold (the optional 'delta'
+#     key of a signal, in raw counts, 0 meaning any change).
+#   - The host-side unpacking library (tools/vcu_signals/vcu_signals.h & .c).
+#   - The DBC export for loggers and bus analyzers (doc/can/vcu_2025.dbc).
+#   Every output is stamped with a hash of the specification, such that a decoder can verify it matches the firmware. The
+#   firmware reports its hash in the config message's specHash signal. The default firmware build runs the --check mode, so
+#   the firmware cannot be built from stale outputs.
+#
+# Usage:
+#   python3 tools/signal_codegen.py           - Regenerate all outputs.
+#   python3 tools/signal_codegen.py --check   - Exit with an error if any output is out-of-date with the specification.
+
+import argparse
+import fractions
+import hashlib
+import json
+import os
+import sys
+
+# Paths ------------------------------------------------------------------------------------------------------------------------
+
+ROOT = os.path.normpath (os.path.join (os.path.dirname (os.path.abspath (__file__)), ".."))
+
+SPEC_PATH			= os.path.join (ROOT, "src/can/signals.json")
+FIRMWARE_PATH		= os.path.join (ROOT, "src/can/signals.h")
+HOST_HEADER_PATH	= os.path.join (ROOT, "tools/vcu_signals/vcu_signals.h")
+HOST_SOURCE_PATH	= os.path.join (ROOT, "tools/vcu_signals/vcu_signals.c")
+DBC_PATH			= os.path.join (ROOT, "doc/can/vcu_2025.dbc")
+
+GENERATED_NOTICE = "Generated by tools/signal_codegen.py from src/can/signals.json, do not edit by hand."
+
+# Specification ----------------------------------------------------------------------------------------------------------------
+
+class Signal:
+	def __init__ (self, spec):
+		self.name		= spec ["name"]
+		self.start		= int (spec ["start"])
+		self.length		= int (spec ["length"])
+		self.type		= spec ["type"]
+		self.unit		= spec.get ("unit", "")
+		self.values		= spec.get ("values", {})
+		self.scale		= fractions.Fraction (spec ["scale"]) if "scale" in spec else None
+		self.comment	= spec.get ("comment", "")
+		self.delta		= int (spec.get ("delta", 0))
+
+		if self.type not in ("bool", "enum", "unsigned", "signed"):
+			raise ValueError (f"Signal '{self.name}' has unknown type '{self.type}'.")
+		if self.type == "bool" and self.length != 1:
+			raise ValueError (f"Signal '{self.name}' is a bool, but is not 1 bit long.")
+		if self.scale is not None and self.type not in ("unsigned", "signed"):
+			raise ValueError (f"Signal '{self.name}' is scaled, but is not numeric.")
+		if self.length < 1 or self.length > 32:
+			raise ValueError (f"Signal '{self.name}' must be between 1 and 32 bits long.")
+		if self.type == "enum" and (not self.values or any (int (key) < 0 or int (key) > self.mask for key in self.values)):
+			raise ValueError (f"Signal '{self.name}' is an enum, but its values are missing or don't fit in its length.")
+		if self.delta < 0 or self.delta > self.mask:
+			raise ValueError (f"Signal '{self.name}' has a change threshold outside of its raw range.")
+
+	@property
+	def mask (self):
+		return (1 << self.length) - 1
+
+	@property
+	def signed (self):
+		return self.type == "signed"
+
+	def storageBits (self):
+		"""The size of the smallest C integer type that can hold the raw value of this signal."""
+		for bits in (8, 16, 32):
+			if self.length <= bits:
+				return bits
+
+	def storageType (self):
+		"""The smallest C integer type that can hold the raw value of this signal."""
+		return f"{'int' if self.signed else 'uint'}{self.storageBits ()}_t"
+
+	def firmwareType (self):
+		"""The C type of the physical value of this signal, as used by the firmware."""
+		if self.type == "bool":
+			return "bool"
+		if self.scale is not None:
+			return "float"
+		return self.storageType ()
+
+	def rawRange (self):
+		if self.signed:
+			return (-(1 << (self.length - 1)), (1 << (self.length - 1)) - 1)
+		return (0, self.mask)
+
+	def physicalRange (self):
+		scale = self.scale if self.scale is not None else 1
+		low, high = self.rawRange ()
+		return (float (low * scale), float (high * scale))
+
+class Message:
+	def __init__ (self, spec):
+		self.name		= spec ["name"]
+		self.id			= int (spec ["id"], 0)
+		self.dlc		= int (spec ["dlc"])
+		self.comment	= spec.get ("comment", "")
+		self.signals	= [Signal (signal) for signal in spec ["signals"]]
+
+		# Validate the layout: every signal must fit in the frame and no 2 signals may overlap.
+		occupied = 0
+		for signal in self.signals:
+			if signal.start + signal.length > self.dlc * 8:
+				raise ValueError (f"Signal '{self.name}.{signal.name}' exceeds the DLC of the message.")
+			bits = signal.mask << signal.start
+			if occupied & bits:
+				raise ValueError (f"Signal '{self.name}.{signal.name}' overlaps another signal.")
+			occupied |= bits
+
+	@property
+	def pascalName (self):
+		return self.name [0].upper () + self.name [1:]
+
+	@property
+	def macroName (self):
+		result = ""
+		for character in self.name:
+			if character.isupper ():
+				result += "_"
+			result += character.upper ()
+		return result
+
+def loadSpec (path):
+	with open (path, "r") as file:
+		text = file.read ()
+
+	spec = json.loads (text)
+	messages = [Message (message) for message in spec ["messages"]]
+
+	# Validate no IDs are duplicated.
+	ids = [message.id for message in messages]
+	if len (ids) != len (set (ids)):
+		raise ValueError ("Duplicate message IDs in the specification.")
+
+	# Hash the canonical form of the spec, such that formatting changes don't change the hash.
+	canonical = json.dumps (spec, sort_keys = True, separators = (",", ":"))
+	specHash = int (hashlib.sha256 (canonical.encode ()).hexdigest () [:8], 16)
+
+	return spec.get ("node", "VCU"), messages, specHash
+
+# Code Generation Helpers ------------------------------------------------------------------------------------------------------
+
+def cFloat (value):
+	"""Formats a number as a C float literal."""
+	text = repr (float (value))
+	return text + "f"
+
+def cDouble (value):
+	return repr (float (value))
+
+def sectionHeader (title):
+	"""Formats a section header in the style of the repository (padded to 127 characters)."""
+	line = f"// {title} "
+	return line + "-" * (127 - len (line))
+
+def wordTerms (message, wordType):
+	"""Gets the expressions that make up the payload of a message as a single word, given the raw value of each signal in a
+	local variable."""
+	# The raw values are held as uint32_t, so only need casting to a wider word.
+	cast = f"({wordType}) " if wordType != "uint32_t" else ""
+	terms = []
+	for signal in message.signals:
+		if signal.start > 0:
+			terms.append (f"({cast}{signal.name} << {signal.start})")
+		else:
+			terms.append (f"{cast}{signal.name}")
+	return terms
+
+# Firmware Output --------------------------------------------------------------------------------------------------------------
+
+def generateFirmware (messages, specHash):
+	lines = []
+	add = lines.append
+
+	add ("#ifndef SIGNALS_H")
+	add ("#define SIGNALS_H")
+	add ("")
+	add (sectionHeader ("VCU CAN Signals"))
+	add ("//")
+	add (f"// {GENERATED_NOTICE}")
+	add ("//")
+	add ("// Description: Datatypes and packing functions for each message transmitted by the VCU. Packing functions are branch-free,")
+	add ("//   with all scale factors and bit positions folded into constants. Delta functions check whether a newly packed payload")
+	add ("//   differs enough from the previously transmitted one to warrant transmitting it, see @c can/telemetry.h .")
+	add ("")
+	add (sectionHeader ("Includes"))
+	add ("")
+	add ("// C Standard Library")
+	add ("#include <stdbool.h>")
+	add ("#include <stdint.h>")
+	add ("")
+	add (sectionHeader ("Constants"))
+	add ("")
+	add ("/// @brief Hash of the signal specification these functions were generated from.")
+	add (f"#define SIGNALS_SPEC_HASH 0x{specHash:08X}u")
+	add ("")
+	add (sectionHeader ("Helpers"))
+	add ("")
+	add ("/**")
+	add (" * @brief Reads a little-endian payload into a single 64-bit word.")
+	add (" */")
+	add ("static inline uint64_t signalsReadWord (const uint8_t* data, uint8_t dlc)")
+	add ("{")
+	add ("\tuint64_t word = 0;")
+	add ("\tfor (uint8_t index = 0; index < dlc; ++index)")
+	add ("\t\tword |= ((uint64_t) data [index]) << (index * 8);")
+	add ("\treturn word;")
+	add ("}")
+
+	for message in messages:
+		add ("")
+		add (sectionHeader (f"{message.pascalName} (0x{message.id:03X})"))
+		add ("")
+		add (f"#define SIGNALS_{message.macroName}_ID\t0x{message.id:03X}")
+		add (f"#define SIGNALS_{message.macroName}_DLC\t{message.dlc}")
+		add ("")
+		if message.comment:
+			add (f"/// @brief {message.comment}")
+		add ("typedef struct")
+		add ("{")
+		for signal in message.signals:
+			comment = signal.comment if signal.comment else signal.name
+			if signal.unit:
+				comment += f" ({signal.unit})"
+			add (f"\t/// @brief {comment}")
+			add (f"\t{signal.firmwareType ()} {signal.name};")
+		add (f"}} signals{message.pascalName}_t;")
+		add ("")
+		add ("/**")
+		add (f" * @brief Packs the payload of the {message.name} message.")
+		add (" * @param data The payload to write into, must be at least the DLC of the message in length.")
+		add (" * @param message The values to pack.")
+		add (" */")
+		add (f"static inline void signalsPack{message.pascalName} (uint8_t* data, const signals{message.pascalName}_t* message)")
+		add ("{")
+		for signal in message.signals:
+			if signal.scale is not None:
+				inverse = 1 / signal.scale
+				factor = cFloat (inverse.numerator) if inverse.denominator == 1 else \
+					f"({cFloat (inverse.numerator)} / {cFloat (inverse.denominator)})"
+				value = f"({signal.storageType ()}) (message->{signal.name} * {factor})"
+			else:
+				value = f"({signal.storageType ()}) message->{signal.name}"
+			if signal.signed:
+				value = f"(uint{signal.storageType () [3:]}) {value}"
+			# The mask is redundant if the cast already truncates to the signal's length, for a bool (always 0 or 1), or for an
+			# enum (always one of its values, which are checked to fit).
+			if signal.type in ("bool", "enum") or signal.length == signal.storageBits ():
+				add (f"\tuint32_t {signal.name} = (uint32_t) {value};")
+			else:
+				add (f"\tuint32_t {signal.name} = (uint32_t) {value} & 0x{signal.mask:X}u;")
+		add ("")
+		# The payload is assembled as a single word, then stored byte-wise (little-endian). Compilers merge the byte stores
+		# into a single store of the word.
+		wordType = "uint32_t" if message.dlc <= 4 else "uint64_t"
+		terms = wordTerms (message, wordType)
+		expression = " | ".join (terms)
+		if len (expression) > 96:
+			expression = " |\n\t\t".join (terms)
+		add (f"\t{wordType} word = {expression};")
+		add ("")
+		add ("\tdata [0] = (uint8_t) word;")
+		for byteIndex in range (1, message.dlc):
+			add (f"\tdata [{byteIndex}] = (uint8_t) (word >> {byteIndex * 8});")
+		add ("}")
+		add ("")
+		generateFirmwareDelta (message, add)
+
+	add ("")
+	add ("#endif // SIGNALS_H")
+	return "\n".join (lines)
+
+def generateFirmwareDelta (message, add):
+	"""Generates the send-on-delta check of a message. Signals without a change threshold are compared bit-for-bit, the
+	remainder are compared by the absolute difference of their raw values."""
+
+	add ("/**")
+	add (f" * @brief Checks whether any signal of the {message.name} message has changed by more than its threshold.")
+	add (" * @param previous The previously transmitted payload.")
+	add (" * @param current The newly packed payload.")
+	add (" * @return True if the change warrants transmitting the message, false otherwise.")
+	add (" */")
+	add (f"static inline bool signalsDelta{message.pascalName} (const uint8_t* previous, const uint8_t* current)")
+	add ("{")
+	add (f"\tuint64_t previousWord = signalsReadWord (previous, {message.dlc});")
+	add (f"\tuint64_t currentWord = signalsReadWord (current, {message.dlc});")
+	add ("\tif (previousWord == currentWord)")
+	add ("\t\treturn false;")
+
+	exactMask = 0
+	for signal in message.signals:
+		if signal.delta == 0:
+			exactMask |= signal.mask << signal.start
+
+	if exactMask != 0:
+		add ("")
+		add ("\t// Signals without a threshold.")
+		add (f"\tif (((previousWord ^ currentWord) & 0x{exactMask:X}u) != 0)")
+		add ("\t\treturn true;")
+
+	for signal in message.signals:
+		if signal.delta == 0:
+			continue
+
+		add ("")
+		for prefix in ("previous", "current"):
+			value = f"(({prefix}Word >> {signal.start}) & 0x{signal.mask:X}u)"
+			if signal.signed:
+				signBit = 1 << (signal.length - 1)
+				value = f"(int32_t) ({value} ^ 0x{signBit:X}u) - 0x{signBit:X}"
+			else:
+				value = f"(int32_t) {value}"
+			add (f"\tint32_t {prefix}{signal.name [0].upper () + signal.name [1:]} = {value};")
+		name = signal.name [0].upper () + signal.name [1:]
+		add (f"\tif (previous{name} - current{name} > {signal.delta} || current{name} - previous{name} > {signal.delta})")
+		add ("\t\treturn true;")
+
+	add ("")
+	add ("\treturn false;")
+	add ("}")
+
+# Host Output ------------------------------------------------------------------------------------------------------------------
+
+def generateHostHeader (messages, specHash):
+	lines = []
+	add = lines.append
+
+	add ("#ifndef VCU_SIGNALS_H")
+	add ("#define VCU_SIGNALS_H")
+	add ("")
+	add (sectionHeader ("VCU CAN Signal Decoder"))
+	add ("//")
+	add (f"// {GENERATED_NOTICE}")
+	add ("//")
+	add ("// Description: Host-side library for unpacking the messages transmitted by the VCU. Check the hash of the specification")
+	add ("//   against the value reported by the firmware to verify both sides agree on the message layout.")
+	add ("")
+	add (sectionHeader ("Includes"))
+	add ("")
+	add ("// C Standard Library")
+	add ("#include <stdbool.h>")
+	add ("#include <stdint.h>")
+	add ("")
+	add (sectionHeader ("Constants"))
+	add ("")
+	add ("/// @brief Hash of the signal specification this library was generated from.")
+	add (f"#define VCU_SIGNALS_SPEC_HASH 0x{specHash:08X}u")
+
+	for message in messages:
+		add ("")
+		add (sectionHeader (f"{message.pascalName} (0x{message.id:03X})"))
+		add ("")
+		add (f"#define VCU_SIGNALS_{message.macroName}_ID\t0x{message.id:03X}")
+		add (f"#define VCU_SIGNALS_{message.macroName}_DLC\t{message.dlc}")
+		add ("")
+		if message.comment:
+			add (f"/// @brief {message.comment}")
+		add ("typedef struct")
+		add ("{")
+		for signal in message.signals:
+			comment = signal.comment if signal.comment else signal.name
+			if signal.unit:
+				comment += f" ({signal.unit})"
+			cType = "double" if signal.scale is not None else signal.firmwareType ()
+			add (f"\t/// @brief {comment}")
+			add (f"\t{cType} {signal.name};")
+		add (f"}} vcuSignals{message.pascalName}_t;")
+		add ("")
+		add ("/**")
+		add (f" * @brief Unpacks the payload of the {message.name} message.")
+		add (" * @param data The payload to read from.")
+		add (" * @param dlc The length of the payload.")
+		add (" * @param message Written to contain the unpacked values.")
+		add (" * @return True if successful, false if the payload is too short.")
+		add (" */")
+		add (f"bool vcuSignalsUnpack{message.pascalName} (const uint8_t* data, uint8_t dlc, vcuSignals{message.pascalName}_t* message);")
+
+	add ("")
+	add ("#endif // VCU_SIGNALS_H")
+	return "\n".join (lines)
+
+def generateHostSource (messages):
+	lines = []
+	add = lines.append
+
+	add (f"// {GENERATED_NOTICE}")
+	add ("")
+	add ("// Header")
+	add ("#include \"vcu_signals.h\"")
+	add ("")
+	add (sectionHeader ("Functions"))
+	add ("")
+	add ("/**")
+	add (" * @brief Reads a little-endian payload into a single 64-bit word.")
+	add (" */")
+	add ("static uint64_t readWord (const uint8_t* data, uint8_t dlc)")
+	add ("{")
+	add ("\tuint64_t word = 0;")
+	add ("\tfor (uint8_t index = 0; index < dlc && index < 8; ++index)")
+	add ("\t\tword |= ((uint64_t) data [index]) << (index * 8);")
+	add ("\treturn word;")
+	add ("}")
+	add ("")
+	add ("/**")
+	add (" * @brief Sign-extends a raw value of the specified bit length.")
+	add (" */")
+	add ("static int64_t signExtend (uint64_t raw, uint8_t length)")
+	add ("{")
+	add ("\tuint64_t signBit = ((uint64_t) 1) << (length - 1);")
+	add ("\treturn (int64_t) ((raw ^ signBit) - signBit);")
+	add ("}")
+
+	for message in messages:
+		add ("")
+		add (f"bool vcuSignalsUnpack{message.pascalName} (const uint8_t* data, uint8_t dlc, vcuSignals{message.pascalName}_t* message)")
+		add ("{")
+		add (f"\tif (dlc < VCU_SIGNALS_{message.macroName}_DLC)")
+		add ("\t\treturn false;")
+		add ("")
+		add ("\tuint64_t word = readWord (data, dlc);")
+		for signal in message.signals:
+			raw = f"((word >> {signal.start}) & 0x{signal.mask:X}u)"
+			if signal.signed:
+				raw = f"signExtend ({raw}, {signal.length})"
+			if signal.scale is not None:
+				value = f"(double) {raw} * ({cDouble (signal.scale.numerator)} / {cDouble (signal.scale.denominator)})"
+			elif signal.type == "bool":
+				value = f"{raw} != 0"
+			else:
+				value = f"({signal.firmwareType ()}) {raw}"
+			add (f"\tmessage->{signal.name} = {value};")
+		add ("\treturn true;")
+		add ("}")
+
+	return "\n".join (lines)
+
+# DBC Output -------------------------------------------------------------------------------------------------------------------
+
+def dbcNumber (value):
+	"""Formats a number for a DBC file, using the shortest round-trippable representation."""
+	value = float (value)
+	if value == int (value):
+		return str (int (value))
+	return repr (value)
+
+def generateDbc (node, messages, specHash):
+	lines = []
+	add = lines.append
+
+	add ("VERSION \"\"")
+	add ("")
+	add ("NS_ :")
+	add ("\tCM_")
+	add ("\tVAL_")
+	add ("")
+	add ("BS_:")
+	add ("")
+	add (f"BU_: {node}")
+
+	for message in messages:
+		add ("")
+		add (f"BO_ {message.id} {node}_{message.pascalName}: {message.dlc} {node}")
+		for signal in message.signals:
+			scale = signal.scale if signal.scale is not None else 1
+			low, high = signal.physicalRange ()
+			sign = "-" if signal.signed else "+"
+			add (f" SG_ {signal.name} : {signal.start}|{signal.length}@1{sign} ({dbcNumber (scale)},0) "
+				f"[{dbcNumber (low)}|{dbcNumber (high)}] \"{signal.unit}\" Vector__XXX")
+
+	add ("")
+	add (f"CM_ \"{GENERATED_NOTICE} Specification hash: 0x{specHash:08X}\";")
+	for message in messages:
+		if message.comment:
+			add (f"CM_ BO_ {message.id} \"{message.comment}\";")
+		for signal in message.signals:
+			if signal.comment:
+				add (f"CM_ SG_ {message.id} {signal.name} \"{signal.comment}\";")
+
+	add ("")
+	for message in messages:
+		for signal in message.signals:
+			if not signal.values:
+				continue
+			values = " ".join (f"{int (key)} \"{value}\"" for key, value in sorted (signal.values.items (), key = lambda item: int (item [0])))
+			add (f"VAL_ {message.id} {signal.name} {values} ;")
+
+	return "\n".join (lines)
+
+# Entrypoint -------------------------------------------------------------------------------------------------------------------
+
+def main ():
+	parser = argparse.ArgumentParser (description = "Generates the VCU's CAN signal code from its specification.")
+	parser.add_argument ("--check", action = "store_true", help = "Verify the outputs are up-to-date rather than writing them.")
+	args = parser.parse_args ()
+
+	node, messages, specHash = loadSpec (SPEC_PATH)
+
+	outputs = {
+		FIRMWARE_PATH:		generateFirmware (messages, specHash),
+		HOST_HEADER_PATH:	generateHostHeader (messages, specHash),
+		HOST_SOURCE_PATH:	generateHostSource (messages),
+		DBC_PATH:			generateDbc (node, messages, specHash)
+	}
+
+	stale = []
+	for path, content in outputs.items ():
+		existing = None
+		if os.path.exists (path):
+			with open (path, "r") as file:
+				existing = file.read ()
+
+		if existing == content:
+			continue
+
+		if args.check:
+			stale.append (os.path.relpath (path, ROOT))
+			continue
+
+		os.makedirs (os.path.dirname (path), exist_ok = True)
+		with open (path, "w") as file:
+			file.write (content)
+		print (f"Generated {os.path.relpath (path, ROOT)}")
+
+	if stale:
+		print ("The following files are out-of-date with src/can/signals.json, run tools/signal_codegen.py:", file = sys.stderr)
+		for path in stale:
+			print (f"  {path}", file = sys.stderr)
+		return 1
+
+	return 0
+
+if __name__ == "__main__":
+	sys.exit (main ())
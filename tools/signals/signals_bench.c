@@ -0,0 +1,310 @@
+// CAN Signal Packing Host Benchmark ------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.19
+//
+// Description: Compares the generated packers (src/can/signals.h) against the hand-written conversion macros they replaced
+//   (src/can/transmit.c prior to the signal specification). For each message whose layout is shared by both:
+//   - Both packers are run over the same random inputs, and any payload that differs is reported. The program fails if any
+//     do.
+//   - The cost per pack is measured, in host nanoseconds. Each packer is timed over several interleaved runs and the fastest
+//     run is reported, as to reject scheduling noise. Host timings are only useful relative to one another.
+//
+// Usage:
+//   gcc -O2 -I src -o signals_bench tools/signals/signals_bench.c
+//   ./signals_bench [pack count]
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "can/signals.h"
+
+// C Standard Library
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The number of distinct inputs each packer is cycled through.
+#define INPUT_COUNT 4096
+
+/// @brief The number of timed runs of each packer.
+#define RUN_COUNT 5
+
+// Legacy Conversions ---------------------------------------------------------------------------------------------------------
+
+// Copied verbatim from the hand-written src/can/transmit.c.
+
+#define PERCENT_INVERSE_FACTOR		(4095.0f / 100.0f)
+#define PERCENT_TO_WORD(percent)	(uint16_t) ((percent) * PERCENT_INVERSE_FACTOR)
+
+#define ANGLE_INVERSE_FACTOR		(65535.0f / 360.0f)
+#define ANGLE_TO_WORD(angle)		(int16_t) ((angle) * ANGLE_INVERSE_FACTOR)
+
+#define VOLTAGE_INVERSE_FACTOR		(255.0f / 18.0f)
+#define VOLTAGE_TO_WORD(voltage)	(uint8_t) ((voltage) * VOLTAGE_INVERSE_FACTOR)
+
+#define TEMPERATURE_INVERSE_FACTOR	10.0f
+#define TEMPERATURE_TO_WORD(temp)	(uint16_t) ((temp) * TEMPERATURE_INVERSE_FACTOR)
+
+#define STATUS_WORD_0_VEHICLE_STATE(state)					(((uint8_t) (state))		<< 0)
+#define STATUS_WORD_0_TORQUE_PLAUSIBLE(plausible)			(((uint8_t) (plausible))	<< 2)
+#define STATUS_WORD_0_PEDALS_PLAUSIBLE(plausible)			(((uint8_t) (plausible))	<< 3)
+#define STATUS_WORD_0_TORQUE_DERATING(derating)				(((uint8_t) (derating))		<< 4)
+#define STATUS_WORD_0_EEPROM_STATE(state)					(((uint8_t) (state))		<< 5)
+#define STATUS_WORK_0_VCU_FAULT(state)						(((uint8_t) (state))		<< 7)
+
+#define STATUS_WORD_1_APPS_1_STATE(state)					(((uint8_t) (state))		<< 0)
+#define STATUS_WORD_1_APPS_2_STATE(state)					(((uint8_t) (state))		<< 2)
+#define STATUS_WORD_1_BSE_F_STATE(state)					(((uint8_t) (state))		<< 4)
+#define STATUS_WORD_1_BSE_R_STATE(state)					(((uint8_t) (state))		<< 6)
+
+#define STATUS_WORD_2_AMK_RL_VALID(valid)					(((uint8_t) (valid))		<< 0)
+#define STATUS_WORD_2_AMK_RR_VALID(valid)					(((uint8_t) (valid))		<< 1)
+#define STATUS_WORD_2_AMK_FL_VALID(valid)					(((uint8_t) (valid))		<< 2)
+#define STATUS_WORD_2_AMK_FR_VALID(valid)					(((uint8_t) (valid))		<< 3)
+#define STATUS_WORD_2_AMK_FAULT(fault)						(((uint8_t) (fault))		<< 4)
+#define STATUS_WORD_2_SAS_STATUS(status)					(((uint8_t) (status))		<< 6)
+
+// Packers --------------------------------------------------------------------------------------------------------------------
+
+// Each packer is kept out of line, such that neither is hoisted out of, or vectorized across, the timing loop.
+
+typedef void (packer_t) (uint8_t* data, const void* message);
+
+static __attribute__ ((noinline)) void legacyPackStatus (uint8_t* data, const void* object)
+{
+	const signalsStatus_t* message = object;
+	uint8_t data8 [8] =
+	{
+		STATUS_WORD_0_VEHICLE_STATE (message->vehicleState) |
+		STATUS_WORD_0_TORQUE_PLAUSIBLE (message->torquePlausible) |
+		STATUS_WORD_0_PEDALS_PLAUSIBLE (message->pedalsPlausible) |
+		STATUS_WORD_0_TORQUE_DERATING (message->torqueDerating) |
+		STATUS_WORD_0_EEPROM_STATE (message->eepromState) |
+		STATUS_WORK_0_VCU_FAULT (message->vcuFault),
+		STATUS_WORD_1_APPS_1_STATE (message->apps1State) |
+		STATUS_WORD_1_APPS_2_STATE (message->apps2State) |
+		STATUS_WORD_1_BSE_F_STATE (message->bseFState) |
+		STATUS_WORD_1_BSE_R_STATE (message->bseRState),
+		STATUS_WORD_2_AMK_RL_VALID (message->amkRlValid) |
+		STATUS_WORD_2_AMK_RR_VALID (message->amkRrValid) |
+		STATUS_WORD_2_AMK_FL_VALID (message->amkFlValid) |
+		STATUS_WORD_2_AMK_FR_VALID (message->amkFrValid) |
+		STATUS_WORD_2_AMK_FAULT (message->amkFault) |
+		STATUS_WORD_2_SAS_STATUS (message->sasState),
+		VOLTAGE_TO_WORD (message->glvVoltage)
+	};
+	memcpy (data, data8, SIGNALS_STATUS_DLC);
+}
+
+static __attribute__ ((noinline)) void generatedPackStatus (uint8_t* data, const void* message)
+{
+	signalsPackStatus (data, message);
+}
+
+static __attribute__ ((noinline)) void legacyPackSensorInputPercent (uint8_t* data, const void* object)
+{
+	const signalsSensorInputPercent_t* message = object;
+	uint16_t apps1Word	= PERCENT_TO_WORD (message->apps1);
+	uint16_t apps2Word	= PERCENT_TO_WORD (message->apps2);
+	uint16_t bseFWord	= PERCENT_TO_WORD (message->bseF);
+	uint16_t bseRWord	= PERCENT_TO_WORD (message->bseR);
+	int16_t sasWord		= ANGLE_TO_WORD (message->sasAngle);
+
+	uint8_t data8 [8] =
+	{
+		apps1Word & 0xFF,
+		((apps2Word << 4) & 0xF0) | ((apps1Word >> 8) & 0x0F),
+		(apps2Word >> 4) & 0xFF,
+		(bseFWord & 0xFF),
+		((bseRWord << 4) & 0xF0) | ((bseFWord >> 8) & 0x0F),
+		(bseRWord >> 4) & 0xFF,
+		sasWord & 0xFF,
+		(sasWord >> 8) & 0xFF
+	};
+	memcpy (data, data8, SIGNALS_SENSOR_INPUT_PERCENT_DLC);
+}
+
+static __attribute__ ((noinline)) void generatedPackSensorInputPercent (uint8_t* data, const void* message)
+{
+	signalsPackSensorInputPercent (data, message);
+}
+
+static __attribute__ ((noinline)) void legacyPackTemperatures (uint8_t* data, const void* object)
+{
+	const signalsTemperatures_t* message = object;
+	uint16_t data16 [4] =
+	{
+		TEMPERATURE_TO_WORD (message->inverterTemperatureMax),
+		TEMPERATURE_TO_WORD (message->motorTemperatureMax)
+	};
+	memcpy (data, data16, SIGNALS_TEMPERATURES_DLC);
+}
+
+static __attribute__ ((noinline)) void generatedPackTemperatures (uint8_t* data, const void* message)
+{
+	signalsPackTemperatures (data, message);
+}
+
+// Inputs ---------------------------------------------------------------------------------------------------------------------
+
+static float randomRange (float min, float max)
+{
+	return min + (max - min) * (float) rand () / (float) RAND_MAX;
+}
+
+static void randomStatus (void* object)
+{
+	signalsStatus_t* message = object;
+	*message = (signalsStatus_t)
+	{
+		.vehicleState		= rand () % 4,
+		.torquePlausible	= rand () % 2,
+		.pedalsPlausible	= rand () % 2,
+		.torqueDerating		= rand () % 2,
+		.eepromState		= rand () % 3,
+		.vcuFault			= rand () % 2,
+		.apps1State			= rand () % 4,
+		.apps2State			= rand () % 4,
+		.bseFState			= rand () % 4,
+		.bseRState			= rand () % 4,
+		.amkRlValid			= rand () % 2,
+		.amkRrValid			= rand () % 2,
+		.amkFlValid			= rand () % 2,
+		.amkFrValid			= rand () % 2,
+		.amkFault			= rand () % 2,
+		.sasState			= rand () % 4,
+		.glvVoltage			= randomRange (0.0f, 18.0f)
+	};
+}
+
+static void randomSensorInputPercent (void* object)
+{
+	signalsSensorInputPercent_t* message = object;
+	*message = (signalsSensorInputPercent_t)
+	{
+		.apps1		= randomRange (0.0f, 100.0f),
+		.apps2		= randomRange (0.0f, 100.0f),
+		.bseF		= randomRange (0.0f, 100.0f),
+		.bseR		= randomRange (0.0f, 100.0f),
+		.sasAngle	= randomRange (-179.0f, 179.0f)
+	};
+}
+
+static void randomTemperatures (void* object)
+{
+	signalsTemperatures_t* message = object;
+	*message = (signalsTemperatures_t)
+	{
+		.inverterTemperatureMax	= randomRange (0.0f, 150.0f),
+		.motorTemperatureMax	= randomRange (0.0f, 150.0f)
+	};
+}
+
+// Configurations -------------------------------------------------------------------------------------------------------------
+
+typedef struct
+{
+	const char* name;
+	size_t size;
+	uint8_t dlc;
+	void (*generate) (void* message);
+	packer_t* legacy;
+	packer_t* generated;
+} benchMessage_t;
+
+static const benchMessage_t MESSAGES [] =
+{
+	{ "Status",				sizeof (signalsStatus_t),				SIGNALS_STATUS_DLC,
+		randomStatus,				legacyPackStatus,				generatedPackStatus },
+	{ "SensorInputPercent",	sizeof (signalsSensorInputPercent_t),	SIGNALS_SENSOR_INPUT_PERCENT_DLC,
+		randomSensorInputPercent,	legacyPackSensorInputPercent,	generatedPackSensorInputPercent },
+	{ "Temperatures",		sizeof (signalsTemperatures_t),			SIGNALS_TEMPERATURES_DLC,
+		randomTemperatures,			legacyPackTemperatures,			generatedPackTemperatures }
+};
+
+// Measurements ---------------------------------------------------------------------------------------------------------------
+
+static double measureCost (packer_t* packer, const uint8_t* inputs, size_t size, size_t count)
+{
+	uint8_t data [8];
+	volatile uint8_t sink = 0;
+	uint8_t accumulator = 0;
+
+	struct timespec start, end;
+	clock_gettime (CLOCK_MONOTONIC, &start);
+	for (size_t index = 0; index < count; ++index)
+	{
+		packer (data, inputs + (index % INPUT_COUNT) * size);
+		accumulator ^= data [0] ^ data [3];
+	}
+	clock_gettime (CLOCK_MONOTONIC, &end);
+	sink = accumulator;
+	(void) sink;
+
+	return ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) / count;
+}
+
+static size_t countMismatches (const benchMessage_t* message, const uint8_t* inputs)
+{
+	size_t mismatches = 0;
+	for (size_t index = 0; index < INPUT_COUNT; ++index)
+	{
+		uint8_t legacy [8] = { 0 };
+		uint8_t generated [8] = { 0 };
+		message->legacy (legacy, inputs + index * message->size);
+		message->generated (generated, inputs + index * message->size);
+		if (memcmp (legacy, generated, message->dlc) != 0)
+			++mismatches;
+	}
+	return mismatches;
+}
+
+// Entrypoint -----------------------------------------------------------------------------------------------------------------
+
+int main (int argc, char** argv)
+{
+	size_t count = argc > 1 ? strtoul (argv [1], NULL, 0) : 50000000;
+	int result = 0;
+
+	printf ("%-20s %12s %14s %14s %10s\n", "Message", "Mismatches", "Legacy (ns)", "Generated (ns)", "Ratio");
+	for (size_t messageIndex = 0; messageIndex < sizeof (MESSAGES) / sizeof (MESSAGES [0]); ++messageIndex)
+	{
+		const benchMessage_t* message = &MESSAGES [messageIndex];
+
+		uint8_t* inputs = malloc (INPUT_COUNT * message->size);
+		if (inputs == NULL)
+			return 1;
+
+		srand (1);
+		for (size_t index = 0; index < INPUT_COUNT; ++index)
+			message->generate (inputs + index * message->size);
+
+		size_t mismatches = countMismatches (message, inputs);
+		if (mismatches != 0)
+			result = 1;
+
+		double legacyCost = 1e9;
+		double generatedCost = 1e9;
+		for (int run = 0; run < RUN_COUNT; ++run)
+		{
+			double cost = measureCost (message->legacy, inputs, message->size, count);
+			if (cost < legacyCost)
+				legacyCost = cost;
+
+			cost = measureCost (message->generated, inputs, message->size, count);
+			if (cost < generatedCost)
+				generatedCost = cost;
+		}
+
+		printf ("%-20s %12zu %14.3f %14.3f %10.3f\n", message->name, mismatches, legacyCost, generatedCost,
+			generatedCost / legacyCost);
+
+		free (inputs);
+	}
+
+	return result;
+}
\ No newline at end of file
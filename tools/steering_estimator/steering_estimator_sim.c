@@ -0,0 +1,124 @@
+// Steering Estimator Host Simulation -----------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.19
+//
+// Description: Runs the firmware's steering estimator (src/controls/steering_estimator.c) on the host, against a sinusoidal
+//   steering input. Each control cycle (10 ms) the sensor is sampled 5 ms prior to the cycle, as the I2C read completes
+//   before the torque thread runs. The error against the true angle at the end of the compensated latency (that being the
+//   angle the torque request acts upon) is reported for both the raw sample and the estimator's predicted angle. The
+//   first 0.5 s is excluded, allowing the observer to converge.
+//
+// Usage:
+//   gcc -O2 -I tools/host -I src -o steering_estimator_sim tools/steering_estimator/*.c src/controls/steering_estimator.c -lm
+//   ./steering_estimator_sim [alpha] [beta] [latency (s)]
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "controls/steering_estimator.h"
+
+// C Standard Library
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The period of the control loop, in seconds.
+#define CYCLE_PERIOD 0.01
+
+/// @brief The age of each sample at the start of the control cycle, in seconds.
+#define SAMPLE_AGE 0.005
+
+/// @brief The amplitude of the steering input, in radians.
+#define AMPLITUDE 0.3
+
+/// @brief The duration of each run, in seconds.
+#define DURATION 5.0
+
+/// @brief The duration excluded from the statistics, in seconds.
+#define SETTLING_TIME 0.5
+
+// Global Data ----------------------------------------------------------------------------------------------------------------
+
+systime_t hostSystemTime = 0;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Simulates a single sinusoidal input, printing the mean and maximum errors of the raw and predicted angles.
+ * @param frequency The frequency of the input, in Hz.
+ * @param latency The latency being compensated for, in seconds.
+ */
+static void simulate (double frequency, double latency)
+{
+	double errorRawSum = 0.0;
+	double errorRawMax = 0.0;
+	double errorPredictedSum = 0.0;
+	double errorPredictedMax = 0.0;
+	unsigned count = 0;
+
+	for (unsigned cycle = 0; cycle * CYCLE_PERIOD < DURATION; ++cycle)
+	{
+		double time = cycle * CYCLE_PERIOD;
+		double sampleTime = time - SAMPLE_AGE;
+		float angle = AMPLITUDE * sin (2.0 * M_PI * frequency * sampleTime);
+
+		systime_t timeCurrent = (systime_t) (time * CH_CFG_ST_FREQUENCY + 0.5) + CH_CFG_ST_FREQUENCY;
+		systime_t timeSample = timeCurrent - (systime_t) (SAMPLE_AGE * CH_CFG_ST_FREQUENCY + 0.5);
+		steeringEstimatorUpdate (timeSample, timeCurrent, angle, true);
+
+		if (time < SETTLING_TIME)
+			continue;
+
+		double truth = AMPLITUDE * sin (2.0 * M_PI * frequency * (time + latency));
+		double errorRaw = fabs (angle - truth);
+		double errorPredicted = fabs (steeringEstimate.anglePredicted - truth);
+
+		errorRawSum += errorRaw;
+		errorPredictedSum += errorPredicted;
+		if (errorRaw > errorRawMax)
+			errorRawMax = errorRaw;
+		if (errorPredicted > errorPredictedMax)
+			errorPredictedMax = errorPredicted;
+		++count;
+	}
+
+	printf ("%8.2f Hz | %8.4f %8.4f | %8.4f %8.4f\n", frequency, errorRawSum / count, errorRawMax,
+		errorPredictedSum / count, errorPredictedMax);
+}
+
+// Entrypoint -----------------------------------------------------------------------------------------------------------------
+
+int main (int argc, char** argv)
+{
+	steeringEstimatorConfig_t config =
+	{
+		.alpha		= argc > 1 ? strtof (argv [1], NULL) : 0.5f,
+		.beta		= argc > 2 ? strtof (argv [2], NULL) : 0.15f,
+		.latency	= argc > 3 ? strtof (argv [3], NULL) : 0.02f
+	};
+
+	printf ("Alpha %.3f, beta %.3f, latency %.3f s, amplitude %.2f rad.\n", config.alpha, config.beta, config.latency,
+		AMPLITUDE);
+
+	if (!steeringEstimatorReconfigure (&config))
+	{
+		printf ("Invalid configuration.\n");
+		return 1;
+	}
+
+	printf ("            | Raw sample (rad)  | Predicted (rad)\n");
+	printf ("  Frequency |     Mean      Max |     Mean      Max\n");
+
+	const double frequencies [] = { 0.25, 0.5, 1.0, 2.0 };
+	for (size_t index = 0; index < sizeof (frequencies) / sizeof (frequencies [0]); ++index)
+	{
+		// Reset the observer between runs.
+		steeringEstimatorReconfigure (&config);
+		simulate (frequencies [index], config.latency);
+	}
+
+	return 0;
+}
\ No newline at end of file
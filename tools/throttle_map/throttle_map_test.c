@@ -0,0 +1,202 @@
+// Throttle Map Host Test -----------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.19
+//
+// Description: Runs the firmware's throttle map (src/controls/throttle_map.c) on the host, checking that:
+//   - Invalid curves are rejected and fall back to the linear map. In particular, any curve requesting torque with the pedal
+//     released (a non-zero first output, regardless of the first input) is rejected.
+//   - A released pedal (a request of 0 or less, or NaN) never requests torque, for any curve.
+//   - Valid curves are reproduced by the lookup table, within the bound documented in src/controls/throttle_map.h.
+//   Prints each failed check, returning non-zero if any failed.
+//
+// Usage:
+//   gcc -O2 -I src -o throttle_map_test tools/throttle_map/throttle_map_test.c src/controls/throttle_map.c -lm
+//   ./throttle_map_test
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "controls/throttle_map.h"
+
+// C Standard Library
+#include <math.h>
+#include <stdio.h>
+
+// Global Data ----------------------------------------------------------------------------------------------------------------
+
+/// @brief The number of failed checks.
+static unsigned failureCount = 0;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Records the result of a check, printing it if it failed.
+ */
+static void check (bool condition, const char* name, const char* description)
+{
+	if (condition)
+		return;
+
+	printf ("FAIL: %s: %s\n", name, description);
+	++failureCount;
+}
+
+/**
+ * @brief Checks that a map never requests torque with the pedal released.
+ */
+static void checkReleased (const throttleMap_t* map, const char* name)
+{
+	check (throttleMapEvaluate (map, 0.0f) == 0.0f, name, "Request of 0 requests torque.");
+	check (throttleMapEvaluate (map, -0.5f) == 0.0f, name, "Negative request requests torque.");
+	check (throttleMapEvaluate (map, NAN) == 0.0f, name, "NaN request requests torque.");
+}
+
+/**
+ * @brief Checks that a curve is rejected, falling back to the linear map.
+ */
+static void checkRejected (const throttleMapConfig_t* config, const char* name)
+{
+	throttleMap_t map;
+	check (!throttleMapInit (&map, config), name, "Invalid curve accepted.");
+	checkReleased (&map, name);
+
+	bool linear = true;
+	for (float request = 0.0f; request <= 1.0f; request += 1.0f / 128.0f)
+		linear &= fabsf (throttleMapEvaluate (&map, request) - request) < 1e-6f;
+	check (linear, name, "Fallback is not the linear map.");
+}
+
+/**
+ * @brief Checks that a curve is accepted, and that the map reproduces it to within the documented bound.
+ * @param bound The maximum deviation from the curve (the grid's spacing over 4, multiplied by the largest change in slope).
+ */
+static void checkAccepted (const throttleMapConfig_t* config, const char* name, float bound)
+{
+	throttleMap_t map;
+	check (throttleMapInit (&map, config), name, "Valid curve rejected.");
+	checkReleased (&map, name);
+
+	uint8_t last = config->pointCount - 1;
+	for (float request = 1.0f / 1024.0f; request <= 1.0f; request += 1.0f / 1024.0f)
+	{
+		// Expected output, by searching the curve (an empty curve being the linear map).
+		float expected = request;
+		if (config->pointCount != 0 && request <= config->inputs [0])
+			expected = config->outputs [0];
+		else if (config->pointCount != 0)
+		{
+			expected = config->outputs [last];
+			for (uint8_t index = 1; index <= last; ++index)
+			{
+				if (request > config->inputs [index])
+					continue;
+
+				float x0 = config->inputs [index - 1];
+				float y0 = config->outputs [index - 1];
+				expected = y0 + (config->outputs [index] - y0) * (request - x0) / (config->inputs [index] - x0);
+				break;
+			}
+		}
+
+		float actual = throttleMapEvaluate (&map, request);
+		if (fabsf (actual - expected) > bound + 1e-6f)
+		{
+			printf ("FAIL: %s: Request %.4f maps to %.4f, expected %.4f.\n", name, request, actual, expected);
+			++failureCount;
+			return;
+		}
+	}
+}
+
+// Entrypoint -----------------------------------------------------------------------------------------------------------------
+
+int main (void)
+{
+	// Non-zero output at an input of 0.
+	checkRejected (&(throttleMapConfig_t)
+	{
+		.pointCount = 2,
+		.inputs		= { 0.0f, 1.0f },
+		.outputs	= { 0.2f, 1.0f }
+	}, "Offset output");
+
+	// Non-zero output saturated back to an input of 0.
+	checkRejected (&(throttleMapConfig_t)
+	{
+		.pointCount = 3,
+		.inputs		= { 0.1f, 0.5f, 1.0f },
+		.outputs	= { 0.05f, 0.4f, 1.0f }
+	}, "Offset input & output");
+
+	// Decreasing output.
+	checkRejected (&(throttleMapConfig_t)
+	{
+		.pointCount = 3,
+		.inputs		= { 0.0f, 0.5f, 1.0f },
+		.outputs	= { 0.0f, 0.6f, 0.5f }
+	}, "Decreasing output");
+
+	// Repeated input.
+	checkRejected (&(throttleMapConfig_t)
+	{
+		.pointCount = 3,
+		.inputs		= { 0.0f, 0.5f, 0.5f },
+		.outputs	= { 0.0f, 0.5f, 1.0f }
+	}, "Repeated input");
+
+	// Output out of range.
+	checkRejected (&(throttleMapConfig_t)
+	{
+		.pointCount = 2,
+		.inputs		= { 0.0f, 1.0f },
+		.outputs	= { 0.0f, 1.5f }
+	}, "Output out of range");
+
+	// NaN point.
+	checkRejected (&(throttleMapConfig_t)
+	{
+		.pointCount = 2,
+		.inputs		= { 0.0f, NAN },
+		.outputs	= { 0.0f, 1.0f }
+	}, "NaN input");
+
+	// Too few points.
+	checkRejected (&(throttleMapConfig_t)
+	{
+		.pointCount = 1,
+		.inputs		= { 0.0f },
+		.outputs	= { 0.0f }
+	}, "Single point");
+
+	// Linear map, selected explicitly.
+	checkAccepted (&(throttleMapConfig_t)
+	{
+		.pointCount = 0
+	}, "Linear", 0.0f);
+
+	// Progressive map, points on the grid (exact).
+	checkAccepted (&(throttleMapConfig_t)
+	{
+		.pointCount = 3,
+		.inputs		= { 0.0f, 0.5f, 1.0f },
+		.outputs	= { 0.0f, 0.25f, 1.0f }
+	}, "Progressive", 0.0f);
+
+	// Deadband, point off the grid (slope changes by 1.1).
+	checkAccepted (&(throttleMapConfig_t)
+	{
+		.pointCount = 2,
+		.inputs		= { 0.09f, 1.0f },
+		.outputs	= { 0.0f, 1.0f }
+	}, "Deadband", 1.1f / (4.0f * THROTTLE_MAP_LUT_INTERVALS));
+
+	if (failureCount != 0)
+	{
+		printf ("%u check(s) failed.\n", failureCount);
+		return 1;
+	}
+
+	printf ("All checks passed.\n");
+	return 0;
+}
\ No newline at end of file
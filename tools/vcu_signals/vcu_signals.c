@@ -0,0 +1,133 @@
+// Generated by tools/signal_codegen.py from src/can/signals.json, do not edit by hand.
+
+// Header
+#include "vcu_signals.h"
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Reads a little-endian payload into a single 64-bit word.
+ */
+static uint64_t readWord (const uint8_t* data, uint8_t dlc)
+{
+	uint64_t word = 0;
+	for (uint8_t index = 0; index < dlc && index < 8; ++index)
+		word |= ((uint64_t) data [index]) << (index * 8);
+	return word;
+}
+
+/**
+ * @brief Sign-extends a raw value of the specified bit length.
+ */
+static int64_t signExtend (uint64_t raw, uint8_t length)
+{
+	uint64_t signBit = ((uint64_t) 1) << (length - 1);
+	return (int64_t) ((raw ^ signBit) - signBit);
+}
+
+bool vcuSignalsUnpackStatus (const uint8_t* data, uint8_t dlc, vcuSignalsStatus_t* message)
+{
+	if (dlc < VCU_SIGNALS_STATUS_DLC)
+		return false;
+
+	uint64_t word = readWord (data, dlc);
+	message->vehicleState = (uint8_t) ((word >> 0) & 0x3u);
+	message->torquePlausible = ((word >> 2) & 0x1u) != 0;
+	message->pedalsPlausible = ((word >> 3) & 0x1u) != 0;
+	message->torqueDerating = ((word >> 4) & 0x1u) != 0;
+	message->eepromState = (uint8_t) ((word >> 5) & 0x3u);
+	message->vcuFault = ((word >> 7) & 0x1u) != 0;
+	message->apps1State = (uint8_t) ((word >> 8) & 0x3u);
+	message->apps2State = (uint8_t) ((word >> 10) & 0x3u);
+	message->bseFState = (uint8_t) ((word >> 12) & 0x3u);
+	message->bseRState = (uint8_t) ((word >> 14) & 0x3u);
+	message->amkRlValid = ((word >> 16) & 0x1u) != 0;
+	message->amkRrValid = ((word >> 17) & 0x1u) != 0;
+	message->amkFlValid = ((word >> 18) & 0x1u) != 0;
+	message->amkFrValid = ((word >> 19) & 0x1u) != 0;
+	message->amkFault = ((word >> 20) & 0x1u) != 0;
+	message->sasState = (uint8_t) ((word >> 22) & 0x3u);
+	message->glvVoltage = (double) ((word >> 24) & 0xFFu) * (6.0 / 85.0);
+	return true;
+}
+
+bool vcuSignalsUnpackSensorInputPercent (const uint8_t* data, uint8_t dlc, vcuSignalsSensorInputPercent_t* message)
+{
+	if (dlc < VCU_SIGNALS_SENSOR_INPUT_PERCENT_DLC)
+		return false;
+
+	uint64_t word = readWord (data, dlc);
+	message->apps1 = (double) ((word >> 0) & 0xFFFu) * (20.0 / 819.0);
+	message->apps2 = (double) ((word >> 12) & 0xFFFu) * (20.0 / 819.0);
+	message->bseF = (double) ((word >> 24) & 0xFFFu) * (20.0 / 819.0);
+	message->bseR = (double) ((word >> 36) & 0xFFFu) * (20.0 / 819.0);
+	message->sasAngle = (double) signExtend (((word >> 48) & 0xFFFFu), 16) * (24.0 / 4369.0);
+	return true;
+}
+
+bool vcuSignalsUnpackTemperatures (const uint8_t* data, uint8_t dlc, vcuSignalsTemperatures_t* message)
+{
+	if (dlc < VCU_SIGNALS_TEMPERATURES_DLC)
+		return false;
+
+	uint64_t word = readWord (data, dlc);
+	message->inverterTemperatureMax = (double) ((word >> 0) & 0xFFFFu) * (1.0 / 10.0);
+	message->motorTemperatureMax = (double) ((word >> 16) & 0xFFFFu) * (1.0 / 10.0);
+	return true;
+}
+
+bool vcuSignalsUnpackConfig (const uint8_t* data, uint8_t dlc, vcuSignalsConfig_t* message)
+{
+	if (dlc < VCU_SIGNALS_CONFIG_DLC)
+		return false;
+
+	uint64_t word = readWord (data, dlc);
+	message->drivingTorqueLimit = (double) ((word >> 0) & 0xFFu) * (20.0 / 51.0);
+	message->regenTorqueLimit = (double) ((word >> 8) & 0xFFu) * (20.0 / 51.0);
+	message->torqueAlgorithmIndex = (uint8_t) ((word >> 16) & 0xFFu);
+	message->profileIndex = (uint8_t) ((word >> 24) & 0xFu);
+	message->profileRejected = ((word >> 28) & 0x1u) != 0;
+	message->specHash = (uint32_t) ((word >> 32) & 0xFFFFFFFFu);
+	return true;
+}
+
+bool vcuSignalsUnpackBoot (const uint8_t* data, uint8_t dlc, vcuSignalsBoot_t* message)
+{
+	if (dlc < VCU_SIGNALS_BOOT_DLC)
+		return false;
+
+	uint64_t word = readWord (data, dlc);
+	message->peripheralsTime = (uint16_t) ((word >> 0) & 0xFFFFu);
+	message->canTime = (uint16_t) ((word >> 16) & 0xFFFFu);
+	message->readyTime = (uint16_t) ((word >> 32) & 0xFFFFu);
+	return true;
+}
+
+bool vcuSignalsUnpackSensorHealth (const uint8_t* data, uint8_t dlc, vcuSignalsSensorHealth_t* message)
+{
+	if (dlc < VCU_SIGNALS_SENSOR_HEALTH_DLC)
+		return false;
+
+	uint64_t word = readWord (data, dlc);
+	message->channel = (uint8_t) ((word >> 0) & 0x7u);
+	message->mean = (uint16_t) ((word >> 3) & 0xFFFu);
+	message->standardDeviation = (double) ((word >> 15) & 0x3FFu) * (1.0 / 8.0);
+	message->peakToPeak = (uint16_t) ((word >> 25) & 0xFFFu);
+	message->outOfRangeCount = (uint8_t) ((word >> 37) & 0xFFu);
+	message->rateViolationCount = (uint8_t) ((word >> 45) & 0xFFu);
+	message->sampleCount = (uint16_t) ((word >> 53) & 0x7FFu);
+	return true;
+}
+
+bool vcuSignalsUnpackCanStatistics (const uint8_t* data, uint8_t dlc, vcuSignalsCanStatistics_t* message)
+{
+	if (dlc < VCU_SIGNALS_CAN_STATISTICS_DLC)
+		return false;
+
+	uint64_t word = readWord (data, dlc);
+	message->rxLatencyMax = (uint16_t) ((word >> 0) & 0xFFFFu);
+	message->rxLatencyAverage = (uint16_t) ((word >> 16) & 0xFFFFu);
+	message->rxDropCount = (uint16_t) ((word >> 32) & 0xFFFFu);
+	message->bridgeDropCount = (uint16_t) ((word >> 48) & 0xFFFFu);
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,243 @@
+#ifndef VCU_SIGNALS_H
+#define VCU_SIGNALS_H
+
+// VCU CAN Signal Decoder -----------------------------------------------------------------------------------------------------
+//
+// Generated by tools/signal_codegen.py from src/can/signals.json, do not edit by hand.
+//
+// Description: Host-side library for unpacking the messages transmitted by the VCU. Check the hash of the specification
+//   against the value reported by the firmware to verify both sides agree on the message layout.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// C Standard Library
+#include <stdbool.h>
+#include <stdint.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief Hash of the signal specification this library was generated from.
+#define VCU_SIGNALS_SPEC_HASH 0x59AA1CCBu
+
+// Status (0x100) -------------------------------------------------------------------------------------------------------------
+
+#define VCU_SIGNALS_STATUS_ID	0x100
+#define VCU_SIGNALS_STATUS_DLC	4
+
+/// @brief VCU status, vehicle state and sensor validity.
+typedef struct
+{
+	/// @brief The global state of the vehicle.
+	uint8_t vehicleState;
+	/// @brief Indicates the torque thread's request is plausible.
+	bool torquePlausible;
+	/// @brief Indicates the pedals are plausible (including the 100ms timeout).
+	bool pedalsPlausible;
+	/// @brief Indicates the torque request is being derated.
+	bool torqueDerating;
+	/// @brief The state of the on-board EEPROM.
+	uint8_t eepromState;
+	/// @brief Indicates the VCU is faulted.
+	bool vcuFault;
+	/// @brief The state of the APPS-1 sensor.
+	uint8_t apps1State;
+	/// @brief The state of the APPS-2 sensor.
+	uint8_t apps2State;
+	/// @brief The state of the BSE-F sensor.
+	uint8_t bseFState;
+	/// @brief The state of the BSE-R sensor.
+	uint8_t bseRState;
+	/// @brief Indicates the rear-left inverter is valid.
+	bool amkRlValid;
+	/// @brief Indicates the rear-right inverter is valid.
+	bool amkRrValid;
+	/// @brief Indicates the front-left inverter is valid.
+	bool amkFlValid;
+	/// @brief Indicates the front-right inverter is valid.
+	bool amkFrValid;
+	/// @brief Indicates any inverter is in an error or invalid state.
+	bool amkFault;
+	/// @brief The state of the steering-angle sensor.
+	uint8_t sasState;
+	/// @brief The voltage of the GLV battery. (V)
+	double glvVoltage;
+} vcuSignalsStatus_t;
+
+/**
+ * @brief Unpacks the payload of the status message.
+ * @param data The payload to read from.
+ * @param dlc The length of the payload.
+ * @param message Written to contain the unpacked values.
+ * @return True if successful, false if the payload is too short.
+ */
+bool vcuSignalsUnpackStatus (const uint8_t* data, uint8_t dlc, vcuSignalsStatus_t* message);
+
+// SensorInputPercent (0x600) -------------------------------------------------------------------------------------------------
+
+#define VCU_SIGNALS_SENSOR_INPUT_PERCENT_ID	0x600
+#define VCU_SIGNALS_SENSOR_INPUT_PERCENT_DLC	8
+
+/// @brief Pedal sensor requests and steering angle.
+typedef struct
+{
+	/// @brief The request of the APPS-1 sensor. (%)
+	double apps1;
+	/// @brief The request of the APPS-2 sensor. (%)
+	double apps2;
+	/// @brief The request of the BSE-F sensor. (%)
+	double bseF;
+	/// @brief The request of the BSE-R sensor. (%)
+	double bseR;
+	/// @brief The angle of the steering wheel. (deg)
+	double sasAngle;
+} vcuSignalsSensorInputPercent_t;
+
+/**
+ * @brief Unpacks the payload of the sensorInputPercent message.
+ * @param data The payload to read from.
+ * @param dlc The length of the payload.
+ * @param message Written to contain the unpacked values.
+ * @return True if successful, false if the payload is too short.
+ */
+bool vcuSignalsUnpackSensorInputPercent (const uint8_t* data, uint8_t dlc, vcuSignalsSensorInputPercent_t* message);
+
+// Temperatures (0x7A0) -------------------------------------------------------------------------------------------------------
+
+#define VCU_SIGNALS_TEMPERATURES_ID	0x7A0
+#define VCU_SIGNALS_TEMPERATURES_DLC	4
+
+/// @brief Maximum inverter and motor temperatures.
+typedef struct
+{
+	/// @brief The maximum temperature of the 4 inverters. (C)
+	double inverterTemperatureMax;
+	/// @brief The maximum temperature of the 4 motors. (C)
+	double motorTemperatureMax;
+} vcuSignalsTemperatures_t;
+
+/**
+ * @brief Unpacks the payload of the temperatures message.
+ * @param data The payload to read from.
+ * @param dlc The length of the payload.
+ * @param message Written to contain the unpacked values.
+ * @return True if successful, false if the payload is too short.
+ */
+bool vcuSignalsUnpackTemperatures (const uint8_t* data, uint8_t dlc, vcuSignalsTemperatures_t* message);
+
+// Config (0x7A2) -------------------------------------------------------------------------------------------------------------
+
+#define VCU_SIGNALS_CONFIG_ID	0x7A2
+#define VCU_SIGNALS_CONFIG_DLC	8
+
+/// @brief Active vehicle configuration.
+typedef struct
+{
+	/// @brief The cumulative driving torque limit. (Nm)
+	double drivingTorqueLimit;
+	/// @brief The cumulative regenerative torque limit. (Nm)
+	double regenTorqueLimit;
+	/// @brief The index of the selected torque-vectoring algorithm.
+	uint8_t torqueAlgorithmIndex;
+	/// @brief The index of the active configuration profile.
+	uint8_t profileIndex;
+	/// @brief Indicates the most recent profile switch was rejected, as the profile's CRC was invalid.
+	bool profileRejected;
+	/// @brief The hash of the signal specification the firmware was built from (SIGNALS_SPEC_HASH).
+	uint32_t specHash;
+} vcuSignalsConfig_t;
+
+/**
+ * @brief Unpacks the payload of the config message.
+ * @param data The payload to read from.
+ * @param dlc The length of the payload.
+ * @param message Written to contain the unpacked values.
+ * @return True if successful, false if the payload is too short.
+ */
+bool vcuSignalsUnpackConfig (const uint8_t* data, uint8_t dlc, vcuSignalsConfig_t* message);
+
+// Boot (0x7A3) ---------------------------------------------------------------------------------------------------------------
+
+#define VCU_SIGNALS_BOOT_ID	0x7A3
+#define VCU_SIGNALS_BOOT_DLC	6
+
+/// @brief Boot timing, transmitted once upon startup. Times are measured from the start of the kernel.
+typedef struct
+{
+	/// @brief The time at which the peripherals were initialized, including loading the EEPROM map. (ms)
+	uint16_t peripheralsTime;
+	/// @brief The time at which the CAN interface started, and the first telemetry frame was queued. (ms)
+	uint16_t canTime;
+	/// @brief The time at which all threads were started and the shutdown loop was allowed to close. (ms)
+	uint16_t readyTime;
+} vcuSignalsBoot_t;
+
+/**
+ * @brief Unpacks the payload of the boot message.
+ * @param data The payload to read from.
+ * @param dlc The length of the payload.
+ * @param message Written to contain the unpacked values.
+ * @return True if successful, false if the payload is too short.
+ */
+bool vcuSignalsUnpackBoot (const uint8_t* data, uint8_t dlc, vcuSignalsBoot_t* message);
+
+// SensorHealth (0x7A4) -------------------------------------------------------------------------------------------------------
+
+#define VCU_SIGNALS_SENSOR_HEALTH_ID	0x7A4
+#define VCU_SIGNALS_SENSOR_HEALTH_DLC	8
+
+/// @brief Statistics of one sensor's raw samples since the sensor was last reported. Each transmission reports the next sensor in turn. Counts saturate at their maximum.
+typedef struct
+{
+	/// @brief The sensor being reported.
+	uint8_t channel;
+	/// @brief The mean of the in-range samples.
+	uint16_t mean;
+	/// @brief The standard deviation (square root of the variance) of the in-range samples.
+	double standardDeviation;
+	/// @brief The peak-to-peak range of the in-range samples.
+	uint16_t peakToPeak;
+	/// @brief The number of samples outside of the sensor's valid range.
+	uint8_t outOfRangeCount;
+	/// @brief The number of consecutive samples differing by more than the configured rate limit.
+	uint8_t rateViolationCount;
+	/// @brief The number of in-range samples.
+	uint16_t sampleCount;
+} vcuSignalsSensorHealth_t;
+
+/**
+ * @brief Unpacks the payload of the sensorHealth message.
+ * @param data The payload to read from.
+ * @param dlc The length of the payload.
+ * @param message Written to contain the unpacked values.
+ * @return True if successful, false if the payload is too short.
+ */
+bool vcuSignalsUnpackSensorHealth (const uint8_t* data, uint8_t dlc, vcuSignalsSensorHealth_t* message);
+
+// CanStatistics (0x7A5) ------------------------------------------------------------------------------------------------------
+
+#define VCU_SIGNALS_CAN_STATISTICS_ID	0x7A5
+#define VCU_SIGNALS_CAN_STATISTICS_DLC	8
+
+/// @brief Statistics of the CAN receive dispatcher. Values saturate at their maximum.
+typedef struct
+{
+	/// @brief The maximum delay between a frame arriving and it being decoded. (us)
+	uint16_t rxLatencyMax;
+	/// @brief The average delay between a frame arriving and it being decoded. (us)
+	uint16_t rxLatencyAverage;
+	/// @brief The number of received frames dropped due to the dispatcher's queue being full.
+	uint16_t rxDropCount;
+	/// @brief The number of bridged frames dropped due to no transmit mailbox being free.
+	uint16_t bridgeDropCount;
+} vcuSignalsCanStatistics_t;
+
+/**
+ * @brief Unpacks the payload of the canStatistics message.
+ * @param data The payload to read from.
+ * @param dlc The length of the payload.
+ * @param message Written to contain the unpacked values.
+ * @return True if successful, false if the payload is too short.
+ */
+bool vcuSignalsUnpackCanStatistics (const uint8_t* data, uint8_t dlc, vcuSignalsCanStatistics_t* message);
+
+#endif // VCU_SIGNALS_H
\ No newline at end of file